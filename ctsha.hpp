@@ -1,17 +1,102 @@
-/// This is a header-only library allowing compile-time only (consteval) calculation of SHA-1, SHA-224, SHA-256,
-/// SHA-384, SHA-512, SHA-512/224, and SHA-512/256 digests as defined in FIPS 180-4. See
+/// This is a header-only library allowing compile-time (constexpr) calculation of SHA-1, SHA-224, SHA-256, SHA-384,
+/// SHA-512, SHA-512/224, and SHA-512/256 digests as defined in FIPS 180-4. See
 /// https://nvlpubs.nist.gov/nistpubs/FIPS/NIST.FIPS.180-4.pdf. All constants are derived from first principles where
 /// possible, rather than just hardcoding the constants given by the document, so one can see where the magic numbers
-/// come from. While the algorithm appears to give the right answers, I offer no guarantee that there are no bugs. Use
-/// this library at your own risk.
+/// come from. The constants can only be derived at compile time (consteval), but the hash functions themselves may also
+/// be called at runtime. While the algorithm appears to give the right answers, I offer no guarantee that there are no
+/// bugs. Use this library at your own risk.
 
 #pragma once
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <bit>
+#include <concepts>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// The runtime kernels use instruction set extensions that the compiler may not be targeting, which needs GCC's target
+// pragma, so they are only available with GCC on x86-64.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define CTSHA_X86_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+// The usage counters (see ctsha::usage_counters) are kept unless this is defined to 0, in which case they are compiled
+// out entirely.
+#if !defined(CTSHA_COUNTERS)
+#define CTSHA_COUNTERS 1
+#endif
+
+// The USDT probes (see detail::probe_scope) are built in on ELF targets on x86-64 with GCC-style inline assembly.
+// Define this to 0 to leave them out. Each probe is a nop plus a note in the .note.stapsdt section that tells tracers
+// such as bpftrace where the nop is, where to find its arguments, and where its semaphore is. Tracers increment the
+// semaphore while they are attached, and the nop and its arguments are skipped while it is zero, so a probe that is not
+// attached costs a load and a branch.
+#if !defined(CTSHA_PROBES)
+#if defined(__ELF__) && defined(__x86_64__) && defined(__GNUC__)
+#define CTSHA_PROBES 1
+#else
+#define CTSHA_PROBES 0
+#endif
+#endif
+
+#if CTSHA_PROBES
+// A version of STAP_PROBE3 from SystemTap's <sys/sdt.h> for 64-bit arguments, writing version 3 of the note format,
+// that only evaluates its arguments while the probe's semaphore (see ctsha::detail::hash_entry_semaphore and so on) is
+// set. <sys/sdt.h> itself is not used because it only records semaphores if _SDT_HAS_SEMAPHORES was defined wherever
+// it was first included.
+#define CTSHA_PROBE(name, arg1, arg2, arg3)                                                                            \
+    do {                                                                                                               \
+        if (__builtin_expect(::ctsha::detail::name##_semaphore != 0, 0))                                               \
+            __asm__ __volatile__("990: nop\n"                                                                          \
+                                 ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                         \
+                                 ".balign 4\n"                                                                         \
+                                 ".4byte 992f-991f, 994f-993f, 3\n"                                                    \
+                                 "991: .asciz \"stapsdt\"\n"                                                           \
+                                 "992: .balign 4\n"                                                                    \
+                                 "993: .8byte 990b\n"                                                                  \
+                                 ".8byte _.stapsdt.base\n"                                                             \
+                                 ".8byte ctsha_" #name "_semaphore\n"                                                  \
+                                 ".asciz \"ctsha\"\n"                                                                  \
+                                 ".asciz \"" #name "\"\n"                                                              \
+                                 ".asciz \"8@%[a1] 8@%[a2] 8@%[a3]\"\n"                                                \
+                                 "994: .balign 4\n"                                                                    \
+                                 ".popsection\n"                                                                       \
+                                 ".ifndef _.stapsdt.base\n"                                                            \
+                                 ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"               \
+                                 ".weak _.stapsdt.base\n"                                                              \
+                                 ".hidden _.stapsdt.base\n"                                                            \
+                                 "_.stapsdt.base: .space 1\n"                                                          \
+                                 ".size _.stapsdt.base, 1\n"                                                           \
+                                 ".popsection\n"                                                                       \
+                                 ".endif\n"                                                                            \
+                                 :                                                                                     \
+                                 : [a1] "nor"(static_cast<std::uint64_t>(arg1)),                                       \
+                                   [a2] "nor"(static_cast<std::uint64_t>(arg2)),                                       \
+                                   [a3] "nor"(static_cast<std::uint64_t>(arg3)));                                      \
+    } while (false)
+#endif
+
+// Scatter/gather arrays (struct iovec) are POSIX, so contexts only accept them where the header exists.
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#endif
 
 // The standard says std::endian supports "corner case" platforms with no or mixed endianness, but we don't.
 static_assert(!(std::endian::native == std::endian::little && std::endian::native == std::endian::big));
@@ -41,7 +126,7 @@ constexpr std::size_t bits = sizeof(data_t) * bits_per_byte;
 template <std::size_t bits>
 constexpr std::size_t bytes = (bits + (bits_per_byte - 1)) / bits_per_byte;
 
-/// Perform byte-swapping on some unsigned integral type at compile time.
+/// Perform byte-swapping on some unsigned integral type.
 ///
 /// @tparam data_t The data type whose bytes are being swapped.
 ///
@@ -49,7 +134,7 @@ constexpr std::size_t bytes = (bits + (bits_per_byte - 1)) / bits_per_byte;
 ///
 /// @returns A data_t containing the byte-swapped value.
 template <typename data_t> requires std::unsigned_integral<data_t>
-consteval data_t byte_swap(data_t value) {
+constexpr data_t byte_swap(data_t value) {
     data_t swapped{};
     for (std::size_t byte_index = 0; byte_index < sizeof(data_t); ++byte_index) {
         data_t byte_value = (value & (data_t{0xff} << byte_index * bits_per_byte)) >> (byte_index * bits_per_byte);
@@ -58,7 +143,7 @@ consteval data_t byte_swap(data_t value) {
     return swapped;
 }
 
-/// Takes a value in big endian byte order and converts it to host byte order at compile time.
+/// Takes a value in big endian byte order and converts it to host byte order.
 ///
 /// @tparam data_t The data type whose bytes are being swapped.
 ///
@@ -66,7 +151,7 @@ consteval data_t byte_swap(data_t value) {
 ///
 /// @returns A data_t containing the big endian byte order representation of value.
 template <typename data_t>
-consteval data_t big_endian_to_host(data_t value) {
+constexpr data_t big_endian_to_host(data_t value) {
     return std::endian::native == std::endian::little ? byte_swap(value) : value;
 }
 
@@ -80,7 +165,7 @@ consteval data_t big_endian_to_host(data_t value) {
 ///
 /// @returns The converted array.
 template <std::endian endianness, typename data_t, std::size_t num_elements> requires std::unsigned_integral<data_t>
-consteval std::array<std::byte, sizeof(data_t) * num_elements> to_bytes(const std::array<data_t, num_elements>& value) {
+constexpr std::array<std::byte, sizeof(data_t) * num_elements> to_bytes(const std::array<data_t, num_elements>& value) {
     std::array<std::byte, sizeof(data_t) * num_elements> result{};
     for (auto current_byte = result.begin(); const data_t& element : value) {
         for (std::size_t byte_index = 0; byte_index < sizeof(data_t); ++byte_index, ++current_byte) {
@@ -93,6 +178,91 @@ consteval std::array<std::byte, sizeof(data_t) * num_elements> to_bytes(const st
     return result;
 }
 
+/// Converts a fixed-size span of bytes with a specified endianness to an array of integers. This is the inverse of
+/// to_bytes.
+///
+/// @tparam endianness The byte order of the bytes.
+/// @tparam data_t     The type of integers in the resulting array.
+/// @tparam num_bytes  The number of bytes in the span. Must be a multiple of the size of data_t.
+///
+/// @param value The bytes to convert to integers.
+///
+/// @returns The converted array.
+template <std::endian endianness, typename data_t, std::size_t num_bytes>
+    requires (std::unsigned_integral<data_t> && num_bytes != std::dynamic_extent && num_bytes % sizeof(data_t) == 0)
+constexpr std::array<data_t, num_bytes / sizeof(data_t)> from_bytes(std::span<const std::byte, num_bytes> value) {
+    std::array<data_t, num_bytes / sizeof(data_t)> result{};
+    for (auto current_byte = value.begin(); data_t& element : result) {
+        for (std::size_t byte_index = 0; byte_index < sizeof(data_t); ++byte_index, ++current_byte) {
+            std::size_t shift = endianness == std::endian::little ? byte_index * bits_per_byte
+                                                                  : (sizeof(data_t) - byte_index - 1) * bits_per_byte;
+            element |= static_cast<data_t>(*current_byte) << shift;
+        }
+    }
+
+    return result;
+}
+
+/// Converts an array of bytes with a specified endianness to an array of integers. This is the inverse of to_bytes.
+///
+/// @tparam endianness The byte order of the bytes.
+/// @tparam data_t     The type of integers in the resulting array.
+/// @tparam num_bytes  The number of bytes in the array. Must be a multiple of the size of data_t.
+///
+/// @param value The array of bytes to convert to integers.
+///
+/// @returns The converted array.
+template <std::endian endianness, typename data_t, std::size_t num_bytes>
+    requires (std::unsigned_integral<data_t> && num_bytes % sizeof(data_t) == 0)
+constexpr std::array<data_t, num_bytes / sizeof(data_t)> from_bytes(const std::array<std::byte, num_bytes>& value) {
+    return from_bytes<endianness, data_t>(std::span<const std::byte, num_bytes>(value));
+}
+
+/// Transposes a two-dimensional array, so that element [i][j] of the result is element [j][i] of the input.
+///
+/// @tparam data_t   The type of elements in the array.
+/// @tparam num_cols The number of columns in the input, and hence rows in the result.
+/// @tparam num_rows The number of rows in the input, and hence columns in the result.
+///
+/// @param value The array to transpose.
+///
+/// @returns The transposed array.
+template <typename data_t, std::size_t num_cols, std::size_t num_rows>
+constexpr std::array<std::array<data_t, num_rows>, num_cols>
+transpose(const std::array<std::array<data_t, num_cols>, num_rows>& value) {
+    std::array<std::array<data_t, num_rows>, num_cols> result{};
+    for (std::size_t row = 0; row < num_rows; ++row)
+        for (std::size_t col = 0; col < num_cols; ++col)
+            result.at(col).at(row) = value.at(row).at(col);
+    return result;
+}
+
+/// Copies bytes to a destination that will not be read again soon. Where the CPU supports it and the destination is
+/// 16-byte aligned, non-temporal stores are used, so the destination is written straight to memory instead of evicting
+/// useful data from the cache. The stores are weakly ordered, so callers must call stream_fence once they are done.
+///
+/// @param destination Where to copy the bytes. It must have room for all of source.
+/// @param source      The bytes to copy.
+inline void stream_copy(std::byte* destination, std::span<const std::byte> source) {
+    std::size_t copied = 0;
+#if defined(__SSE2__)
+    if (reinterpret_cast<std::uintptr_t>(destination) % sizeof(__m128i) == 0) {
+        for (; source.size() - copied >= sizeof(__m128i); copied += sizeof(__m128i)) {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + copied));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(destination + copied), value);
+        }
+    }
+#endif
+    std::copy(source.begin() + copied, source.end(), destination + copied);
+}
+
+/// Makes the non-temporal stores of stream_copy visible to other threads, as ordinary stores would be.
+inline void stream_fence() {
+#if defined(__SSE2__)
+    _mm_sfence();
+#endif
+}
+
 /// Creates an array where each element is generated using a function that takes its position in the array as a template
 /// argument.
 ///
@@ -175,6 +345,12 @@ consteval std::uint64_t prime(std::uint64_t index, std::uint64_t value = 2) {
     return (index == 0) ? value : prime(index - 1, next_prime(value + 1));
 }
 
+/// Ensures a list of arguments is two or more pieces of a message, each of which can be viewed as a span of bytes, such
+/// as a std::array, std::vector, or std::span of bytes.
+template <typename... parts_t>
+concept message_parts =
+    sizeof...(parts_t) >= 2 && (std::convertible_to<const parts_t&, std::span<const std::byte>> && ...);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Generic SHA Functions                                                                                              //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -198,7 +374,7 @@ using block_t = std::array<word_t, 16>;
 ///
 /// @note We define our own function instead of using std::rotr so we can define additional constraints and checks.
 template <std::size_t num_bits, typename word_t> requires (sha_word<word_t> && num_bits < bits<word_t>)
-consteval word_t rotate_right(word_t x) {
+constexpr word_t rotate_right(word_t x) {
     return (x >> num_bits) | (x << (bits<word_t> - num_bits));
 }
 
@@ -213,7 +389,7 @@ consteval word_t rotate_right(word_t x) {
 ///
 /// @note We define our own function instead of using std::rotl so we can define additional constraints and checks.
 template <std::size_t num_bits, typename word_t> requires (sha_word<word_t> && num_bits < bits<word_t>)
-consteval word_t rotate_left(word_t x) {
+constexpr word_t rotate_left(word_t x) {
     return (x << num_bits) | (x >> (bits<word_t> - num_bits));
 }
 
@@ -252,42 +428,42 @@ constexpr std::uint32_t parity(std::uint32_t x, std::uint32_t y, std::uint32_t z
 }
 
 /// The Σ0 function defined in FIPS 180-4 section 4.1.2 equation 4.4.
-consteval std::uint32_t Σ0(std::uint32_t x) {
+constexpr std::uint32_t Σ0(std::uint32_t x) {
     return rotate_right<2>(x) ^ rotate_right<13>(x) ^ rotate_right<22>(x);
 }
 
 /// The Σ0 function defined in FIPS 180-4 section 4.1.3 equation 4.10.
-consteval std::uint64_t Σ0(std::uint64_t x) {
+constexpr std::uint64_t Σ0(std::uint64_t x) {
     return rotate_right<28>(x) ^ rotate_right<34>(x) ^ rotate_right<39>(x);
 }
 
 /// The Σ1 function defined in FIPS 180-4 section 4.1.2 equation 4.5.
-consteval std::uint32_t Σ1(std::uint32_t x) {
+constexpr std::uint32_t Σ1(std::uint32_t x) {
     return rotate_right<6>(x) ^ rotate_right<11>(x) ^ rotate_right<25>(x);
 }
 
 /// The Σ1 function defined in FIPS 180-4 section 4.1.3 equation 4.11.
-consteval std::uint64_t Σ1(std::uint64_t x) {
+constexpr std::uint64_t Σ1(std::uint64_t x) {
     return rotate_right<14>(x) ^ rotate_right<18>(x) ^ rotate_right<41>(x);
 }
 
 /// The σ0 function defined in FIPS 180-4 section 4.1.2 equation 4.6.
-consteval std::uint32_t σ0(std::uint32_t x) {
+constexpr std::uint32_t σ0(std::uint32_t x) {
     return rotate_right<7>(x) ^ rotate_right<18>(x) ^ (x >> 3);
 }
 
 /// The σ0 function defined in FIPS 180-4 section 4.1.3 equation 4.12.
-consteval std::uint64_t σ0(std::uint64_t x) {
+constexpr std::uint64_t σ0(std::uint64_t x) {
     return rotate_right<1>(x) ^ rotate_right<8>(x) ^ (x >> 7);
 }
 
 /// The σ1 function defined in FIPS 180-4 section 4.1.2 equation 4.7.
-consteval std::uint32_t σ1(std::uint32_t x) {
+constexpr std::uint32_t σ1(std::uint32_t x) {
     return rotate_right<17>(x) ^ rotate_right<19>(x) ^ (x >> 10);
 }
 
 /// The σ1 function defined in FIPS 180-4 section 4.1.3 equation 4.13.
-consteval std::uint64_t σ1(std::uint64_t x) {
+constexpr std::uint64_t σ1(std::uint64_t x) {
     return rotate_right<19>(x) ^ rotate_right<61>(x) ^ (x >> 6);
 }
 
@@ -305,7 +481,7 @@ consteval std::uint64_t σ1(std::uint64_t x) {
 /// @note The SHA algorithms support computing hashes on messages that are not an exact number of bytes, but this
 ///       function requires the message to be an exact number of bytes.
 template <typename word_t, std::size_t original_bytes> requires sha_word<word_t>
-consteval auto preprocess_message(const std::array<std::byte, original_bytes>& original_message) {
+constexpr auto preprocess_message(const std::array<std::byte, original_bytes>& original_message) {
     // The message will have a '1' bit appended, and then a two-word length.
     constexpr std::size_t min_bits = (original_bytes * bits_per_byte) + 1 + (2 * bits<word_t>);
 
@@ -335,6 +511,197 @@ consteval auto preprocess_message(const std::array<std::byte, original_bytes>& o
     return message_blocks;
 }
 
+/// Prepares the SHA-2 message schedule for a block as described by FIPS 180-4 sections 6.2.2 and 6.4.2 step 1.
+///
+/// @tparam num_constants The number of rounds, and hence the number of words in the schedule.
+/// @tparam word_t        The type of word used by the SHA algorithm. This parameter is usually deduced.
+///
+/// @param block The block for which the message schedule is being prepared, in host byte order.
+///
+/// @returns The message schedule.
+template <std::size_t num_constants, typename word_t> requires sha_word<word_t>
+constexpr std::array<word_t, num_constants> sha2_message_schedule(const block_t<word_t>& block) {
+    std::array<word_t, num_constants> w{};
+    for (std::size_t t = 0; t < w.size(); ++t)
+        w.at(t) = (t < 16) ? block.at(t) : σ1(w.at(t - 2)) + w.at(t - 7) + σ0(w.at(t - 15)) + w.at(t - 16);
+    return w;
+}
+
+/// Adds the round constants to a SHA-2 message schedule. The constant and the schedule word for a round are always
+/// added together, so doing it ahead of time lets schedules that never change be computed once at compile time.
+///
+/// @tparam word_t        The type of word used by the SHA algorithm. This parameter is usually deduced.
+/// @tparam num_constants The number of constants in the given array of constants. This parameter is usually deduced.
+///
+/// @param w         The message schedule.
+/// @param constants The set of constants to use when computing the hash.
+///
+/// @returns The message schedule with the constants added.
+template <typename word_t, std::size_t num_constants> requires sha_word<word_t>
+constexpr std::array<word_t, num_constants> sha2_add_constants(std::array<word_t, num_constants>        w,
+                                                               const std::array<word_t, num_constants>& constants) {
+    for (std::size_t t = 0; t < w.size(); ++t)
+        w.at(t) += constants.at(t);
+    return w;
+}
+
+/// Processes one block of a SHA-2 hash as described by FIPS 180-4 sections 6.2.2 and 6.4.2 steps 2 through 4.
+///
+/// @tparam word_t        The type of word used by the SHA algorithm. This parameter is usually deduced.
+/// @tparam num_constants The number of rounds. This parameter is usually deduced.
+///
+/// @param state    The intermediate hash value, which is updated in place.
+/// @param schedule The message schedule for the block with the round constants already added. (See
+///                 sha2_add_constants.)
+template <typename word_t, std::size_t num_constants> requires sha_word<word_t>
+constexpr void sha2_compress(std::array<word_t, 8>& state, const std::array<word_t, num_constants>& schedule) {
+    // Initialize the working variables. (a=0, b=1, c=2, d=3, e=4, f=5, g=6, h=7)
+    auto v = state;
+
+    // Compute new values for the working variables.
+    for (std::size_t t = 0; t < schedule.size(); ++t) {
+        word_t t1 = v.at(7) + Σ1(v.at(4)) + choose(v.at(4), v.at(5), v.at(6)) + schedule.at(t);
+        word_t t2 = Σ0(v.at(0)) + majority(v.at(0), v.at(1), v.at(2));
+        v.at(7) = v.at(6);      // h = g
+        v.at(6) = v.at(5);      // g = f
+        v.at(5) = v.at(4);      // f = e
+        v.at(4) = v.at(3) + t1; // e = d + t1
+        v.at(3) = v.at(2);      // d = c
+        v.at(2) = v.at(1);      // c = b
+        v.at(1) = v.at(0);      // b = a
+        v.at(0) = t1 + t2;      // a = t1 + t2
+    }
+
+    // Compute the intermediate hash value.
+    for (auto si = state.begin(), vi = v.begin(); si != state.end() && vi != v.end(); ++si, ++vi)
+        *si = *vi + *si;
+}
+
+/// Converts the final hash value into a digest, truncating it if needed.
+///
+/// @tparam digest_bits The number of desired bits in the digest.
+/// @tparam word_t      The type of word used by the SHA algorithm. This parameter is usually deduced.
+/// @tparam num_words   The number of words in the hash value. This parameter is usually deduced.
+///
+/// @param state The final hash value.
+///
+/// @returns An array of bytes representing the hash result.
+template <std::size_t digest_bits, typename word_t, std::size_t num_words>
+    requires (sha_word<word_t> && bytes<digest_bits> <= sizeof(word_t) * num_words)
+constexpr std::array<std::byte, bytes<digest_bits>> final_digest(const std::array<word_t, num_words>& state) {
+    // Truncate the digest if needed. If not then just return the full digest.
+    auto full_digest = to_bytes<std::endian::big>(state);
+    if constexpr(bytes<digest_bits> < sizeof(state)) {
+        std::array<std::byte, bytes<digest_bits>> truncated_digest{};
+        std::copy(full_digest.begin(), full_digest.begin() + bytes<digest_bits>, truncated_digest.begin());
+        return truncated_digest;
+    } else {
+        return full_digest;
+    }
+}
+
+/// The number of messages the multi-buffer functions process side by side. Each working variable holds one word for
+/// each lane, and every step of a round is done for all of the lanes together, so the compiler is free to keep the
+/// lanes in vector registers. Eight lanes of 32-bit words fill a 256-bit vector register.
+constexpr std::size_t sha2_lanes = 8;
+
+/// One word for each lane of the multi-buffer functions.
+template <typename word_t> requires sha_word<word_t>
+using lanes_t = std::array<word_t, sha2_lanes>;
+
+/// Creates a lanes_t with the same word in every lane.
+///
+/// @tparam word_t The type of word used by the SHA algorithm. This parameter is usually deduced.
+///
+/// @param word The word to put in every lane.
+///
+/// @returns The word repeated in every lane.
+template <typename word_t> requires sha_word<word_t>
+constexpr lanes_t<word_t> broadcast(word_t word) {
+    lanes_t<word_t> lanes{};
+    lanes.fill(word);
+    return lanes;
+}
+
+/// The multi-buffer version of sha2_message_schedule.
+///
+/// @tparam num_constants The number of rounds, and hence the number of words in the schedule.
+/// @tparam word_t        The type of word used by the SHA algorithm. This parameter is usually deduced.
+///
+/// @param block The block for each lane, in host byte order.
+///
+/// @returns The message schedule for each lane.
+template <std::size_t num_constants, typename word_t> requires sha_word<word_t>
+constexpr std::array<lanes_t<word_t>, num_constants>
+sha2_message_schedule_lanes(const std::array<lanes_t<word_t>, 16>& block) {
+    std::array<lanes_t<word_t>, num_constants> w{};
+    std::copy(block.begin(), block.end(), w.begin());
+    for (std::size_t t = block.size(); t < w.size(); ++t)
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane)
+            w.at(t).at(lane) = σ1(w.at(t - 2).at(lane)) + w.at(t - 7).at(lane) + σ0(w.at(t - 15).at(lane)) +
+                               w.at(t - 16).at(lane);
+    return w;
+}
+
+/// The multi-buffer version of sha2_add_constants.
+///
+/// @tparam word_t        The type of word used by the SHA algorithm. This parameter is usually deduced.
+/// @tparam num_constants The number of constants in the given array of constants. This parameter is usually deduced.
+///
+/// @param w         The message schedule for each lane.
+/// @param constants The set of constants to use when computing the hash.
+///
+/// @returns The message schedule for each lane with the constants added.
+template <typename word_t, std::size_t num_constants> requires sha_word<word_t>
+constexpr std::array<lanes_t<word_t>, num_constants>
+sha2_add_constants_lanes(std::array<lanes_t<word_t>, num_constants> w,
+                         const std::array<word_t, num_constants>&   constants) {
+    for (std::size_t t = 0; t < w.size(); ++t)
+        for (word_t& word : w.at(t))
+            word += constants.at(t);
+    return w;
+}
+
+/// The multi-buffer version of sha2_compress. Processes one block for each lane.
+///
+/// @tparam word_t        The type of word used by the SHA algorithm. This parameter is usually deduced.
+/// @tparam num_constants The number of rounds. This parameter is usually deduced.
+///
+/// @param state    The intermediate hash value for each lane, which is updated in place.
+/// @param schedule The message schedule for each lane with the round constants already added.
+template <typename word_t, std::size_t num_constants> requires sha_word<word_t>
+constexpr void sha2_compress_lanes(std::array<lanes_t<word_t>, 8>&                  state,
+                                   const std::array<lanes_t<word_t>, num_constants>& schedule) {
+    // Initialize the working variables. (a=0, b=1, c=2, d=3, e=4, f=5, g=6, h=7)
+    auto v = state;
+
+    // Compute new values for the working variables.
+    for (std::size_t t = 0; t < schedule.size(); ++t) {
+        lanes_t<word_t> t1{};
+        lanes_t<word_t> t2{};
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane) {
+            t1.at(lane) = v.at(7).at(lane) + Σ1(v.at(4).at(lane)) +
+                          choose(v.at(4).at(lane), v.at(5).at(lane), v.at(6).at(lane)) + schedule.at(t).at(lane);
+            t2.at(lane) = Σ0(v.at(0).at(lane)) + majority(v.at(0).at(lane), v.at(1).at(lane), v.at(2).at(lane));
+        }
+        v.at(7) = v.at(6); // h = g
+        v.at(6) = v.at(5); // g = f
+        v.at(5) = v.at(4); // f = e
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane)
+            v.at(4).at(lane) = v.at(3).at(lane) + t1.at(lane); // e = d + t1
+        v.at(3) = v.at(2); // d = c
+        v.at(2) = v.at(1); // c = b
+        v.at(1) = v.at(0); // b = a
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane)
+            v.at(0).at(lane) = t1.at(lane) + t2.at(lane);      // a = t1 + t2
+    }
+
+    // Compute the intermediate hash value.
+    for (std::size_t i = 0; i < state.size(); ++i)
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane)
+            state.at(i).at(lane) += v.at(i).at(lane);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constants                                                                                                          //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -443,234 +810,1926 @@ constexpr auto sha512_initialization_vector = generate_array<8>([]<std::size_t i
         return sha2_constant(prime(index), 2);
 });
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Top-Level Hash Functions                                                                                           //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// The SHA-256 block for a 32-byte message with the message words left as zero. The last eight words are the padding: a
+/// '1' bit, zeros, and the message length of 256 bits.
+constexpr block_t<std::uint32_t> sha256_32_byte_padding_block = []() consteval {
+    block_t<std::uint32_t> block{};
+    block.at(8)  = std::uint32_t{1} << (bits<std::uint32_t> - 1);
+    block.at(15) = 32 * bits_per_byte;
+    return block;
+}();
 
-/// Computes the SHA-1 hash of a given message.
-///
-/// @tparam num_bytes The length of the message.
+/// The SHA-256 padding block that follows a 64-byte message: a '1' bit, zeros, and the message length of 512 bits.
+constexpr block_t<std::uint32_t> sha256_64_byte_padding_block = []() consteval {
+    block_t<std::uint32_t> block{};
+    block.at(0)  = std::uint32_t{1} << (bits<std::uint32_t> - 1);
+    block.at(15) = 64 * bits_per_byte;
+    return block;
+}();
+
+/// The message schedule of sha256_64_byte_padding_block with the round constants already added. The block never
+/// changes, so neither does its schedule.
+constexpr std::array<std::uint32_t, 64> sha256_64_byte_padding_schedule =
+    sha2_add_constants(sha2_message_schedule<64>(sha256_64_byte_padding_block), sha2_32_bit_constants);
+
+/// The multi-buffer version of sha256_64_byte_padding_schedule, with the schedule repeated in every lane.
+constexpr std::array<lanes_t<std::uint32_t>, 64> sha256_64_byte_padding_schedule_lanes = []() consteval {
+    std::array<lanes_t<std::uint32_t>, 64> schedule{};
+    std::transform(sha256_64_byte_padding_schedule.begin(), sha256_64_byte_padding_schedule.end(), schedule.begin(),
+                   broadcast<std::uint32_t>);
+    return schedule;
+}();
+
+/// Gets the round constants of the SHA-2 algorithms that use a particular word size.
 ///
-/// @param message The message for which the SHA-1 hash is being computed.
+/// @tparam word_t The type of words used by the algorithm.
 ///
-/// @returns An array of bytes representing the SHA-1 hash result.
-template <std::size_t num_bytes>
-consteval std::array<std::byte, bytes<160>> sha1(const std::array<std::byte, num_bytes>& message) {
-    auto state = sha1_initialization_vector;
+/// @returns The round constants.
+template <typename word_t>
+constexpr const auto& sha2_constants() {
+    if constexpr (std::is_same_v<word_t, std::uint32_t>)
+        return sha2_32_bit_constants;
+    else
+        return sha2_64_bit_constants;
+}
 
-    for (const auto& block : preprocess_message<std::uint32_t>(message)) {
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Runtime Kernels                                                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-        // Prepare the message schedule.
-        std::array<std::uint32_t, 80> w{};
-        for (std::size_t t = 0; t < w.size(); ++t)
-            w.at(t) = (t < 16) ? big_endian_to_host(block.at(t))
-                               : rotate_left<1>(w.at(t - 3) ^ w.at(t - 8) ^ w.at(t - 14) ^ w.at(t - 16));
-
-        // Initialize the working variables. (a=0, b=1, c=2, d=3, e=4)
-        auto v = state;
-
-        // Compute new values for the working variables.
-        for (std::size_t t = 0; t < w.size(); ++t) {
-            std::uint32_t upper_t = rotate_left<5>(v.at(0)) + sha1_functions.at(t)(v.at(1), v.at(2), v.at(3)) +
-                                    v.at(4) + sha1_constants.at(t) + w.at(t);
-            v.at(4) = v.at(3);                  // e = d
-            v.at(3) = v.at(2);                  // d = c
-            v.at(2) = rotate_left<30>(v.at(1)); // c = ROTL30(b)
-            v.at(1) = v.at(0);                  // b = a
-            v.at(0) = upper_t;                  // a = T
-        }
+// The functions above work both at compile time and at runtime, but at runtime they can only use the instructions of
+// the CPU the compiler targets. The kernels below are only used at runtime. They use instruction set extensions that
+// are detected when the program runs, so a program built for any x86-64 CPU still uses them where it can. They are
+// checked against the functions above by ctsha_runtime_tests.cpp.
 
-        // Compute the intermediate hash value.
-        for (auto si = state.begin(), vi = v.begin(); si != state.end() && vi != v.end(); ++si, ++vi)
-            *si = *vi + *si;
-    }
+/// The instruction set extensions used by the runtime kernels.
+struct cpu_features_t {
+    /// The SHA extensions (SHA-NI), along with SSE4.1, which the SHA-NI kernels also use.
+    bool sha = false;
 
-    return to_bytes<std::endian::big>(state);
+    /// AVX2, including support from the operating system for saving the 256-bit registers.
+    bool avx2 = false;
+
+    /// BMI2, whose rorx instruction rotates without overwriting its source.
+    bool bmi2 = false;
+
+    /// The foundation and vector length extensions of AVX-512, including support from the operating system for saving
+    /// the 512-bit registers and mask registers.
+    bool avx512 = false;
+};
+
+/// Detects the instruction set extensions of the CPU the first time it is called.
+///
+/// @returns The extensions that the CPU supports.
+inline const cpu_features_t& cpu_features() {
+    static const cpu_features_t features = []() {
+        cpu_features_t result;
+#if defined(CTSHA_X86_KERNELS)
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        bool sse41 = false, ymm = false, zmm = false;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) {
+            sse41 = (ecx & bit_SSE4_1) != 0;
+            if ((ecx & bit_OSXSAVE) != 0) {
+                // The operating system saves the 256-bit registers if it enables both the SSE and AVX state in XCR0.
+                unsigned int xcr0 = 0, xcr0_high = 0;
+                __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_high) : "c"(0));
+                ymm = (xcr0 & 0b110) == 0b110;
+                zmm = (xcr0 & 0b11100110) == 0b11100110;
+            }
+        }
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) != 0) {
+            result.sha = sse41 && (ebx & bit_SHA) != 0;
+            result.avx2 = ymm && (ebx & bit_AVX2) != 0;
+            result.bmi2 = (ebx & bit_BMI2) != 0;
+            result.avx512 = zmm && (ebx & bit_AVX512F) != 0 && (ebx & bit_AVX512VL) != 0;
+        }
+#endif
+        return result;
+    }();
+    return features;
 }
 
-/// Computes the SHA-2 hash of a given message. This function performs the work for SHA-224, SHA-256, SHA-384, and
-/// SHA-512.
+#if defined(CTSHA_X86_KERNELS)
+#pragma GCC push_options
+#pragma GCC target("sha,sse4.1")
+
+/// The kernels that use the SHA extensions.
+namespace shani {
+
+/// Calls a function with each index from 0 to count - 1, as a std::integral_constant. The calls are unrolled, so arrays
+/// of vectors indexed by them stay in registers.
 ///
-/// @tparam digest_bits   The number of desired bits in the digest.
-/// @tparam word_t        The type of words used by the specific SHA-2 algorithm. This parameter is usually deduced.
-/// @tparam num_constants The number of constants in the given array of constants. This parameter is usually deduced.
-/// @tparam num_bytes     The number of bytes in the original message for which the SHA-2 hash is being computed. This
-///                       parameter is usually deduced.
+/// @note Each group of kernels has its own copy of this, because GCC only inlines a function into one that targets at
+///       least the same extensions.
 ///
-/// @param message               The message for which the SHA-2 hash is being calculated.
-/// @param initialization_vector The initialization vector to use when computing the hash.
-/// @param constants             The set of constants to use when computing the hash.
+/// @tparam count  The number of indices.
+/// @tparam func_t The type of the function. This parameter is usually deduced.
 ///
-/// @returns An array of bytes representing the SHA-2 hash result.
-template <std::size_t digest_bits, typename word_t, std::size_t num_constants, std::size_t num_bytes>
-    requires sha_word<word_t>
-consteval std::array<std::byte, bytes<digest_bits>> sha2(const std::array<std::byte, num_bytes>&  message,
-                                                         const std::array<word_t, 8>&             initialization_vector,
-                                                         const std::array<word_t, num_constants>& constants) {
-    auto state = initialization_vector;
+/// @param func The function.
+template <std::size_t count, typename func_t>
+inline void unroll(func_t func) {
+    [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+        (func(std::integral_constant<std::size_t, indices>{}), ...);
+    }(std::make_index_sequence<count>{});
+}
 
-    for (const auto& block : preprocess_message<word_t>(message)) {
+/// Processes blocks of one or two independent SHA-256 messages at once with the SHA extensions. Each sha256rnds2
+/// instruction needs the result of the one before it, so the rounds of a single message leave the SHA unit idle for
+/// most of the instruction's latency. Interleaving the rounds of two messages fills those gaps. Three or more messages
+/// need more than the 16 vector registers available, and the spills make them slower than two at a time.
+///
+/// @tparam ways The number of messages.
+///
+/// @param states     The intermediate hash value of each message, which is updated in place.
+/// @param blocks     The blocks of each message, in big endian byte order.
+/// @param num_blocks The number of blocks to process for each message.
+template <std::size_t ways> requires (ways == 1 || ways == 2)
+inline void sha256_compress(std::span<std::array<std::uint32_t, 8>* const, ways> states,
+                            std::span<const std::byte* const, ways>              blocks,
+                            std::size_t                                          num_blocks) {
+    // The SHA extensions keep the working variables in two registers, ordered ABEF and CDGH. There are not enough
+    // registers to also keep a copy of the state from the start of each block, so the state is stored after each block
+    // and added back from memory.
+    __m128i abef[ways];
+    __m128i cdgh[ways];
+    auto load_state = [&](auto way, __m128i& to_abef, __m128i& to_cdgh) {
+        const auto* words = reinterpret_cast<const __m128i*>(states[way]->data());
+        __m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128(words), 0xb1);
+        __m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128(words + 1), 0x1b);
+        to_abef = _mm_alignr_epi8(cdab, efgh, 8);
+        to_cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+    };
+    unroll<ways>([&](auto way) { load_state(way, abef[way], cdgh[way]); });
+
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0b, 0x0405060700010203);
+    const auto* constants = reinterpret_cast<const __m128i*>(sha2_32_bit_constants.data());
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        // Each message keeps the last 16 words of its schedule in four registers of four words each.
+        __m128i w[ways][4];
+        unroll<ways>([&](auto way) {
+            const auto* words = reinterpret_cast<const __m128i*>(blocks[way] + block * sizeof(block_t<std::uint32_t>));
+            unroll<4>([&](auto i) { w[way][i] = _mm_shuffle_epi8(_mm_loadu_si128(words + i), byte_swap); });
+        });
+
+        // Do four rounds of each message at a time, computing the next four words of the schedule as the current ones
+        // are used up.
+        unroll<16>([&](auto quad) {
+            constexpr std::size_t t = decltype(quad)::value % 4;
+            unroll<ways>([&](auto way) {
+                __m128i wk = _mm_add_epi32(w[way][t], _mm_loadu_si128(constants + quad));
+                cdgh[way] = _mm_sha256rnds2_epu32(cdgh[way], abef[way], wk);
+                abef[way] = _mm_sha256rnds2_epu32(abef[way], cdgh[way], _mm_shuffle_epi32(wk, 0x0e));
+                if constexpr (decltype(quad)::value < 12) {
+                    __m128i w9 = _mm_alignr_epi8(w[way][(t + 3) % 4], w[way][(t + 2) % 4], 4);
+                    __m128i partial = _mm_add_epi32(_mm_sha256msg1_epu32(w[way][t], w[way][(t + 1) % 4]), w9);
+                    w[way][t] = _mm_sha256msg2_epu32(partial, w[way][(t + 3) % 4]);
+                }
+            });
+        });
+
+        unroll<ways>([&](auto way) {
+            __m128i saved_abef, saved_cdgh;
+            load_state(way, saved_abef, saved_cdgh);
+            abef[way] = _mm_add_epi32(abef[way], saved_abef);
+            cdgh[way] = _mm_add_epi32(cdgh[way], saved_cdgh);
+            auto* words = reinterpret_cast<__m128i*>(states[way]->data());
+            __m128i feba = _mm_shuffle_epi32(abef[way], 0x1b);
+            __m128i dchg = _mm_shuffle_epi32(cdgh[way], 0xb1);
+            _mm_storeu_si128(words, _mm_blend_epi16(feba, dchg, 0xf0));
+            _mm_storeu_si128(words + 1, _mm_alignr_epi8(dchg, feba, 8));
+        });
+    }
+}
 
-        // Prepare the message schedule.
-        std::array<word_t, num_constants> w{};
-        for (std::size_t t = 0; t < w.size(); ++t)
-            w.at(t) = (t < 16) ? big_endian_to_host(block.at(t))
-                               : σ1(w.at(t - 2)) + w.at(t - 7) + σ0(w.at(t - 15)) + w.at(t - 16);
-
-        // Initialize the working variables. (a=0, b=1, c=2, d=3, e=4, f=5, g=6, h=7)
-        decltype(state) v = state;
-
-        // Compute new values for the working variables.
-        for (std::size_t t = 0; t < w.size(); ++t) {
-            word_t t1 = v.at(7) + Σ1(v.at(4)) + choose(v.at(4), v.at(5), v.at(6)) + constants.at(t) + w.at(t);
-            word_t t2 = Σ0(v.at(0)) + majority(v.at(0), v.at(1), v.at(2));
-            v.at(7) = v.at(6);      // h = g
-            v.at(6) = v.at(5);      // g = f
-            v.at(5) = v.at(4);      // f = e
-            v.at(4) = v.at(3) + t1; // e = d + t1
-            v.at(3) = v.at(2);      // d = c
-            v.at(2) = v.at(1);      // c = b
-            v.at(1) = v.at(0);      // b = a
-            v.at(0) = t1 + t2;      // a = t1 + t2
-        }
+/// Processes whole blocks of a single SHA-256 message with the SHA extensions.
+///
+/// @param state  The intermediate hash value, which is updated in place.
+/// @param blocks The blocks, in big endian byte order. The size must be a multiple of the block size.
+inline void sha256_compress_blocks(std::array<std::uint32_t, 8>& state, std::span<const std::byte> blocks) {
+    std::array<std::array<std::uint32_t, 8>*, 1> states{&state};
+    std::array<const std::byte*, 1> block_pointers{blocks.data()};
+    sha256_compress<1>(states, block_pointers, blocks.size() / sizeof(block_t<std::uint32_t>));
+}
 
-        // Compute the intermediate hash value.
-        for (auto si = state.begin(), vi = v.begin(); si != state.end() && vi != v.end(); ++si, ++vi)
-            *si = *vi + *si;
-    }
+} // End namespace shani.
 
-    // Truncate the digest if needed. If not then just return the full digest.
-    auto full_digest = to_bytes<std::endian::big>(state);
-    if constexpr(bytes<digest_bits> < sizeof(state)) {
-        std::array<std::byte, bytes<digest_bits>> truncated_digest{};
-        std::copy(full_digest.begin(), full_digest.begin() + bytes<digest_bits>, truncated_digest.begin());
-        return truncated_digest;
-    } else {
-        return full_digest;
-    }
+#pragma GCC pop_options
+#endif
+
+#if defined(CTSHA_X86_KERNELS)
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi2")
+
+/// The kernels that use AVX2 and BMI2. These are for single SHA-2 messages on CPUs without the SHA extensions, and for
+/// the algorithms with 64-bit words, which the SHA extensions do not cover.
+namespace avx2 {
+
+/// Calls a function with each index from 0 to count - 1, as a std::integral_constant. See shani::unroll.
+///
+/// @tparam count  The number of indices.
+/// @tparam func_t The type of the function. This parameter is usually deduced.
+///
+/// @param func The function.
+template <std::size_t count, typename func_t>
+inline void unroll(func_t func) {
+    [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+        (func(std::integral_constant<std::size_t, indices>{}), ...);
+    }(std::make_index_sequence<count>{});
 }
 
-/// Computes the initialization vector for the SHA-512/t hashes. (FIPS 180-4 section 5.3.6.)
+/// Adds each pair of words in two vectors.
 ///
-/// @tparam hash_bits The number of bits in the truncated SHA-512/t hash.
+/// @tparam word_t The type of words in the vectors.
+template <typename word_t>
+inline __m256i add(__m256i x, __m256i y) {
+    if constexpr (std::is_same_v<word_t, std::uint32_t>)
+        return _mm256_add_epi32(x, y);
+    else
+        return _mm256_add_epi64(x, y);
+}
+
+/// Shifts each word in a vector right.
 ///
-/// @note This is separate from the other initialization vectors to avoid needing to declare a prototype for sha2.
-template <std::size_t hash_bits> requires (hash_bits != 0 && hash_bits != 384)
-constexpr std::array<std::uint64_t, 8> sha512_t_initialization_vector = []() consteval {
-    using b = std::byte;
+/// @tparam word_t   The type of words in the vector.
+/// @tparam num_bits The number of bits to shift.
+template <typename word_t, int num_bits>
+inline __m256i shift_right(__m256i x) {
+    if constexpr (std::is_same_v<word_t, std::uint32_t>)
+        return _mm256_srli_epi32(x, num_bits);
+    else
+        return _mm256_srli_epi64(x, num_bits);
+}
 
-    /// The SHA-512/t initialization vectors rely on an intermediate initialization vector which is the SHA-512
-    /// initialization vector with every byte xored with 0xa5. See FIPS 180-4 section 5.3.6.
-    constexpr std::array<std::uint64_t, 8> intermediate_iv = []() consteval {
-        auto iv = sha512_initialization_vector;
-        std::for_each(iv.begin(), iv.end(), [](auto& entry) { entry ^= 0xa5a5a5a5a5a5a5a5; });
-        return iv;
-    }();
+/// Rotates each word in a vector right. AVX2 has no rotate instructions, so this is two shifts and an or.
+///
+/// @tparam word_t   The type of words in the vector.
+/// @tparam num_bits The number of bits to rotate.
+template <typename word_t, int num_bits>
+inline __m256i rotate_right(__m256i x) {
+    if constexpr (std::is_same_v<word_t, std::uint32_t>)
+        return _mm256_or_si256(_mm256_srli_epi32(x, num_bits), _mm256_slli_epi32(x, 32 - num_bits));
+    else
+        return _mm256_or_si256(_mm256_srli_epi64(x, num_bits), _mm256_slli_epi64(x, 64 - num_bits));
+}
 
-    // Compute the SHA-512 hash of the string "SHA-512/t" where "t" is the ASCII string representation of hash_bits. The
-    // output of that will be used as the initialization vector.
-    auto hash_message = [&intermediate_iv]<std::size_t num_digits>(const std::array<b, num_digits>& t) consteval {
-        std::array<b, 8> prefix { b{'S'}, b{'H'}, b{'A'}, b{'-'}, b{'5'}, b{'1'}, b{'2'}, b{'/'} };
-        std::array<b, 8 + num_digits> message;
-        std::copy(prefix.begin(), prefix.end(), message.begin());
-        std::copy(t.begin(), t.end(), message.begin() + prefix.size());
-        return detail::sha2<512>(message, intermediate_iv, sha2_64_bit_constants);
-    };
+/// The σ0 function (FIPS 180-4 equations 4.6 and 4.12) of each word in a vector.
+///
+/// @tparam word_t The type of words in the vector.
+template <typename word_t>
+inline __m256i σ0(__m256i x) {
+    if constexpr (std::is_same_v<word_t, std::uint32_t>)
+        return _mm256_xor_si256(_mm256_xor_si256(rotate_right<word_t, 7>(x), rotate_right<word_t, 18>(x)),
+                                shift_right<word_t, 3>(x));
+    else
+        return _mm256_xor_si256(_mm256_xor_si256(rotate_right<word_t, 1>(x), rotate_right<word_t, 8>(x)),
+                                shift_right<word_t, 7>(x));
+}
 
-    // Compute the hash. We need a branch for each number of digits that t can be.
-    std::array<std::byte, bytes<512>> hash_result{};
-    if constexpr (hash_bits < 10) {
-        hash_result = hash_message(std::array{b{hash_bits + '0'}});
-    } else if constexpr (hash_bits < 100) {
-        hash_result = hash_message(std::array{b{hash_bits / 10 + '0' }, b{hash_bits % 10 + '0'}});
-    } else {
-        hash_result =
-            hash_message(std::array{b{hash_bits / 100 + '0'}, b{hash_bits % 100 / 10 + '0' }, b{hash_bits % 10 + '0'}});
-    }
+/// The σ1 function (FIPS 180-4 equations 4.7 and 4.13) of each word in a vector.
+///
+/// @tparam word_t The type of words in the vector.
+template <typename word_t>
+inline __m256i σ1(__m256i x) {
+    if constexpr (std::is_same_v<word_t, std::uint32_t>)
+        return _mm256_xor_si256(_mm256_xor_si256(rotate_right<word_t, 17>(x), rotate_right<word_t, 19>(x)),
+                                shift_right<word_t, 10>(x));
+    else
+        return _mm256_xor_si256(_mm256_xor_si256(rotate_right<word_t, 19>(x), rotate_right<word_t, 61>(x)),
+                                shift_right<word_t, 6>(x));
+}
 
-    // Convert the hash result (an array of bytes) into an initialization vector (array of host byte order uint64_ts).
-    std::array<std::uint64_t, 8> iv{};
-    for (std::size_t iv_index = 0; iv_index < iv.size(); ++iv_index) {
-        std::uint64_t iv_value{};
-        for (std::size_t byte_index = 0; byte_index < bits_per_byte; ++ byte_index) {
-            auto index = iv_index * sizeof(std::uint64_t) + byte_index;
-            auto shift = byte_index * bits_per_byte;
-            iv_value |= static_cast<std::uint64_t>(hash_result.at(index)) << shift;
+/// Computes the message schedules of two blocks at once, with the round constants added. (FIPS 180-4 sections 6.2.2
+/// and 6.4.2 step 1.) The first block is in the low half of each vector and the second block in the high half, and
+/// every vector instruction used works on the two halves separately.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param first  The first block, in big endian byte order.
+/// @param second The second block, in big endian byte order.
+/// @param wk     Receives the schedule plus the constants of each block.
+template <typename word_t>
+inline void sha2_message_schedule(const std::byte* first, const std::byte* second,
+                                  word_t (&wk)[2][sha2_constants<word_t>().size()]) {
+    // Each half of a vector holds 16 bytes of a block, so the 16 words of the schedule that are needed to compute the
+    // next ones fill num_vectors vectors.
+    constexpr std::size_t lane_words = 16 / sizeof(word_t);
+    constexpr std::size_t num_vectors = 16 / lane_words;
+    constexpr std::size_t num_groups = sha2_constants<word_t>().size() / lane_words;
+    const auto* constants = reinterpret_cast<const __m128i*>(sha2_constants<word_t>().data());
+    const __m256i byte_swap = std::is_same_v<word_t, std::uint32_t>
+                                  ? _mm256_set_epi64x(0x0c0d0e0f08090a0b, 0x0405060700010203,
+                                                      0x0c0d0e0f08090a0b, 0x0405060700010203)
+                                  : _mm256_set_epi64x(0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                                      0x08090a0b0c0d0e0f, 0x0001020304050607);
+
+    __m256i w[num_vectors];
+    unroll<num_vectors>([&](auto i) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first) + i);
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second) + i);
+        w[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), byte_swap);
+    });
+
+    unroll<num_groups>([&](auto group) {
+        constexpr std::size_t i = decltype(group)::value % num_vectors;
+        if constexpr (decltype(group)::value >= num_vectors) {
+            // w[i] holds words t - 16 onwards, where t is the first word being computed. Each vector instruction
+            // works on the two halves separately, so the byte alignments shift words within each block.
+            if constexpr (std::is_same_v<word_t, std::uint32_t>) {
+                __m256i w15 = _mm256_alignr_epi8(w[(i + 1) % 4], w[i], 4);
+                __m256i w7 = _mm256_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4);
+                __m256i partial = add<word_t>(add<word_t>(w[i], w7), σ0<word_t>(w15));
+
+                // Words t and t + 1 need words t - 2 and t - 1, which are known, but words t + 2 and t + 3 need words
+                // t and t + 1, so they are computed second.
+                __m256i low = add<word_t>(partial, σ1<word_t>(_mm256_shuffle_epi32(w[(i + 3) % 4], 0xfe)));
+                __m256i high = add<word_t>(partial, σ1<word_t>(_mm256_shuffle_epi32(low, 0x40)));
+                w[i] = _mm256_blend_epi32(low, high, 0xcc);
+            } else {
+                __m256i w15 = _mm256_alignr_epi8(w[(i + 1) % 8], w[i], 8);
+                __m256i w7 = _mm256_alignr_epi8(w[(i + 5) % 8], w[(i + 4) % 8], 8);
+                w[i] = add<word_t>(add<word_t>(add<word_t>(w[i], w7), σ0<word_t>(w15)),
+                                   σ1<word_t>(w[(i + 7) % 8]));
+            }
         }
+        __m256i sum = add<word_t>(w[i], _mm256_broadcastsi128_si256(_mm_loadu_si128(constants + group)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk[0] + group * lane_words), _mm256_castsi256_si128(sum));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk[1] + group * lane_words), _mm256_extracti128_si256(sum, 1));
+    });
+}
 
-        iv.at(iv_index) = big_endian_to_host(iv_value);
+/// Does the rounds of one block of a SHA-2 message with scalar instructions. (FIPS 180-4 sections 6.2.2 and 6.4.2
+/// steps 2 to 4.) With BMI2 the rotations in Σ0 and Σ1 compile to rorx, which does not overwrite its source or touch
+/// the flags, so the three rotations of each word can run side by side.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param state The intermediate hash value, which is updated in place.
+/// @param wk    The message schedule of the block plus the round constants.
+template <typename word_t>
+inline void sha2_rounds(std::array<word_t, 8>& state, const word_t (&wk)[sha2_constants<word_t>().size()]) {
+    // Rather than moving every working variable along one place each round, the names move along the array.
+    word_t v[8];
+    std::copy(state.begin(), state.end(), v);
+    unroll<sha2_constants<word_t>().size()>([&](auto t) {
+        constexpr std::size_t a = (8 - decltype(t)::value % 8) % 8;
+        word_t& b = v[(a + 1) % 8];
+        word_t& c = v[(a + 2) % 8];
+        word_t& d = v[(a + 3) % 8];
+        word_t& e = v[(a + 4) % 8];
+        word_t& f = v[(a + 5) % 8];
+        word_t& g = v[(a + 6) % 8];
+        word_t& h = v[(a + 7) % 8];
+        word_t t1 = h + Σ1(e) + (((f ^ g) & e) ^ g) + wk[t];
+        d += t1;
+        h = t1 + Σ0(v[a]) + (((v[a] | c) & b) | (v[a] & c));
+    });
+    for (std::size_t i = 0; i < 8; ++i)
+        state[i] += v[i];
+}
+
+/// Processes whole blocks of a SHA-2 message. The message schedules of each pair of blocks are computed together with
+/// AVX2, and then the rounds of each block are done with scalar instructions. The schedule of the next pair does not
+/// depend on the rounds, so the CPU overlaps the two.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param state  The intermediate hash value, which is updated in place.
+/// @param blocks The blocks, in big endian byte order. The size must be a multiple of the block size.
+template <typename word_t>
+inline void sha2_compress_blocks(std::array<word_t, 8>& state, std::span<const std::byte> blocks) {
+    constexpr std::size_t block_bytes = sizeof(block_t<word_t>);
+    alignas(32) word_t wk[2][sha2_constants<word_t>().size()];
+    for (; !blocks.empty(); blocks = blocks.subspan(std::min(blocks.size(), 2 * block_bytes))) {
+        // An odd block out is paired with itself.
+        bool pair = blocks.size() >= 2 * block_bytes;
+        sha2_message_schedule<word_t>(blocks.data(), blocks.data() + (pair ? block_bytes : 0), wk);
+        sha2_rounds<word_t>(state, wk[0]);
+        if (pair)
+            sha2_rounds<word_t>(state, wk[1]);
     }
-    return iv;
-}();
+}
 
-} // End namespace detail.
+} // End namespace avx2.
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Public Interface                                                                                                   //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma GCC pop_options
+#endif
 
-/// Computes the SHA-1 hash of a byte array.
-///
-/// @tparam num_bytes The number of bytes in the message for which the SHA-1 hash is being computed.
+#if defined(CTSHA_X86_KERNELS)
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512vl,avx2,bmi2")
+
+/// The kernels that use AVX-512, for the SHA-2 algorithms with 64-bit words.
+namespace avx512 {
+
+/// Calls a function with each index from 0 to count - 1, as a std::integral_constant. See shani::unroll.
 ///
-/// @param message The message for which the SHA-1 hash is being computed.
+/// @tparam count  The number of indices.
+/// @tparam func_t The type of the function. This parameter is usually deduced.
 ///
-/// @returns An array of bytes representing the SHA-1 result.
-template <std::size_t num_bytes>
-consteval std::array<std::byte, detail::bytes<160>> sha1(const std::array<std::byte, num_bytes>& message) {
-    return detail::sha1(message);
+/// @param func The function.
+template <std::size_t count, typename func_t>
+inline void unroll(func_t func) {
+    [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+        (func(std::integral_constant<std::size_t, indices>{}), ...);
+    }(std::make_index_sequence<count>{});
 }
 
-/// Computes the SHA-224 hash of a byte array.
-///
-/// @tparam num_bytes The number of bytes in the message for which the SHA-224 hash is being computed.
-///
-/// @param message The message for which the SHA-224 hash is being computed.
-///
-/// @returns An array of bytes representing the SHA-224 result.
-template <std::size_t num_bytes>
-consteval std::array<std::byte, detail::bytes<224>> sha224(const std::array<std::byte, num_bytes>& message) {
-    return detail::sha2<224>(message, detail::sha224_initialization_vector, detail::sha2_32_bit_constants);
+/// The σ0 function (FIPS 180-4 equation 4.12) of each word in a vector. The rotations are single vprolq instructions,
+/// and the three terms are combined by a single vpternlogq, where 0x96 is the truth table of a three-way exclusive or.
+inline __m256i σ0(__m256i x) {
+    return _mm256_ternarylogic_epi64(_mm256_ror_epi64(x, 1), _mm256_ror_epi64(x, 8), _mm256_srli_epi64(x, 7), 0x96);
 }
 
-/// Computes the SHA-256 hash of a byte array.
-///
-/// @tparam num_bytes The number of bytes in the message for which the SHA-256 hash is being computed.
-///
-/// @param message The message for which the SHA-256 hash is being computed.
-///
-/// @returns An array of bytes representing the SHA-256 result.
-template <std::size_t num_bytes>
-consteval std::array<std::byte, detail::bytes<256>> sha256(const std::array<std::byte, num_bytes>& message) {
-    return detail::sha2<256>(message, detail::sha256_initialization_vector, detail::sha2_32_bit_constants);
+/// The σ1 function (FIPS 180-4 equation 4.13) of each word in a vector. See σ0.
+inline __m256i σ1(__m256i x) {
+    return _mm256_ternarylogic_epi64(_mm256_ror_epi64(x, 19), _mm256_ror_epi64(x, 61), _mm256_srli_epi64(x, 6), 0x96);
 }
 
-/// Computes the SHA-384 hash of a byte array.
-///
-/// @tparam num_bytes The number of bytes in the message for which the SHA-384 hash is being computed.
-///
-/// @param message The message for which the SHA-384 hash is being computed.
-///
-/// @returns An array of bytes representing the SHA-384 result.
-template <std::size_t num_bytes>
-consteval std::array<std::byte, detail::bytes<384>> sha384(const std::array<std::byte, num_bytes>& message) {
-    return detail::sha2<384>(message, detail::sha384_initialization_vector, detail::sha2_64_bit_constants);
+/// Computes the message schedules of two blocks at once, with the round constants added. This is the same as
+/// avx2::sha2_message_schedule, but each σ0 and σ1 takes four instructions instead of nine.
+///
+/// @param first  The first block, in big endian byte order.
+/// @param second The second block, in big endian byte order.
+/// @param wk     Receives the schedule plus the constants of each block.
+inline void sha512_message_schedule(const std::byte* first, const std::byte* second,
+                                    std::uint64_t (&wk)[2][sha2_64_bit_constants.size()]) {
+    const auto* constants = reinterpret_cast<const __m128i*>(sha2_64_bit_constants.data());
+    const __m256i byte_swap = _mm256_set_epi64x(0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                                0x08090a0b0c0d0e0f, 0x0001020304050607);
+
+    __m256i w[8];
+    unroll<8>([&](auto i) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first) + i);
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second) + i);
+        w[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), byte_swap);
+    });
+
+    unroll<sha2_64_bit_constants.size() / 2>([&](auto group) {
+        constexpr std::size_t i = decltype(group)::value % 8;
+        if constexpr (decltype(group)::value >= 8) {
+            __m256i w15 = _mm256_alignr_epi8(w[(i + 1) % 8], w[i], 8);
+            __m256i w7 = _mm256_alignr_epi8(w[(i + 5) % 8], w[(i + 4) % 8], 8);
+            w[i] = _mm256_add_epi64(_mm256_add_epi64(w[i], w7), _mm256_add_epi64(σ0(w15), σ1(w[(i + 7) % 8])));
+        }
+        __m256i sum = _mm256_add_epi64(w[i], _mm256_broadcastsi128_si256(_mm_loadu_si128(constants + group)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk[0] + group * 2), _mm256_castsi256_si128(sum));
+        _mm_store_si128(reinterpret_cast<__m128i*>(wk[1] + group * 2), _mm256_extracti128_si256(sum, 1));
+    });
 }
 
-/// Computes the SHA-512 hash of a byte array.
-///
-/// @tparam num_bytes The number of bytes in the message for which the SHA-512 hash is being computed.
-///
-/// @param message The message for which the SHA-512 hash is being computed.
-///
-/// @returns An array of bytes representing the SHA-512 result.
-template <std::size_t num_bytes>
-consteval std::array<std::byte, detail::bytes<512>> sha512(const std::array<std::byte, num_bytes>& message) {
-    return detail::sha2<512>(message, detail::sha512_initialization_vector, detail::sha2_64_bit_constants);
+/// The Σ0 function (FIPS 180-4 equation 4.10) of the low word of a vector. See σ0.
+inline __m128i Σ0(__m128i x) {
+    return _mm_ternarylogic_epi64(_mm_ror_epi64(x, 28), _mm_ror_epi64(x, 34), _mm_ror_epi64(x, 39), 0x96);
 }
 
-/// Computes the SHA-512/t hash of a byte array. (FIPS 180-4 section 5.3.6.)
-///
+/// The Σ1 function (FIPS 180-4 equation 4.11) of the low word of a vector. See σ0.
+inline __m128i Σ1(__m128i x) {
+    return _mm_ternarylogic_epi64(_mm_ror_epi64(x, 14), _mm_ror_epi64(x, 18), _mm_ror_epi64(x, 41), 0x96);
+}
+
+/// Does the rounds of one block of a message of one of the SHA-2 algorithms with 64-bit words. (FIPS 180-4 section
+/// 6.4.2 steps 2 to 4.) The rounds of a single message each need the result of the one before, so rather than doing
+/// several words at once, each working variable is kept in the low word of its own vector register. Then Σ0 and Σ1
+/// take four instructions instead of five, and Ch and Maj (FIPS 180-4 equations 4.8 and 4.9) are a single vpternlogq
+/// each, with the truth tables 0xca and 0xe8, instead of three or four instructions.
+///
+/// @param state The intermediate hash value, which is updated in place.
+/// @param wk    The message schedule of the block plus the round constants.
+inline void sha512_rounds(std::array<std::uint64_t, 8>& state,
+                          const std::uint64_t (&wk)[sha2_64_bit_constants.size()]) {
+    // As in avx2::sha2_rounds, the names move along the array rather than the working variables. They are back where
+    // they started after every eight rounds, so only eight rounds need to be unrolled for them to stay in registers.
+    __m128i v[8];
+    unroll<8>([&](auto i) { v[i] = _mm_cvtsi64_si128(static_cast<long long>(state[i])); });
+    for (std::size_t group = 0; group < sha2_64_bit_constants.size(); group += 8) unroll<8>([&](auto round) {
+        constexpr std::size_t a = (8 - decltype(round)::value) % 8;
+        std::size_t t = group + round;
+        __m128i& b = v[(a + 1) % 8];
+        __m128i& c = v[(a + 2) % 8];
+        __m128i& d = v[(a + 3) % 8];
+        __m128i& e = v[(a + 4) % 8];
+        __m128i& f = v[(a + 5) % 8];
+        __m128i& g = v[(a + 6) % 8];
+        __m128i& h = v[(a + 7) % 8];
+        __m128i k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(wk + t));
+        __m128i t1 = _mm_add_epi64(_mm_add_epi64(h, Σ1(e)), _mm_add_epi64(_mm_ternarylogic_epi64(e, f, g, 0xca), k));
+        d = _mm_add_epi64(d, t1);
+        h = _mm_add_epi64(t1, _mm_add_epi64(Σ0(v[a]), _mm_ternarylogic_epi64(v[a], b, c, 0xe8)));
+    });
+    unroll<8>([&](auto i) { state[i] += static_cast<std::uint64_t>(_mm_cvtsi128_si64(v[i])); });
+}
+
+/// Processes whole blocks of a message of one of the SHA-2 algorithms with 64-bit words. The message schedules of each
+/// pair of blocks are computed together with AVX-512, and the rounds are done by sha512_rounds.
+///
+/// @param state  The intermediate hash value, which is updated in place.
+/// @param blocks The blocks, in big endian byte order. The size must be a multiple of the block size.
+inline void sha512_compress_blocks(std::array<std::uint64_t, 8>& state, std::span<const std::byte> blocks) {
+    constexpr std::size_t block_bytes = sizeof(block_t<std::uint64_t>);
+    alignas(32) std::uint64_t wk[2][sha2_64_bit_constants.size()];
+    for (; !blocks.empty(); blocks = blocks.subspan(std::min(blocks.size(), 2 * block_bytes))) {
+        // An odd block out is paired with itself.
+        bool pair = blocks.size() >= 2 * block_bytes;
+        sha512_message_schedule(blocks.data(), blocks.data() + (pair ? block_bytes : 0), wk);
+        sha512_rounds(state, wk[0]);
+        if (pair)
+            sha512_rounds(state, wk[1]);
+    }
+}
+
+} // End namespace avx512.
+
+#pragma GCC pop_options
+#endif
+
+/// The groups of runtime kernels, named after the instruction set extensions they use. Each algorithm uses the kernel
+/// from the best backend that has one for it and that the CPU supports, unless a backend is forced with the
+/// CTSHA_BACKEND environment variable or ctsha::set_backend.
+enum class backend {
+    /// The constexpr functions, which work on any CPU.
+    portable,
+
+    /// The AVX2 and BMI2 kernels for all of the SHA-2 algorithms. (See avx2::sha2_compress_blocks.)
+    avx2,
+
+    /// The AVX-512 kernel for the SHA-2 algorithms with 64-bit words. (See avx512::sha512_compress_blocks.)
+    avx512,
+
+    /// The SHA extensions kernels for SHA-224 and SHA-256. (See shani::sha256_compress.)
+    sha_ni,
+};
+
+/// The name of each backend, in the same order as the backend enumeration. These are the values CTSHA_BACKEND takes.
+inline constexpr std::array<std::string_view, 4> backend_names{"portable", "avx2", "avx512", "sha_ni"};
+
+/// @param kernels A backend.
+///
+/// @returns Whether the CPU supports the backend.
+inline bool backend_supported(backend kernels) {
+    switch (kernels) {
+    case backend::avx2:
+        return cpu_features().avx2 && cpu_features().bmi2;
+    case backend::avx512:
+        return cpu_features().avx512 && cpu_features().bmi2;
+    case backend::sha_ni:
+        return cpu_features().sha;
+    default:
+        return true;
+    }
+}
+
+/// The portable kernels, which are the constexpr functions.
+namespace portable {
+
+/// Processes whole blocks of a SHA-2 message.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param state  The intermediate hash value, which is updated in place.
+/// @param blocks The blocks, in big endian byte order. The size must be a multiple of the block size.
+template <typename word_t> requires sha_word<word_t>
+inline void sha2_compress_blocks(std::array<word_t, 8>& state, std::span<const std::byte> blocks) {
+    constexpr std::size_t block_bytes = sizeof(block_t<word_t>);
+    constexpr const auto& constants = sha2_constants<word_t>();
+    for (; !blocks.empty(); blocks = blocks.subspan(block_bytes)) {
+        auto block = from_bytes<std::endian::big, word_t>(blocks.template first<block_bytes>());
+        sha2_compress(state, sha2_add_constants(sha2_message_schedule<constants.size()>(block), constants));
+    }
+}
+
+} // End namespace portable.
+
+/// The best kernel can depend on how many blocks it is given at once, so calls to the kernels are sorted into size
+/// classes: one block, 2 to 15 blocks, and 16 or more blocks.
+inline constexpr std::size_t num_size_classes = 3;
+
+/// @param num_blocks The number of blocks given to a kernel.
+///
+/// @returns The size class of the call.
+constexpr std::size_t size_class(std::size_t num_blocks) {
+    return num_blocks < 2 ? 0 : (num_blocks < 16 ? 1 : 2);
+}
+
+/// A kernel that processes whole blocks of a SHA-2 message, and the backend it comes from.
+///
+/// @tparam word_t The type of words used by the algorithm.
+template <typename word_t> requires sha_word<word_t>
+struct kernel_t {
+    /// The backend.
+    backend source = backend::portable;
+
+    /// The kernel.
+    void (*compress_blocks)(std::array<word_t, 8>&, std::span<const std::byte>) =
+        portable::sha2_compress_blocks<word_t>;
+};
+
+/// Gets the kernel a backend has for a word size.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param source The backend.
+///
+/// @returns The kernel, or nothing if the backend has no kernel for the word size.
+template <typename word_t> requires sha_word<word_t>
+inline std::optional<kernel_t<word_t>> backend_kernel(backend source) {
+    if (source == backend::portable)
+        return kernel_t<word_t>{};
+#if defined(CTSHA_X86_KERNELS)
+    if (source == backend::avx2)
+        return kernel_t<word_t>{source, avx2::sha2_compress_blocks<word_t>};
+    if constexpr (std::is_same_v<word_t, std::uint32_t>) {
+        if (source == backend::sha_ni)
+            return kernel_t<word_t>{source, shani::sha256_compress_blocks};
+    } else {
+        if (source == backend::avx512)
+            return kernel_t<word_t>{source, avx512::sha512_compress_blocks};
+    }
+#endif
+    return std::nullopt;
+}
+
+/// The kernels used by the algorithms of each word size, for each size class.
+struct kernel_table_t {
+    /// The kernels for SHA-224 and SHA-256.
+    std::array<kernel_t<std::uint32_t>, num_size_classes> sha256{};
+
+    /// The kernels for SHA-384, SHA-512, and SHA-512/t.
+    std::array<kernel_t<std::uint64_t>, num_size_classes> sha512{};
+};
+
+/// Chooses the kernel for a word size.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param forced        A backend to use if it has a kernel for the word size, or nothing to use the first of the
+///                      candidates that the CPU supports.
+/// @param fastest_first The backends that may have a kernel for the word size, fastest first.
+///
+/// @returns The kernel, which is the portable one if none of the candidates can be used.
+template <typename word_t> requires sha_word<word_t>
+inline kernel_t<word_t> choose_kernel(std::optional<backend> forced, const std::array<backend, 2>& fastest_first) {
+    for (backend source : fastest_first)
+        if (forced ? *forced == source : backend_supported(source))
+            if (auto kernel = backend_kernel<word_t>(source))
+                return *kernel;
+    return kernel_t<word_t>{};
+}
+
+/// Chooses the kernels for each word size. Without timing them, the best guess is the same for every size class.
+///
+/// @param forced A backend to use for the algorithms it has kernels for, with the portable kernels used for the rest,
+///               or nothing to use the fastest kernels the CPU supports.
+///
+/// @returns The kernels.
+inline kernel_table_t make_kernel_table(std::optional<backend> forced) {
+    kernel_table_t table;
+    table.sha256.fill(choose_kernel<std::uint32_t>(forced, {backend::sha_ni, backend::avx2}));
+    table.sha512.fill(choose_kernel<std::uint64_t>(forced, {backend::avx512, backend::avx2}));
+    return table;
+}
+
+/// Gets the kernels for a choice of backend. The tables are built once, so the addresses stay valid.
+///
+/// @param forced The backend to force, or nothing for the fastest kernels the CPU supports.
+///
+/// @returns The kernels.
+inline const kernel_table_t& kernel_table(std::optional<backend> forced) {
+    static const auto tables = []() {
+        std::array<kernel_table_t, backend_names.size() + 1> result{};
+        result.at(0) = make_kernel_table(std::nullopt);
+        for (std::size_t i = 0; i < backend_names.size(); ++i)
+            result.at(i + 1) = make_kernel_table(static_cast<backend>(i));
+        return result;
+    }();
+    return tables.at(forced ? static_cast<std::size_t>(*forced) + 1 : 0);
+}
+
+/// Checks that a backend can be forced.
+///
+/// @param kernels The backend.
+///
+/// @returns The backend.
+///
+/// @throws std::invalid_argument if the CPU does not support the backend.
+inline backend check_backend(backend kernels) {
+    if (!backend_supported(kernels))
+        throw std::invalid_argument("The CPU does not support this backend");
+    return kernels;
+}
+
+/// Looks up a backend by name.
+///
+/// @param name One of backend_names.
+///
+/// @returns The backend.
+///
+/// @throws std::invalid_argument if there is no backend with the name.
+inline backend parse_backend(std::string_view name) {
+    auto found = std::find(backend_names.begin(), backend_names.end(), name);
+    if (found == backend_names.end())
+        throw std::invalid_argument("Unknown backend");
+    return static_cast<backend>(found - backend_names.begin());
+}
+
+/// Gets the kernels in use. The first time this is called they are chosen according to the CTSHA_BACKEND environment
+/// variable, if it is set and not empty, or else they are the fastest ones the CPU supports. After that they only
+/// change if ctsha::set_backend is called.
+///
+/// @returns The kernels in use.
+///
+/// @note If CTSHA_BACKEND names a backend that does not exist or that the CPU does not support, a warning is printed to
+///       the standard error once and the fastest kernels are used. Throwing instead would make every hash throw, since
+///       a static whose initialization throws is initialized again on the next call.
+inline std::atomic<const kernel_table_t*>& active_kernels() {
+    static std::atomic<const kernel_table_t*> kernels{[]() {
+        const char* name = std::getenv("CTSHA_BACKEND");
+        std::optional<backend> forced;
+        if (name != nullptr && *name != '\0') {
+            try {
+                forced = check_backend(parse_backend(name));
+            } catch (const std::invalid_argument& e) {
+                std::fprintf(stderr, "ctsha: ignoring CTSHA_BACKEND=%s: %s\n", name, e.what());
+            }
+        }
+        return &kernel_table(forced);
+    }()};
+    return kernels;
+}
+
+/// The compression functions that usage is counted for. The SHA-2 algorithms with the same word size share one.
+enum class compression_function {
+    /// SHA-1.
+    sha1,
+
+    /// SHA-224 and SHA-256.
+    sha256,
+
+    /// SHA-384, SHA-512, and SHA-512/t.
+    sha512,
+};
+
+/// The number of compression functions.
+inline constexpr std::size_t num_compression_functions = 3;
+
+/// The number of buckets that calls to the compression functions are sorted into by size. Bucket i counts calls with at
+/// least 2^i and less than 2^(i + 1) blocks, except that the last bucket counts all larger calls too.
+inline constexpr std::size_t num_call_size_buckets = 8;
+
+/// The size of a cache line on the CPUs we care about. std::hardware_destructive_interference_size would be better, but
+/// GCC warns that it can change between compiler options, which makes it unsuitable for use in a header.
+inline constexpr std::size_t cache_line_bytes = 64;
+
+/// The usage counts of one compression function with one backend.
+///
+/// @tparam counter_t The type of each count, which is atomic in the per-thread counters.
+template <typename counter_t>
+struct usage_counts_t {
+    /// The number of bytes compressed, which is a whole number of blocks and includes the padding.
+    counter_t bytes{};
+
+    /// The number of calls.
+    counter_t calls{};
+
+    /// The number of calls in each size bucket. See num_call_size_buckets.
+    std::array<counter_t, num_call_size_buckets> calls_by_size{};
+};
+
+#if CTSHA_COUNTERS
+/// The usage counters of one thread. Only the thread that owns them writes to them, so each count is updated with a
+/// plain load and store rather than a read-modify-write instruction, and is only atomic so that usage_counters can read
+/// it at the same time. They are aligned to a cache line so that threads never write to the same line. When a thread
+/// exits, its counters keep their counts and are handed to the next thread that needs some, so nothing is lost and the
+/// number of them is bounded by the number of threads that hash at the same time.
+struct alignas(cache_line_bytes) thread_counters {
+    /// The counts for each compression function and backend.
+    std::array<std::array<usage_counts_t<std::atomic<std::uint64_t>>, backend_names.size()>,
+               num_compression_functions> counts{};
+
+    /// Whether a thread owns the counters.
+    std::atomic<bool> in_use{true};
+
+    /// The next counters in the list. See counters_list.
+    thread_counters* next = nullptr;
+};
+
+/// @returns The head of the list of every thread's counters. Counters are added to the front and never removed, so the
+///          list can be walked without locks.
+inline std::atomic<thread_counters*>& counters_list() {
+    static std::atomic<thread_counters*> head{nullptr};
+    return head;
+}
+
+/// Takes the counters of a thread that has exited, or adds new counters to the list if there are none.
+///
+/// @returns The counters, which are now owned by the calling thread.
+inline thread_counters& claim_counters() {
+    auto& head = counters_list();
+    for (auto* counters = head.load(std::memory_order_acquire); counters != nullptr; counters = counters->next) {
+        bool in_use = false;
+        if (counters->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+            return *counters;
+    }
+    auto* counters = new thread_counters;
+    counters->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(counters->next, counters, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    return *counters;
+}
+
+/// Owns the counters of a thread, and gives them back when the thread exits.
+struct counters_owner {
+    /// The counters.
+    thread_counters& counters = claim_counters();
+
+    /// Gives the counters back.
+    ~counters_owner() {
+        counters.in_use.store(false, std::memory_order_release);
+    }
+};
+#endif
+
+/// Counts a call to a compression function. This does nothing if CTSHA_COUNTERS is 0.
+///
+/// @param function   The compression function.
+/// @param source     The backend of the kernel that was called.
+/// @param num_blocks The number of blocks compressed.
+/// @param num_bytes  The number of bytes compressed.
+inline void count_compression([[maybe_unused]] compression_function function, [[maybe_unused]] backend source,
+                              [[maybe_unused]] std::size_t num_blocks, [[maybe_unused]] std::size_t num_bytes) {
+#if CTSHA_COUNTERS
+    thread_local counters_owner owner;
+    auto& counts = owner.counters.counts[static_cast<std::size_t>(function)][static_cast<std::size_t>(source)];
+    auto add = [](std::atomic<std::uint64_t>& count, std::uint64_t amount) {
+        count.store(count.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    };
+    add(counts.bytes, num_bytes);
+    add(counts.calls, 1);
+    std::size_t bucket = std::bit_width(std::max<std::size_t>(num_blocks, 1)) - 1;
+    add(counts.calls_by_size[std::min(bucket, num_call_size_buckets - 1)], 1);
+#endif
+}
+
+/// The operations that have USDT probes. See probe_scope.
+enum class probe_kind {
+    /// Hashing a whole message with one of the hash functions that take a span.
+    hash,
+
+    /// Adding to a message with context::update.
+    update,
+
+    /// Finishing a message with context::digest.
+    digest,
+
+    /// Hashing a batch of messages, for example with the batch version of sha256d.
+    batch,
+};
+
+#if CTSHA_PROBES
+// Declares the semaphore of a probe, which tracers find through the probe's note and increment while they are attached.
+// It has the name the note refers to, such as ctsha_hash_entry_semaphore, and goes in the .probes section like the
+// semaphores from <sys/sdt.h>. It is inline so that every translation unit that includes this header shares it.
+#define CTSHA_PROBE_SEMAPHORE(name)                                                                                    \
+    inline volatile std::uint16_t name##_semaphore __asm__("ctsha_" #name "_semaphore")                                \
+        __attribute__((section(".probes"), used)) = 0
+
+CTSHA_PROBE_SEMAPHORE(hash_entry);
+CTSHA_PROBE_SEMAPHORE(hash_return);
+CTSHA_PROBE_SEMAPHORE(update_entry);
+CTSHA_PROBE_SEMAPHORE(update_return);
+CTSHA_PROBE_SEMAPHORE(digest_entry);
+CTSHA_PROBE_SEMAPHORE(digest_return);
+CTSHA_PROBE_SEMAPHORE(batch_entry);
+CTSHA_PROBE_SEMAPHORE(batch_return);
+
+#undef CTSHA_PROBE_SEMAPHORE
+#endif
+
+/// Fires the USDT probes at the start and end of an operation at runtime. The probes are in the "ctsha" provider and
+/// are named after the operation, for example hash_entry and hash_return. Each has three arguments: the id of the
+/// algorithm (see ctsha::algorithms), the number of bytes, and the backend whose kernel the algorithm uses for long
+/// messages (see ctsha::backend). For example, this bpftrace script makes a histogram of SHA-256 latency:
+///
+///     usdt:./program:ctsha:hash_entry /arg0 == 3/ { @start[tid] = nsecs; }
+///     usdt:./program:ctsha:hash_return /@start[tid]/ { @ns = hist(nsecs - @start[tid]); delete(@start[tid]); }
+///
+/// The backend is only looked up while a tracer is attached to the probe. Nothing happens at compile time, or if
+/// CTSHA_PROBES is 0.
+///
+/// @tparam kind The operation.
+template <probe_kind kind>
+class probe_scope {
+public:
+    /// Fires the entry probe.
+    ///
+    /// @param function  The compression function used by the algorithm.
+    /// @param algorithm The id of the algorithm.
+    /// @param length    The number of bytes.
+    constexpr probe_scope(compression_function function, std::uint16_t algorithm, std::uint64_t length)
+        : function_(function), algorithm_(algorithm), length_(length) {
+#if CTSHA_PROBES
+        if (std::is_constant_evaluated())
+            return;
+        if constexpr (kind == probe_kind::hash)
+            CTSHA_PROBE(hash_entry, algorithm_, length_, backend_argument());
+        else if constexpr (kind == probe_kind::update)
+            CTSHA_PROBE(update_entry, algorithm_, length_, backend_argument());
+        else if constexpr (kind == probe_kind::digest)
+            CTSHA_PROBE(digest_entry, algorithm_, length_, backend_argument());
+        else
+            CTSHA_PROBE(batch_entry, algorithm_, length_, backend_argument());
+#endif
+    }
+
+    /// Fires the entry probe.
+    ///
+    /// @tparam algorithm_t The algorithm, for example ctsha::algorithms::sha256.
+    ///
+    /// @param length The number of bytes.
+    template <typename algorithm_t>
+    constexpr probe_scope(algorithm_t, std::uint64_t length)
+        : probe_scope(algorithm_t::compression, algorithm_t::id, length) {}
+
+    probe_scope(const probe_scope&) = delete;
+    probe_scope& operator=(const probe_scope&) = delete;
+
+    /// Fires the return probe, with the same arguments as the entry probe.
+    constexpr ~probe_scope() {
+#if CTSHA_PROBES
+        if (std::is_constant_evaluated())
+            return;
+        if constexpr (kind == probe_kind::hash)
+            CTSHA_PROBE(hash_return, algorithm_, length_, backend_argument());
+        else if constexpr (kind == probe_kind::update)
+            CTSHA_PROBE(update_return, algorithm_, length_, backend_argument());
+        else if constexpr (kind == probe_kind::digest)
+            CTSHA_PROBE(digest_return, algorithm_, length_, backend_argument());
+        else
+            CTSHA_PROBE(batch_return, algorithm_, length_, backend_argument());
+#endif
+    }
+
+private:
+    /// @returns The backend whose kernel the algorithm uses for long messages, as the third argument of the probes.
+    std::uint64_t backend_argument() const {
+        auto kernels = backend::portable;
+        if (function_ == compression_function::sha256)
+            kernels = active_kernels().load(std::memory_order_relaxed)->sha256.back().source;
+        else if (function_ == compression_function::sha512)
+            kernels = active_kernels().load(std::memory_order_relaxed)->sha512.back().source;
+        return static_cast<std::uint64_t>(kernels);
+    }
+
+    /// The compression function used by the algorithm.
+    compression_function function_;
+
+    /// The id of the algorithm.
+    std::uint64_t algorithm_;
+
+    /// The number of bytes.
+    std::uint64_t length_;
+};
+
+/// Processes consecutive blocks of several independent SHA-256 messages. When the SHA extensions backend is in use, the
+/// messages are interleaved two at a time (see shani::sha256_compress). The batch sha256d, merkle_level, and
+/// job_manager use this.
+///
+/// @param states     The intermediate hash value of each message, which is updated in place.
+/// @param blocks     The next block of each message, in big endian byte order. Must be the same size as states.
+/// @param num_blocks The number of consecutive blocks to process for each message.
+///
+/// @returns False, without doing anything, if the SHA extensions backend is not in use.
+inline bool sha256_compress_interleaved(std::span<std::array<std::uint32_t, 8>* const> states,
+                                        std::span<const std::byte* const>              blocks,
+                                        std::size_t                                    num_blocks) {
+#if defined(CTSHA_X86_KERNELS)
+    if (active_kernels().load()->sha256.back().source == backend::sha_ni) {
+        // No blocks at all must not count as a call.
+        if (num_blocks == 0)
+            return true;
+        std::size_t i = 0;
+        for (; states.size() - i >= 2; i += 2)
+            shani::sha256_compress<2>(states.subspan(i).first<2>(), blocks.subspan(i).first<2>(), num_blocks);
+        if (i < states.size())
+            shani::sha256_compress<1>(states.subspan(i).first<1>(), blocks.subspan(i).first<1>(), num_blocks);
+        for (i = 0; i < states.size(); ++i)
+            count_compression(compression_function::sha256, backend::sha_ni, num_blocks, num_blocks * 64);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/// Processes whole blocks of a SHA-2 message with the kernel in use.
+///
+/// @tparam word_t The type of words used by the algorithm. This parameter is usually deduced.
+///
+/// @param state  The intermediate hash value, which is updated in place.
+/// @param blocks The blocks, in big endian byte order. The size must be a multiple of the block size.
+template <typename word_t> requires sha_word<word_t>
+inline void sha2_compress_blocks(std::array<word_t, 8>& state, std::span<const std::byte> blocks) {
+    // Callers such as context::update may pass no blocks at all, which must not count as a call.
+    if (blocks.empty())
+        return;
+    const auto& kernels = *active_kernels().load();
+    std::size_t num_blocks = blocks.size() / sizeof(block_t<word_t>);
+    if constexpr (std::is_same_v<word_t, std::uint32_t>) {
+        const auto& kernel = kernels.sha256[size_class(num_blocks)];
+        kernel.compress_blocks(state, blocks);
+        count_compression(compression_function::sha256, kernel.source, num_blocks, blocks.size());
+    } else {
+        const auto& kernel = kernels.sha512[size_class(num_blocks)];
+        kernel.compress_blocks(state, blocks);
+        count_compression(compression_function::sha512, kernel.source, num_blocks, blocks.size());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Top-Level Hash Functions                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Processes one block of a SHA-1 hash as described by FIPS 180-4 section 6.1.2.
+///
+/// @param state The intermediate hash value, which is updated in place.
+/// @param block The block to process, in host byte order.
+constexpr void sha1_compress(std::array<std::uint32_t, 5>& state, const block_t<std::uint32_t>& block) {
+    // Prepare the message schedule.
+    std::array<std::uint32_t, 80> w{};
+    for (std::size_t t = 0; t < w.size(); ++t)
+        w.at(t) = (t < 16) ? block.at(t) : rotate_left<1>(w.at(t - 3) ^ w.at(t - 8) ^ w.at(t - 14) ^ w.at(t - 16));
+
+    // Initialize the working variables. (a=0, b=1, c=2, d=3, e=4)
+    auto v = state;
+
+    // Compute new values for the working variables.
+    for (std::size_t t = 0; t < w.size(); ++t) {
+        std::uint32_t upper_t = rotate_left<5>(v.at(0)) + sha1_functions.at(t)(v.at(1), v.at(2), v.at(3)) +
+                                v.at(4) + sha1_constants.at(t) + w.at(t);
+        v.at(4) = v.at(3);                  // e = d
+        v.at(3) = v.at(2);                  // d = c
+        v.at(2) = rotate_left<30>(v.at(1)); // c = ROTL30(b)
+        v.at(1) = v.at(0);                  // b = a
+        v.at(0) = upper_t;                  // a = T
+    }
+
+    // Compute the intermediate hash value.
+    for (auto si = state.begin(), vi = v.begin(); si != state.end() && vi != v.end(); ++si, ++vi)
+        *si = *vi + *si;
+}
+
+/// Processes whole blocks of a SHA-1 message at runtime. SHA-1 has no faster kernels, so this only adds the call to the
+/// usage counters.
+///
+/// @param state  The intermediate hash value, which is updated in place.
+/// @param blocks The blocks, in big endian byte order. The size must be a multiple of the block size.
+inline void sha1_compress_blocks(std::array<std::uint32_t, 5>& state, std::span<const std::byte> blocks) {
+    constexpr std::size_t block_bytes = sizeof(block_t<std::uint32_t>);
+    if (blocks.empty())
+        return;
+    count_compression(compression_function::sha1, backend::portable, blocks.size() / block_bytes, blocks.size());
+    for (; !blocks.empty(); blocks = blocks.subspan(block_bytes))
+        sha1_compress(state, from_bytes<std::endian::big, std::uint32_t>(blocks.first<block_bytes>()));
+}
+
+/// The number of bytes in the longest message that fits in a single block along with its padding (FIPS 180-4 section
+/// 5.1), which is 55 bytes for the algorithms with 32-bit words and 111 bytes for those with 64-bit words.
+///
+/// @tparam word_t The type of words used by the algorithm.
+template <typename word_t> requires sha_word<word_t>
+constexpr std::size_t single_block_bytes = sizeof(block_t<word_t>) - 1 - 2 * sizeof(word_t);
+
+/// Pads a message that fits in a single block. This builds the block directly, where preprocess_message and
+/// context::digest handle messages of any length.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param message The message, which must be no longer than single_block_bytes.
+///
+/// @returns The padded block, in big endian byte order.
+template <typename word_t> requires sha_word<word_t>
+constexpr std::array<std::byte, sizeof(block_t<word_t>)> pad_single_block(std::span<const std::byte> message) {
+    std::array<std::byte, sizeof(block_t<word_t>)> block{};
+    std::copy(message.begin(), message.end(), block.begin());
+    block.at(message.size()) = std::byte{0b10000000};
+    auto size = to_bytes<std::endian::big>(std::array{static_cast<std::uint64_t>(message.size()) * bits_per_byte});
+    std::copy(size.begin(), size.end(), block.end() - size.size());
+    return block;
+}
+
+/// Pads the end of a message, the part after its last whole block, which takes one block or two.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param tail        The end of the message, which must be shorter than a block.
+/// @param total_bytes The number of bytes in the whole message.
+///
+/// @returns The padded blocks, in big endian byte order, and the number of bytes of them that are used.
+template <typename word_t> requires sha_word<word_t>
+constexpr std::pair<std::array<std::byte, 2 * sizeof(block_t<word_t>)>, std::size_t>
+pad_final_blocks(std::span<const std::byte> tail, std::uint64_t total_bytes) {
+    constexpr std::size_t block_bytes = sizeof(block_t<word_t>);
+    std::array<std::byte, 2 * block_bytes> blocks{};
+    std::copy(tail.begin(), tail.end(), blocks.begin());
+    blocks.at(tail.size()) = std::byte{0b10000000};
+    std::size_t used = tail.size() <= single_block_bytes<word_t> ? block_bytes : 2 * block_bytes;
+    auto size = to_bytes<std::endian::big>(std::array{total_bytes * bits_per_byte});
+    std::copy(size.begin(), size.end(), blocks.begin() + used - size.size());
+    return {blocks, used};
+}
+
+/// Computes the final SHA-1 hash value of a message that fits in a single block.
+///
+/// @param message The message, which must be no longer than single_block_bytes.
+///
+/// @returns The final hash value.
+constexpr std::array<std::uint32_t, 5> sha1_single_block_state(std::span<const std::byte> message) {
+    auto state = sha1_initialization_vector;
+    auto block = pad_single_block<std::uint32_t>(message);
+    if (std::is_constant_evaluated())
+        sha1_compress(state, from_bytes<std::endian::big, std::uint32_t>(block));
+    else
+        sha1_compress_blocks(state, block);
+    return state;
+}
+
+/// Computes the SHA-1 hash of a given message.
+///
+/// @tparam num_bytes The length of the message.
+///
+/// @param message The message for which the SHA-1 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-1 hash result.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, bytes<160>> sha1(const std::array<std::byte, num_bytes>& message) {
+    if constexpr (num_bytes <= single_block_bytes<std::uint32_t>)
+        return to_bytes<std::endian::big>(sha1_single_block_state(message));
+
+    auto state = sha1_initialization_vector;
+
+    if (!std::is_constant_evaluated()) {
+        // Whole blocks are processed straight from the message, and only the end of it is copied to be padded.
+        constexpr std::size_t whole_bytes = num_bytes / sizeof(block_t<std::uint32_t>) * sizeof(block_t<std::uint32_t>);
+        sha1_compress_blocks(state, std::span(message).first(whole_bytes));
+        auto [blocks, used] = pad_final_blocks<std::uint32_t>(std::span(message).subspan(whole_bytes), num_bytes);
+        sha1_compress_blocks(state, std::span(blocks).first(used));
+        return to_bytes<std::endian::big>(state);
+    }
+
+    for (const auto& block : preprocess_message<std::uint32_t>(message)) {
+        block_t<std::uint32_t> host_block{};
+        std::transform(block.begin(), block.end(), host_block.begin(), big_endian_to_host<std::uint32_t>);
+        sha1_compress(state, host_block);
+    }
+
+    return to_bytes<std::endian::big>(state);
+}
+
+/// Computes the final SHA-2 hash value of a message that fits in a single block. At runtime the block goes to the
+/// runtime kernels.
+///
+/// @tparam word_t        The type of words used by the algorithm. This parameter is usually deduced.
+/// @tparam num_constants The number of constants in the given array of constants. This parameter is usually deduced.
+///
+/// @param message               The message, which must be no longer than single_block_bytes.
+/// @param initialization_vector The initialization vector to use when computing the hash.
+/// @param constants             The set of constants to use when computing the hash.
+///
+/// @returns The final hash value.
+template <typename word_t, std::size_t num_constants> requires sha_word<word_t>
+constexpr std::array<word_t, 8> sha2_single_block_state(std::span<const std::byte>               message,
+                                                        const std::array<word_t, 8>&             initialization_vector,
+                                                        const std::array<word_t, num_constants>& constants) {
+    auto block = pad_single_block<word_t>(message);
+    auto state = initialization_vector;
+    if (std::is_constant_evaluated()) {
+        auto words = from_bytes<std::endian::big, word_t>(block);
+        sha2_compress(state, sha2_add_constants(sha2_message_schedule<num_constants>(words), constants));
+    } else {
+        sha2_compress_blocks(state, block);
+    }
+    return state;
+}
+
+/// Computes the final SHA-2 hash value of a given message, before it is converted to a digest. This function performs
+/// the work for SHA-224, SHA-256, SHA-384, and SHA-512.
+///
+/// @tparam word_t        The type of words used by the specific SHA-2 algorithm. This parameter is usually deduced.
+/// @tparam num_constants The number of constants in the given array of constants. This parameter is usually deduced.
+/// @tparam num_bytes     The number of bytes in the original message for which the SHA-2 hash is being computed. This
+///                       parameter is usually deduced.
+///
+/// @param message               The message for which the SHA-2 hash is being calculated.
+/// @param initialization_vector The initialization vector to use when computing the hash.
+/// @param constants             The set of constants to use when computing the hash.
+///
+/// @returns The final hash value.
+template <typename word_t, std::size_t num_constants, std::size_t num_bytes> requires sha_word<word_t>
+constexpr std::array<word_t, 8> sha2_state(const std::array<std::byte, num_bytes>&  message,
+                                           const std::array<word_t, 8>&             initialization_vector,
+                                           const std::array<word_t, num_constants>& constants) {
+    if constexpr (num_bytes <= single_block_bytes<word_t>)
+        return sha2_single_block_state(message, initialization_vector, constants);
+
+    auto state = initialization_vector;
+
+    if (!std::is_constant_evaluated()) {
+        // Whole blocks go straight from the message to the runtime kernels, and only the end of it is copied to be
+        // padded.
+        constexpr std::size_t whole_bytes = num_bytes / sizeof(block_t<word_t>) * sizeof(block_t<word_t>);
+        sha2_compress_blocks(state, std::span(message).first(whole_bytes));
+        auto [blocks, used] = pad_final_blocks<word_t>(std::span(message).subspan(whole_bytes), num_bytes);
+        sha2_compress_blocks(state, std::span(blocks).first(used));
+        return state;
+    }
+
+    for (const auto& block : preprocess_message<word_t>(message)) {
+        block_t<word_t> host_block{};
+        std::transform(block.begin(), block.end(), host_block.begin(), big_endian_to_host<word_t>);
+        sha2_compress(state, sha2_add_constants(sha2_message_schedule<num_constants>(host_block), constants));
+    }
+
+    return state;
+}
+
+/// Computes the SHA-2 hash of a given message. This function performs the work for SHA-224, SHA-256, SHA-384, and
+/// SHA-512.
+///
+/// @tparam digest_bits   The number of desired bits in the digest.
+/// @tparam word_t        The type of words used by the specific SHA-2 algorithm. This parameter is usually deduced.
+/// @tparam num_constants The number of constants in the given array of constants. This parameter is usually deduced.
+/// @tparam num_bytes     The number of bytes in the original message for which the SHA-2 hash is being computed. This
+///                       parameter is usually deduced.
+///
+/// @param message               The message for which the SHA-2 hash is being calculated.
+/// @param initialization_vector The initialization vector to use when computing the hash.
+/// @param constants             The set of constants to use when computing the hash.
+///
+/// @returns An array of bytes representing the SHA-2 hash result.
+template <std::size_t digest_bits, typename word_t, std::size_t num_constants, std::size_t num_bytes>
+    requires sha_word<word_t>
+constexpr std::array<std::byte, bytes<digest_bits>> sha2(const std::array<std::byte, num_bytes>&  message,
+                                                         const std::array<word_t, 8>&             initialization_vector,
+                                                         const std::array<word_t, num_constants>& constants) {
+    return final_digest<digest_bits>(sha2_state(message, initialization_vector, constants));
+}
+
+/// Computes the final SHA-256 hash value of a 32-byte message, such as another SHA-256 digest. The message and its
+/// padding always fit in a single block, and the padding words are constant, so the block is built directly from the
+/// message words instead of going through preprocess_message. At runtime the block goes to the runtime kernels.
+///
+/// @param words The message, as eight words in host byte order.
+///
+/// @returns The final hash value.
+constexpr std::array<std::uint32_t, 8> sha256_32_state(const std::array<std::uint32_t, 8>& words) {
+    auto block = sha256_32_byte_padding_block;
+    std::copy(words.begin(), words.end(), block.begin());
+
+    auto state = sha256_initialization_vector;
+    if (std::is_constant_evaluated())
+        sha2_compress(state, sha2_add_constants(sha2_message_schedule<64>(block), sha2_32_bit_constants));
+    else
+        sha2_compress_blocks(state, to_bytes<std::endian::big>(block));
+    return state;
+}
+
+/// Computes the final SHA-256 hash value of a 64-byte message, such as a Merkle tree node made of two SHA-256 digests.
+/// The second block is pure padding, so during constant evaluation its message schedule (with the round constants
+/// added) comes from sha256_64_byte_padding_schedule, and only the rounds need to be run for it. At runtime both blocks
+/// go to the runtime kernels.
+///
+/// @param block The message, as a block of words in host byte order.
+///
+/// @returns The final hash value.
+constexpr std::array<std::uint32_t, 8> sha256_64_state(const block_t<std::uint32_t>& block) {
+    auto state = sha256_initialization_vector;
+    if (std::is_constant_evaluated()) {
+        sha2_compress(state, sha2_add_constants(sha2_message_schedule<64>(block), sha2_32_bit_constants));
+        sha2_compress(state, sha256_64_byte_padding_schedule);
+    } else {
+        constexpr auto padding = to_bytes<std::endian::big>(sha256_64_byte_padding_block);
+        std::array<std::byte, 2 * sizeof(block_t<std::uint32_t>)> blocks{};
+        auto message = to_bytes<std::endian::big>(block);
+        std::copy(padding.begin(), padding.end(), std::copy(message.begin(), message.end(), blocks.begin()));
+        sha2_compress_blocks(state, blocks);
+    }
+    return state;
+}
+
+/// Computes the final SHA-256 hash value of a given message, using the fixed-size functions where possible.
+///
+/// @tparam num_bytes The number of bytes in the message. This parameter is usually deduced.
+///
+/// @param message The message for which the SHA-256 hash is being computed.
+///
+/// @returns The final hash value.
+template <std::size_t num_bytes>
+constexpr std::array<std::uint32_t, 8> sha256_state(const std::array<std::byte, num_bytes>& message) {
+    if constexpr (num_bytes == 32)
+        return sha256_32_state(from_bytes<std::endian::big, std::uint32_t>(message));
+    else if constexpr (num_bytes == 64)
+        return sha256_64_state(from_bytes<std::endian::big, std::uint32_t>(message));
+    else
+        return sha2_state(message, sha256_initialization_vector, sha2_32_bit_constants);
+}
+
+/// Computes the double SHA-256 hash, SHA-256(SHA-256(message)), of a given message. The words of the first hash value
+/// are fed straight into the second hash without being converted to bytes and back.
+///
+/// @tparam num_bytes The number of bytes in the message. This parameter is usually deduced.
+///
+/// @param message The message for which the double SHA-256 hash is being computed.
+///
+/// @returns An array of bytes representing the double SHA-256 hash result.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, bytes<256>> sha256d(const std::array<std::byte, num_bytes>& message) {
+    return final_digest<256>(sha256_32_state(sha256_state(message)));
+}
+
+/// The multi-buffer version of sha256_32_state.
+///
+/// @param words The message for each lane, as eight words in host byte order.
+///
+/// @returns The final hash value for each lane.
+constexpr std::array<lanes_t<std::uint32_t>, 8>
+sha256_32_state_lanes(const std::array<lanes_t<std::uint32_t>, 8>& words) {
+    std::array<lanes_t<std::uint32_t>, 16> block{};
+    std::copy(words.begin(), words.end(), block.begin());
+    std::transform(sha256_32_byte_padding_block.begin() + words.size(), sha256_32_byte_padding_block.end(),
+                   block.begin() + words.size(), broadcast<std::uint32_t>);
+
+    std::array<lanes_t<std::uint32_t>, 8> state{};
+    std::transform(sha256_initialization_vector.begin(), sha256_initialization_vector.end(), state.begin(),
+                   broadcast<std::uint32_t>);
+    sha2_compress_lanes(state, sha2_add_constants_lanes(sha2_message_schedule_lanes<64>(block), sha2_32_bit_constants));
+    return state;
+}
+
+/// The multi-buffer version of sha256_state.
+///
+/// @tparam num_bytes The number of bytes in each message. This parameter is usually deduced.
+///
+/// @param messages The message for each lane.
+///
+/// @returns The final hash value for each lane.
+template <std::size_t num_bytes>
+constexpr std::array<lanes_t<std::uint32_t>, 8>
+sha256_state_lanes(const std::array<std::array<std::byte, num_bytes>, sha2_lanes>& messages) {
+    std::array<lanes_t<std::uint32_t>, 8> state{};
+    std::transform(sha256_initialization_vector.begin(), sha256_initialization_vector.end(), state.begin(),
+                   broadcast<std::uint32_t>);
+
+    // Every message has the same length, so they all have the same number of blocks.
+    std::array<decltype(preprocess_message<std::uint32_t>(messages.at(0))), sha2_lanes> blocks{};
+    std::transform(messages.begin(), messages.end(), blocks.begin(), preprocess_message<std::uint32_t, num_bytes>);
+    for (std::size_t block_index = 0; block_index < blocks.at(0).size(); ++block_index) {
+        std::array<block_t<std::uint32_t>, sha2_lanes> host_blocks{};
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane)
+            std::transform(blocks.at(lane).at(block_index).begin(), blocks.at(lane).at(block_index).end(),
+                           host_blocks.at(lane).begin(), big_endian_to_host<std::uint32_t>);
+        auto block = transpose(host_blocks);
+        sha2_compress_lanes(state,
+                            sha2_add_constants_lanes(sha2_message_schedule_lanes<64>(block), sha2_32_bit_constants));
+    }
+
+    return state;
+}
+
+/// The multi-buffer version of sha256_64_state.
+///
+/// @param block The message for each lane, as a block of words in host byte order.
+///
+/// @returns The final hash value for each lane.
+constexpr std::array<lanes_t<std::uint32_t>, 8>
+sha256_64_state_lanes(const std::array<lanes_t<std::uint32_t>, 16>& block) {
+    std::array<lanes_t<std::uint32_t>, 8> state{};
+    std::transform(sha256_initialization_vector.begin(), sha256_initialization_vector.end(), state.begin(),
+                   broadcast<std::uint32_t>);
+    sha2_compress_lanes(state, sha2_add_constants_lanes(sha2_message_schedule_lanes<64>(block), sha2_32_bit_constants));
+    sha2_compress_lanes(state, sha256_64_byte_padding_schedule_lanes);
+    return state;
+}
+
+/// Computes the double SHA-256 hash of one or two equal-length messages with their rounds interleaved. (See
+/// sha256_compress_interleaved.)
+///
+/// @tparam num_bytes The number of bytes in each message. This parameter is usually deduced.
+///
+/// @param messages The messages, of which there must be one or two.
+/// @param digests  Receives the digest of each message. Must be the same size as messages.
+///
+/// @returns False, without doing anything, if the SHA extensions backend is not in use.
+template <std::size_t num_bytes>
+inline bool sha256d_interleaved(std::span<const std::array<std::byte, num_bytes>> messages,
+                                std::span<std::array<std::byte, bytes<256>>>     digests) {
+    constexpr std::size_t block_bytes = sizeof(block_t<std::uint32_t>);
+    constexpr std::size_t whole_bytes = num_bytes / block_bytes * block_bytes;
+    std::array<std::array<std::uint32_t, 8>, 2> states{sha256_initialization_vector, sha256_initialization_vector};
+    std::array<std::array<std::uint32_t, 8>*, 2> state_pointers{&states.at(0), &states.at(1)};
+    std::array<const std::byte*, 2> block_pointers{};
+    auto active_states = std::span(state_pointers).first(messages.size());
+    auto active_blocks = std::span(block_pointers).first(messages.size());
+
+    // The whole blocks are processed straight from the messages.
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        block_pointers.at(i) = messages[i].data();
+    if (!sha256_compress_interleaved(active_states, active_blocks, whole_bytes / block_bytes))
+        return false;
+
+    // Then the end of each message with its padding, which is one block or two.
+    std::array<std::array<std::byte, 2 * block_bytes>, 2> tails{};
+    std::size_t tail_bytes = 0;
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        std::tie(tails.at(i), tail_bytes) =
+            pad_final_blocks<std::uint32_t>(std::span(messages[i]).subspan(whole_bytes), num_bytes);
+        block_pointers.at(i) = tails.at(i).data();
+    }
+    sha256_compress_interleaved(active_states, active_blocks, tail_bytes / block_bytes);
+
+    // The second hash is of the 32-byte first hash value, so its single block is built as in sha256_32_state.
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        auto block = sha256_32_byte_padding_block;
+        std::copy(states.at(i).begin(), states.at(i).end(), block.begin());
+        auto second_block = to_bytes<std::endian::big>(block);
+        std::copy(second_block.begin(), second_block.end(), tails.at(i).begin());
+        states.at(i) = sha256_initialization_vector;
+    }
+    sha256_compress_interleaved(active_states, active_blocks, 1);
+
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        digests[i] = final_digest<256>(states.at(i));
+    return true;
+}
+
+/// Computes the double SHA-256 hash of a batch of equal-length messages. During constant evaluation the messages are
+/// hashed a lane's worth at a time. At runtime, with the SHA extensions, they are hashed two at a time with their
+/// rounds interleaved (see sha256d_interleaved). Otherwise each message goes to the runtime kernels, which are faster
+/// than the portable lanes.
+///
+/// @tparam num_bytes The number of bytes in each message. This parameter is usually deduced.
+///
+/// @param messages The messages for which the double SHA-256 hash is being computed.
+/// @param digests  Receives the digest of each message. Must be the same size as messages.
+template <std::size_t num_bytes>
+constexpr void sha256d(std::span<const std::array<std::byte, num_bytes>> messages,
+                       std::span<std::array<std::byte, bytes<256>>>     digests) {
+    if (messages.size() != digests.size())
+        throw std::invalid_argument("There must be one digest for each message.");
+
+    if (!std::is_constant_evaluated()) {
+        for (std::size_t first = 0; first < messages.size(); first += 2) {
+            std::size_t count = std::min<std::size_t>(2, messages.size() - first);
+            if (!sha256d_interleaved(messages.subspan(first, count), digests.subspan(first, count)))
+                for (std::size_t i = first; i < first + count; ++i)
+                    digests[i] = sha256d(messages[i]);
+        }
+        return;
+    }
+
+    for (std::size_t first = 0; first < messages.size(); first += sha2_lanes) {
+        // Any lanes left over at the end just repeat the last message, and their results are thrown away.
+        std::array<std::array<std::byte, num_bytes>, sha2_lanes> lane_messages{};
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane)
+            lane_messages.at(lane) = messages[std::min(first + lane, messages.size() - 1)];
+
+        auto states = transpose(sha256_32_state_lanes(sha256_state_lanes(lane_messages)));
+        for (std::size_t lane = 0; lane < sha2_lanes && first + lane < messages.size(); ++lane)
+            digests[first + lane] = final_digest<256>(states.at(lane));
+    }
+}
+
+/// The SHA-512/t initialization vectors rely on an intermediate initialization vector which is the SHA-512
+/// initialization vector with every byte xored with 0xa5. See FIPS 180-4 section 5.3.6.
+constexpr std::array<std::uint64_t, 8> sha512_t_intermediate_initialization_vector = []() consteval {
+    auto iv = sha512_initialization_vector;
+    std::for_each(iv.begin(), iv.end(), [](auto& entry) { entry ^= 0xa5a5a5a5a5a5a5a5; });
+    return iv;
+}();
+
+/// Computes the initialization vector for the SHA-512/t hashes. (FIPS 180-4 section 5.3.6.)
+///
+/// @tparam hash_bits The number of bits in the truncated SHA-512/t hash.
+///
+/// @note This is separate from the other initialization vectors to avoid needing to declare a prototype for sha2.
+template <std::size_t hash_bits> requires (hash_bits != 0 && hash_bits != 384)
+constexpr std::array<std::uint64_t, 8> sha512_t_initialization_vector = []() consteval {
+    using b = std::byte;
+    constexpr const auto& intermediate_iv = sha512_t_intermediate_initialization_vector;
+
+    // Compute the SHA-512 hash of the string "SHA-512/t" where "t" is the ASCII string representation of hash_bits. The
+    // output of that will be used as the initialization vector.
+    auto hash_message = [&intermediate_iv]<std::size_t num_digits>(const std::array<b, num_digits>& t) consteval {
+        std::array<b, 8> prefix { b{'S'}, b{'H'}, b{'A'}, b{'-'}, b{'5'}, b{'1'}, b{'2'}, b{'/'} };
+        std::array<b, 8 + num_digits> message;
+        std::copy(prefix.begin(), prefix.end(), message.begin());
+        std::copy(t.begin(), t.end(), message.begin() + prefix.size());
+        return detail::sha2<512>(message, intermediate_iv, sha2_64_bit_constants);
+    };
+
+    // Compute the hash. We need a branch for each number of digits that t can be.
+    std::array<std::byte, bytes<512>> hash_result{};
+    if constexpr (hash_bits < 10) {
+        hash_result = hash_message(std::array{b{hash_bits + '0'}});
+    } else if constexpr (hash_bits < 100) {
+        hash_result = hash_message(std::array{b{hash_bits / 10 + '0' }, b{hash_bits % 10 + '0'}});
+    } else {
+        hash_result =
+            hash_message(std::array{b{hash_bits / 100 + '0'}, b{hash_bits % 100 / 10 + '0' }, b{hash_bits % 10 + '0'}});
+    }
+
+    // Convert the hash result (an array of bytes) into an initialization vector (array of host byte order uint64_ts).
+    std::array<std::uint64_t, 8> iv{};
+    for (std::size_t iv_index = 0; iv_index < iv.size(); ++iv_index) {
+        std::uint64_t iv_value{};
+        for (std::size_t byte_index = 0; byte_index < bits_per_byte; ++ byte_index) {
+            auto index = iv_index * sizeof(std::uint64_t) + byte_index;
+            auto shift = byte_index * bits_per_byte;
+            iv_value |= static_cast<std::uint64_t>(hash_result.at(index)) << shift;
+        }
+
+        iv.at(iv_index) = big_endian_to_host(iv_value);
+    }
+    return iv;
+}();
+
+/// Checks that a number of bits is a valid truncated length for SHA-512/t. (FIPS 180-4 section 5.3.6.)
+///
+/// @param hash_bits The number of bits in the truncated hash.
+///
+/// @throws std::invalid_argument if hash_bits is zero, 384, or 512 or more.
+inline void check_sha512_t_bits(std::size_t hash_bits) {
+    if (hash_bits == 0 || hash_bits == 384 || hash_bits >= 512)
+        throw std::invalid_argument("SHA-512/t needs 0 < t < 512 and t != 384");
+}
+
+/// A cached SHA-512/t initialization vector. The words are atomic because two threads may compute the same vector at
+/// the same time. They both store the same values, and whichever sets ready first publishes them.
+struct sha512_t_iv_entry {
+    /// Whether the words have been computed.
+    std::atomic<bool> ready{false};
+
+    /// The initialization vector.
+    std::array<std::atomic<std::uint64_t>, 8> words{};
+};
+
+/// Gets the SHA-512/t initialization vector for a number of bits chosen at runtime. The common lengths come from the
+/// compile-time vectors. Any other length is computed the first time it is needed and cached in a lock-free table, with
+/// one entry for each possible length.
+///
+/// @param hash_bits The number of bits in the truncated hash.
+///
+/// @returns The initialization vector.
+///
+/// @throws std::invalid_argument if hash_bits is not a valid truncated length.
+inline std::array<std::uint64_t, 8> sha512_t_initialization_vector_at_runtime(std::size_t hash_bits) {
+    check_sha512_t_bits(hash_bits);
+    if (hash_bits == 224)
+        return sha512_t_initialization_vector<224>;
+    if (hash_bits == 256)
+        return sha512_t_initialization_vector<256>;
+
+    static std::array<sha512_t_iv_entry, 512> cache{};
+    auto& entry = cache.at(hash_bits);
+    std::array<std::uint64_t, 8> iv{};
+    if (entry.ready.load(std::memory_order_acquire)) {
+        for (std::size_t i = 0; i < iv.size(); ++i)
+            iv.at(i) = entry.words.at(i).load(std::memory_order_relaxed);
+        return iv;
+    }
+
+    // The vector is the SHA-512 hash of "SHA-512/t", with t in decimal, computed from the intermediate vector.
+    std::array<std::byte, 11> message{std::byte{'S'}, std::byte{'H'}, std::byte{'A'}, std::byte{'-'},
+                                      std::byte{'5'}, std::byte{'1'}, std::byte{'2'}, std::byte{'/'}};
+    std::size_t size = 8;
+    for (std::size_t divisor : {100, 10, 1})
+        if (hash_bits >= divisor || divisor == 1)
+            message.at(size++) = static_cast<std::byte>('0' + hash_bits / divisor % 10);
+    iv = sha2_single_block_state(std::span(message).first(size), sha512_t_intermediate_initialization_vector,
+                                 sha2_64_bit_constants);
+
+    for (std::size_t i = 0; i < iv.size(); ++i)
+        entry.words.at(i).store(iv.at(i), std::memory_order_relaxed);
+    entry.ready.store(true, std::memory_order_release);
+    return iv;
+}
+
+/// Describes one of the SHA-2 algorithms for use with ctsha::context.
+///
+/// @tparam hash_bits    The number of bits in the digest.
+/// @tparam iv           The initialization vector of the algorithm.
+/// @tparam algorithm_id The number that identifies the algorithm in serialized contexts.
+template <std::size_t hash_bits, std::array iv, std::uint16_t algorithm_id>
+struct sha2_algorithm {
+    /// The type of words used by the algorithm.
+    using word_t = typename decltype(iv)::value_type;
+
+    /// The number that identifies the algorithm in serialized contexts.
+    static constexpr std::uint16_t id = algorithm_id;
+
+    /// The compression function, for the usage counters and probes.
+    static constexpr compression_function compression =
+        std::is_same_v<word_t, std::uint32_t> ? compression_function::sha256 : compression_function::sha512;
+
+    /// The number of bits in the digest.
+    static constexpr std::size_t digest_bits = hash_bits;
+
+    /// The initial hash value.
+    static constexpr auto initialization_vector = iv;
+
+    /// Processes one block.
+    ///
+    /// @param state The intermediate hash value, which is updated in place.
+    /// @param block The block to process, in host byte order.
+    static constexpr void compress(std::array<word_t, 8>& state, const block_t<word_t>& block) {
+        constexpr const auto& constants = sha2_constants<word_t>();
+        sha2_compress(state, sha2_add_constants(sha2_message_schedule<constants.size()>(block), constants));
+    }
+
+    /// Processes whole blocks with the fastest kernel available. This is only used at runtime.
+    ///
+    /// @param state  The intermediate hash value, which is updated in place.
+    /// @param blocks The blocks to process, in big endian byte order.
+    static void compress_blocks(std::array<word_t, 8>& state, std::span<const std::byte> blocks) {
+        sha2_compress_blocks(state, blocks);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Merkle Trees                                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// A SHA-256 digest, which is what the nodes of a Merkle tree are made of.
+using sha256_digest_t = std::array<std::byte, bytes<256>>;
+
+/// Computes the SHA-256 hash of the concatenation of two digests, which is the parent of two nodes in a Merkle tree.
+///
+/// @param left  The left child.
+/// @param right The right child.
+///
+/// @returns The parent node.
+constexpr sha256_digest_t merkle_parent(const sha256_digest_t& left, const sha256_digest_t& right) {
+    block_t<std::uint32_t> block{};
+    auto left_words  = from_bytes<std::endian::big, std::uint32_t>(left);
+    auto right_words = from_bytes<std::endian::big, std::uint32_t>(right);
+    std::copy(right_words.begin(), right_words.end(), std::copy(left_words.begin(), left_words.end(), block.begin()));
+    return final_digest<256>(sha256_64_state(block));
+}
+
+/// Computes one level of a Merkle tree from the level below it. During constant evaluation pairs of children are
+/// hashed a lane's worth at a time, and any pairs left over are hashed one at a time. At runtime, with the SHA
+/// extensions, two pairs are hashed at a time with their rounds interleaved (see sha256_compress_interleaved).
+/// Otherwise every pair goes to the runtime kernels, which are faster than the portable lanes. If there is an odd
+/// number of children the last one is carried up to the next level unchanged.
+///
+/// @param children The nodes in the lower level.
+/// @param parents  Receives the nodes in the upper level. It may overlap children as long as it starts at the same
+///                 place, which lets a tree be computed in place.
+///
+/// @returns The number of nodes in the upper level.
+constexpr std::size_t merkle_level(std::span<const sha256_digest_t> children, std::span<sha256_digest_t> parents) {
+    const std::size_t num_pairs = children.size() / 2;
+
+    std::size_t pair = 0;
+    if (!std::is_constant_evaluated()) {
+        constexpr auto padding = to_bytes<std::endian::big>(sha256_64_byte_padding_block);
+        for (; pair + 2 <= num_pairs; pair += 2) {
+            // Both pairs of children are copied before either parent is written, so the levels can overlap.
+            std::array<std::array<std::byte, 2 * sizeof(block_t<std::uint32_t>)>, 2> blocks{};
+            for (std::size_t i = 0; i < blocks.size(); ++i) {
+                const auto& left  = children[2 * (pair + i)];
+                const auto& right = children[2 * (pair + i) + 1];
+                std::copy(padding.begin(), padding.end(),
+                          std::copy(right.begin(), right.end(),
+                                    std::copy(left.begin(), left.end(), blocks.at(i).begin())));
+            }
+
+            std::array<std::array<std::uint32_t, 8>, 2> states{sha256_initialization_vector,
+                                                               sha256_initialization_vector};
+            std::array<std::array<std::uint32_t, 8>*, 2> state_pointers{&states.at(0), &states.at(1)};
+            std::array<const std::byte*, 2> block_pointers{blocks.at(0).data(), blocks.at(1).data()};
+            if (!sha256_compress_interleaved(state_pointers, block_pointers, 2))
+                break;
+            for (std::size_t i = 0; i < states.size(); ++i)
+                parents[pair + i] = final_digest<256>(states.at(i));
+        }
+    }
+
+    for (; std::is_constant_evaluated() && pair + sha2_lanes <= num_pairs; pair += sha2_lanes) {
+        // Every child is read before any parent is written, so the levels can overlap.
+        std::array<block_t<std::uint32_t>, sha2_lanes> blocks{};
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane) {
+            auto left_words  = from_bytes<std::endian::big, std::uint32_t>(children[2 * (pair + lane)]);
+            auto right_words = from_bytes<std::endian::big, std::uint32_t>(children[2 * (pair + lane) + 1]);
+            std::copy(right_words.begin(), right_words.end(),
+                      std::copy(left_words.begin(), left_words.end(), blocks.at(lane).begin()));
+        }
+
+        auto states = transpose(sha256_64_state_lanes(transpose(blocks)));
+        for (std::size_t lane = 0; lane < sha2_lanes; ++lane)
+            parents[pair + lane] = final_digest<256>(states.at(lane));
+    }
+
+    for (; pair < num_pairs; ++pair)
+        parents[pair] = merkle_parent(children[2 * pair], children[2 * pair + 1]);
+
+    if (children.size() % 2 != 0)
+        parents[num_pairs] = children.back();
+
+    return num_pairs + children.size() % 2;
+}
+
+/// Computes the root of a Merkle tree one level at a time.
+///
+/// @param leaves  The leaves of the tree.
+/// @param scratch Space for the upper levels of the tree. Must hold at least half as many digests as there are leaves,
+///                rounded up.
+///
+/// @returns The root of the tree.
+constexpr sha256_digest_t merkle_root(std::span<const sha256_digest_t> leaves, std::span<sha256_digest_t> scratch) {
+    if (leaves.empty())
+        return final_digest<256>(sha256_state(std::array<std::byte, 0>{}));
+    if (leaves.size() == 1)
+        return leaves.front();
+    if (scratch.size() < (leaves.size() + 1) / 2)
+        throw std::invalid_argument("The scratch space must hold half as many digests as there are leaves.");
+
+    for (std::size_t num_nodes = merkle_level(leaves, scratch); num_nodes > 1;)
+        num_nodes = merkle_level(scratch.first(num_nodes), scratch);
+    return scratch.front();
+}
+
+} // End namespace detail.
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Public Interface                                                                                                   //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// This namespace contains a type describing each algorithm, for use with ctsha::context. Each has an id that is
+/// stored in serialized contexts: 1 to 5 for SHA-1, SHA-224, SHA-256, SHA-384, and SHA-512, and 0x1000 plus t for
+/// SHA-512/t.
+namespace algorithms {
+
+/// SHA-1. (FIPS 180-4 section 6.1.)
+struct sha1 {
+    /// The type of words used by the algorithm.
+    using word_t = std::uint32_t;
+
+    /// The number that identifies the algorithm in serialized contexts.
+    static constexpr std::uint16_t id = 1;
+
+    /// The compression function, for the usage counters and probes.
+    static constexpr detail::compression_function compression = detail::compression_function::sha1;
+
+    /// The number of bits in the digest.
+    static constexpr std::size_t digest_bits = 160;
+
+    /// The initial hash value.
+    static constexpr auto initialization_vector = detail::sha1_initialization_vector;
+
+    /// Processes one block.
+    ///
+    /// @param state The intermediate hash value, which is updated in place.
+    /// @param block The block to process, in host byte order.
+    static constexpr void compress(std::array<word_t, 5>& state, const detail::block_t<word_t>& block) {
+        detail::sha1_compress(state, block);
+    }
+
+    /// Processes whole blocks. This is only used at runtime.
+    ///
+    /// @param state  The intermediate hash value, which is updated in place.
+    /// @param blocks The blocks to process, in big endian byte order.
+    static void compress_blocks(std::array<word_t, 5>& state, std::span<const std::byte> blocks) {
+        detail::sha1_compress_blocks(state, blocks);
+    }
+};
+
+/// SHA-224. (FIPS 180-4 section 6.3.)
+struct sha224 : detail::sha2_algorithm<224, detail::sha224_initialization_vector, 2> {};
+
+/// SHA-256. (FIPS 180-4 section 6.2.)
+struct sha256 : detail::sha2_algorithm<256, detail::sha256_initialization_vector, 3> {};
+
+/// SHA-384. (FIPS 180-4 section 6.5.)
+struct sha384 : detail::sha2_algorithm<384, detail::sha384_initialization_vector, 4> {};
+
+/// SHA-512. (FIPS 180-4 section 6.4.)
+struct sha512 : detail::sha2_algorithm<512, detail::sha512_initialization_vector, 5> {};
+
+/// SHA-512/t. (FIPS 180-4 section 6.7.)
+///
+/// @tparam hash_bits The number of bits in the final, truncated hash.
+template <std::size_t hash_bits> requires (hash_bits != 0 && hash_bits != 384 && hash_bits < 512)
+struct sha512_t
+    : detail::sha2_algorithm<hash_bits, detail::sha512_t_initialization_vector<hash_bits>, 0x1000 + hash_bits> {};
+
+} // End namespace algorithms.
+
+/// Computes the SHA-1 hash of a byte array.
+///
+/// @tparam num_bytes The number of bytes in the message for which the SHA-1 hash is being computed.
+///
+/// @param message The message for which the SHA-1 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-1 result.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, detail::bytes<160>> sha1(const std::array<std::byte, num_bytes>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha1{}, num_bytes);
+    return detail::sha1(message);
+}
+
+/// Computes the SHA-224 hash of a byte array.
+///
+/// @tparam num_bytes The number of bytes in the message for which the SHA-224 hash is being computed.
+///
+/// @param message The message for which the SHA-224 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-224 result.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, detail::bytes<224>> sha224(const std::array<std::byte, num_bytes>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha224{}, num_bytes);
+    return detail::sha2<224>(message, detail::sha224_initialization_vector, detail::sha2_32_bit_constants);
+}
+
+/// Computes the SHA-256 hash of a byte array.
+///
+/// @tparam num_bytes The number of bytes in the message for which the SHA-256 hash is being computed.
+///
+/// @param message The message for which the SHA-256 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-256 result.
+///
+/// @note 32-byte and 64-byte messages use the faster sha256_32 and sha256_64 functions.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, detail::bytes<256>> sha256(const std::array<std::byte, num_bytes>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha256{}, num_bytes);
+    return detail::final_digest<256>(detail::sha256_state(message));
+}
+
+/// Computes the SHA-256 hash of a 32-byte message, such as another SHA-256 digest. This skips the generic message
+/// preprocessing since the padding is known ahead of time.
+///
+/// @param message The message for which the SHA-256 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-256 result.
+constexpr std::array<std::byte, detail::bytes<256>> sha256_32(const std::array<std::byte, 32>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha256{}, message.size());
+    auto words = detail::from_bytes<std::endian::big, std::uint32_t>(message);
+    return detail::final_digest<256>(detail::sha256_32_state(words));
+}
+
+/// Computes the SHA-256 hash of a 64-byte message, such as a Merkle tree node made of two SHA-256 digests. During
+/// constant evaluation the message schedule of the padding block is precomputed, which saves about a third of the work.
+/// At runtime both blocks go to the runtime kernels in one call.
+///
+/// @param message The message for which the SHA-256 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-256 result.
+constexpr std::array<std::byte, detail::bytes<256>> sha256_64(const std::array<std::byte, 64>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha256{}, message.size());
+    auto block = detail::from_bytes<std::endian::big, std::uint32_t>(message);
+    return detail::final_digest<256>(detail::sha256_64_state(block));
+}
+
+/// Computes the double SHA-256 hash, SHA-256(SHA-256(message)), of a byte array. The first hash value is fed straight
+/// into the second hash instead of being converted to bytes and back.
+///
+/// @tparam num_bytes The number of bytes in the message for which the double SHA-256 hash is being computed.
+///
+/// @param message The message for which the double SHA-256 hash is being computed.
+///
+/// @returns An array of bytes representing the double SHA-256 result.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, detail::bytes<256>> sha256d(const std::array<std::byte, num_bytes>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha256{}, num_bytes);
+    return detail::sha256d(message);
+}
+
+/// Computes the SHA-384 hash of a byte array.
+///
+/// @tparam num_bytes The number of bytes in the message for which the SHA-384 hash is being computed.
+///
+/// @param message The message for which the SHA-384 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-384 result.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, detail::bytes<384>> sha384(const std::array<std::byte, num_bytes>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha384{}, num_bytes);
+    return detail::sha2<384>(message, detail::sha384_initialization_vector, detail::sha2_64_bit_constants);
+}
+
+/// Computes the SHA-512 hash of a byte array.
+///
+/// @tparam num_bytes The number of bytes in the message for which the SHA-512 hash is being computed.
+///
+/// @param message The message for which the SHA-512 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-512 result.
+template <std::size_t num_bytes>
+constexpr std::array<std::byte, detail::bytes<512>> sha512(const std::array<std::byte, num_bytes>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha512{}, num_bytes);
+    return detail::sha2<512>(message, detail::sha512_initialization_vector, detail::sha2_64_bit_constants);
+}
+
+/// Computes the SHA-512/t hash of a byte array. (FIPS 180-4 section 5.3.6.)
+///
 /// @tparam hash_bits The number of bits in the final, truncated hash.
 /// @tparam num_bytes The number of bytes in the message for which the SHA-512/t hash is being computed.
 ///
@@ -678,12 +2737,682 @@ consteval std::array<std::byte, detail::bytes<512>> sha512(const std::array<std:
 ///
 /// @returns An array of bytes representing the SHA-512/t result.
 template <std::size_t hash_bits, std::size_t num_bytes> requires (hash_bits != 0 && hash_bits != 384 && hash_bits < 512)
-consteval std::array<std::byte, detail::bytes<hash_bits>> sha512_t(const std::array<std::byte, num_bytes>& message) {
+constexpr std::array<std::byte, detail::bytes<hash_bits>> sha512_t(const std::array<std::byte, num_bytes>& message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha512_t<hash_bits>{}, num_bytes);
     return detail::sha2<hash_bits>(message,
                                    detail::sha512_t_initialization_vector<hash_bits>,
                                    detail::sha2_64_bit_constants);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Streaming Interface                                                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Computes a hash incrementally, for messages whose length is not known at compile time or that do not fit in memory.
+/// Feed the message in with any number of calls to update, then call digest to get the result.
+///
+/// @tparam algorithm_t The algorithm to use, for example ctsha::algorithms::sha256.
+template <typename algorithm_t>
+class context {
+public:
+    /// The type of words used by the algorithm.
+    using word_t = typename algorithm_t::word_t;
+
+    /// The type of the digest produced by the algorithm.
+    using digest_t = std::array<std::byte, detail::bytes<algorithm_t::digest_bits>>;
+
+    /// The type of the intermediate hash value.
+    using state_t = std::remove_const_t<decltype(algorithm_t::initialization_vector)>;
+
+    /// The number of bytes in a block.
+    static constexpr std::size_t block_bytes = sizeof(detail::block_t<word_t>);
+
+    /// The version of the format written by serialize.
+    static constexpr std::uint8_t serialization_version = 1;
+
+    /// The number of bytes in a serialized context before the part of the message that does not fill a whole block:
+    /// the version, algorithm id, intermediate hash value, and number of bytes added.
+    static constexpr std::size_t serialized_header_bytes =
+        1 + sizeof(algorithm_t::id) + sizeof(algorithm_t::initialization_vector) + sizeof(std::uint64_t);
+
+    /// The largest number of bytes in a serialized context.
+    static constexpr std::size_t max_serialized_bytes = serialized_header_bytes + block_bytes - 1;
+
+    /// Starts a hash from the initialization vector of the algorithm.
+    constexpr context() = default;
+
+    /// Starts a hash from a different initial hash value. SHA-512/t with t chosen at runtime uses this to hash with the
+    /// SHA-512 context from an initialization vector computed at runtime.
+    ///
+    /// @param initial_hash_value The initial hash value.
+    explicit constexpr context(const state_t& initial_hash_value) : state_(initial_hash_value) {}
+
+    /// Adds more of the message to the hash.
+    ///
+    /// @param data The next part of the message.
+    ///
+    /// @returns This context, so calls can be chained.
+    constexpr context& update(std::span<const std::byte> data) {
+        detail::probe_scope<detail::probe_kind::update> probe(algorithm_t{}, data.size());
+        total_bytes_ += data.size();
+
+        // Top up a partially filled block first.
+        if (buffered_ > 0) {
+            std::size_t count = std::min(block_bytes - buffered_, data.size());
+            std::copy(data.begin(), data.begin() + count, buffer_.begin() + buffered_);
+            buffered_ += count;
+            data = data.subspan(count);
+            if (buffered_ < block_bytes)
+                return *this;
+            compress(buffer_);
+            buffered_ = 0;
+        }
+
+        // Whole blocks are processed straight from the input, and whatever is left is kept for next time.
+        std::size_t whole_bytes = data.size() / block_bytes * block_bytes;
+        compress(data.first(whole_bytes));
+        data = data.subspan(whole_bytes);
+        std::copy(data.begin(), data.end(), buffer_.begin());
+        buffered_ = data.size();
+        return *this;
+    }
+
+#if __has_include(<sys/uio.h>)
+    /// Adds more of the message to the hash from a scatter/gather array, such as one filled in by readv. The buffers
+    /// are hashed as if they were concatenated, but only the bytes that carry over from one buffer to the next to make
+    /// up a whole block are copied. This is runtime-only.
+    ///
+    /// @param buffers The next parts of the message, in order.
+    ///
+    /// @returns This context, so calls can be chained.
+    context& update(std::span<const iovec> buffers) {
+        for (const iovec& buffer : buffers)
+            update(std::span(static_cast<const std::byte*>(buffer.iov_base), buffer.iov_len));
+        return *this;
+    }
+#endif
+
+    /// Computes the digest of everything added so far. This does not modify the context, so more data may be added
+    /// afterwards.
+    ///
+    /// @returns The digest.
+    constexpr digest_t digest() const {
+        detail::probe_scope<detail::probe_kind::digest> probe(algorithm_t{}, total_bytes_);
+        // Pad the message as described by FIPS 180-4 section 5.1. As in preprocess_message, only 64 bits of length are
+        // supported even though the 64-bit word algorithms allow 128 bits.
+        context padded = *this;
+        padded.buffer_.at(padded.buffered_++) = std::byte{0b10000000};
+        if (padded.buffered_ > block_bytes - 2 * sizeof(word_t)) {
+            std::fill(padded.buffer_.begin() + padded.buffered_, padded.buffer_.end(), std::byte{0});
+            padded.compress(padded.buffer_);
+            padded.buffered_ = 0;
+        }
+        std::fill(padded.buffer_.begin() + padded.buffered_, padded.buffer_.end(), std::byte{0});
+        auto size = detail::to_bytes<std::endian::big>(std::array{total_bytes_ * detail::bits_per_byte});
+        std::copy(size.begin(), size.end(), padded.buffer_.end() - size.size());
+        padded.compress(padded.buffer_);
+
+        return detail::final_digest<algorithm_t::digest_bits>(padded.state_);
+    }
+
+    /// Saves the context as a blob of bytes, so that hashing can be checkpointed and resumed later with deserialize,
+    /// perhaps in another process. The blob holds, in big endian byte order, the version of the format, the id of the
+    /// algorithm, the intermediate hash value, the number of bytes added so far, and then the part of the message that
+    /// does not yet fill a whole block. It is at most max_serialized_bytes long.
+    ///
+    /// @returns The blob.
+    constexpr std::vector<std::byte> serialize() const {
+        std::vector<std::byte> blob;
+        auto append = [&](const auto& bytes) { blob.insert(blob.end(), bytes.begin(), bytes.end()); };
+        blob.push_back(std::byte{serialization_version});
+        append(detail::to_bytes<std::endian::big>(std::array{algorithm_t::id}));
+        append(detail::to_bytes<std::endian::big>(state_));
+        append(detail::to_bytes<std::endian::big>(std::array{total_bytes_}));
+        append(std::span(buffer_).first(buffered_));
+        return blob;
+    }
+
+    /// Restores a context saved by serialize. The blob is not authenticated, so one that has been tampered with gives
+    /// the wrong digest rather than an error, unless the change makes it inconsistent.
+    ///
+    /// @param blob The blob.
+    ///
+    /// @returns The context.
+    ///
+    /// @throws std::invalid_argument if the blob is from a different version of the format, is for a different
+    ///         algorithm, or is the wrong size.
+    static constexpr context deserialize(std::span<const std::byte> blob) {
+        if (blob.size() < serialized_header_bytes || blob[0] != std::byte{serialization_version})
+            throw std::invalid_argument("The blob is not a serialized context of a supported version.");
+        constexpr std::size_t id_offset = 1;
+        constexpr std::size_t state_offset = id_offset + sizeof(algorithm_t::id);
+        constexpr std::size_t total_offset = state_offset + sizeof(state_);
+        if (detail::from_bytes<std::endian::big, std::uint16_t>(blob.subspan<id_offset, 2>())[0] != algorithm_t::id)
+            throw std::invalid_argument("The blob is a serialized context of a different algorithm.");
+
+        context ctx;
+        ctx.state_ = detail::from_bytes<std::endian::big, word_t>(blob.subspan<state_offset, sizeof(state_)>());
+        ctx.total_bytes_ = detail::from_bytes<std::endian::big, std::uint64_t>(blob.subspan<total_offset, 8>())[0];
+        ctx.buffered_ = ctx.total_bytes_ % block_bytes;
+        if (blob.size() != serialized_header_bytes + ctx.buffered_)
+            throw std::invalid_argument("The blob is the wrong size for the number of bytes it says were hashed.");
+        std::copy(blob.begin() + serialized_header_bytes, blob.end(), ctx.buffer_.begin());
+        return ctx;
+    }
+
+private:
+    /// Processes whole blocks of the message. At runtime, algorithms that have a faster kernel use it.
+    ///
+    /// @param blocks The blocks, in big endian byte order. The size must be a multiple of the block size.
+    constexpr void compress(std::span<const std::byte> blocks) {
+        if constexpr (requires { algorithm_t::compress_blocks(state_, blocks); }) {
+            if (!std::is_constant_evaluated()) {
+                algorithm_t::compress_blocks(state_, blocks);
+                return;
+            }
+        }
+        for (; !blocks.empty(); blocks = blocks.subspan(block_bytes))
+            algorithm_t::compress(state_, detail::from_bytes<std::endian::big, word_t>(blocks.first<block_bytes>()));
+    }
+
+    /// The intermediate hash value.
+    state_t state_ = algorithm_t::initialization_vector;
+
+    /// The part of the message that does not yet fill a whole block.
+    std::array<std::byte, block_bytes> buffer_{};
+
+    /// The number of bytes in buffer_.
+    std::size_t buffered_ = 0;
+
+    /// The total number of bytes in the message so far.
+    std::uint64_t total_bytes_ = 0;
+};
+
+/// Computes the hashes of a message with several algorithms in a single pass over the message. The message is fed to
+/// every algorithm a chunk at a time, and the chunks are small enough to stay in the L1 cache between algorithms, so
+/// the message is only read from memory once.
+///
+/// @tparam algorithm_ts The algorithms to use, for example ctsha::algorithms::sha1 and ctsha::algorithms::sha256. Each
+///                      may only appear once.
+template <typename... algorithm_ts>
+class multi_hasher {
+public:
+    /// The number of bytes fed to each algorithm at a time.
+    static constexpr std::size_t chunk_bytes = 16384;
+
+    /// Adds more of the message to the hashes.
+    ///
+    /// @param data The next part of the message.
+    ///
+    /// @returns This object, so calls can be chained.
+    constexpr multi_hasher& update(std::span<const std::byte> data) {
+        for (std::size_t count = 0; !data.empty(); data = data.subspan(count)) {
+            count = std::min(data.size(), chunk_bytes);
+            std::apply([&](auto&... contexts) { (contexts.update(data.first(count)), ...); }, contexts_);
+        }
+        return *this;
+    }
+
+    /// Computes the digest of everything added so far with one of the algorithms.
+    ///
+    /// @tparam algorithm_t The algorithm.
+    ///
+    /// @returns The digest.
+    template <typename algorithm_t>
+    constexpr typename context<algorithm_t>::digest_t digest() const {
+        return std::get<context<algorithm_t>>(contexts_).digest();
+    }
+
+    /// Computes the digests of everything added so far with all of the algorithms.
+    ///
+    /// @returns The digests, in the same order as the algorithms.
+    constexpr std::tuple<typename context<algorithm_ts>::digest_t...> digests() const {
+        return {digest<algorithm_ts>()...};
+    }
+
+private:
+    /// The state of each algorithm.
+    std::tuple<context<algorithm_ts>...> contexts_;
+};
+
+/// Computes the hashes of a message with several algorithms in a single pass. See multi_hasher.
+///
+/// @tparam algorithm_ts The algorithms to use.
+///
+/// @param message The message.
+///
+/// @returns The digests, in the same order as the algorithms.
+template <typename... algorithm_ts>
+constexpr std::tuple<typename context<algorithm_ts>::digest_t...> multi_hash(std::span<const std::byte> message) {
+    return multi_hasher<algorithm_ts...>().update(message).digests();
+}
+
+/// Copies a message from one buffer to another while adding it to a hash, so the message is only read from memory once
+/// rather than once to copy it and again to hash it. Each block is copied to the destination with non-temporal stores
+/// where possible (see detail::stream_copy), then hashed while it is still in the L1 cache.
+///
+/// @tparam algorithm_t The algorithm of the context. This parameter is usually deduced.
+///
+/// @param destination Where to copy the message. It must be at least as large as the source.
+/// @param source      The next part of the message.
+/// @param ctx         The context to add the message to.
+///
+/// @returns The context, so calls can be chained.
+///
+/// @throws std::invalid_argument if the destination is smaller than the source.
+template <typename algorithm_t>
+constexpr context<algorithm_t>& copy_and_hash(std::span<std::byte> destination,
+                                              std::span<const std::byte> source,
+                                              context<algorithm_t>& ctx) {
+    if (destination.size() < source.size())
+        throw std::invalid_argument("The destination is smaller than the source.");
+    if (std::is_constant_evaluated()) {
+        std::copy(source.begin(), source.end(), destination.begin());
+        return ctx.update(source);
+    }
+
+    constexpr std::size_t block_bytes = context<algorithm_t>::block_bytes;
+    for (std::size_t offset = 0; offset < source.size(); offset += block_bytes) {
+        auto block = source.subspan(offset, std::min(block_bytes, source.size() - offset));
+        detail::stream_copy(destination.data() + offset, block);
+        ctx.update(block);
+    }
+    detail::stream_fence();
+    return ctx;
+}
+
+/// Computes the SHA-1 hash of a message whose length is not known at compile time.
+///
+/// @param message The message for which the SHA-1 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-1 result.
+constexpr std::array<std::byte, detail::bytes<160>> sha1(std::span<const std::byte> message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha1{}, message.size());
+    if (message.size() <= detail::single_block_bytes<std::uint32_t>)
+        return detail::to_bytes<std::endian::big>(detail::sha1_single_block_state(message));
+    return context<algorithms::sha1>().update(message).digest();
+}
+
+/// Computes the SHA-224 hash of a message whose length is not known at compile time.
+///
+/// @param message The message for which the SHA-224 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-224 result.
+constexpr std::array<std::byte, detail::bytes<224>> sha224(std::span<const std::byte> message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha224{}, message.size());
+    if (message.size() <= detail::single_block_bytes<std::uint32_t>)
+        return detail::final_digest<224>(detail::sha2_single_block_state(message, detail::sha224_initialization_vector,
+                                                                          detail::sha2_32_bit_constants));
+    return context<algorithms::sha224>().update(message).digest();
+}
+
+/// Computes the SHA-256 hash of a message whose length is not known at compile time.
+///
+/// @param message The message for which the SHA-256 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-256 result.
+constexpr std::array<std::byte, detail::bytes<256>> sha256(std::span<const std::byte> message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha256{}, message.size());
+    if (message.size() <= detail::single_block_bytes<std::uint32_t>)
+        return detail::final_digest<256>(detail::sha2_single_block_state(message, detail::sha256_initialization_vector,
+                                                                          detail::sha2_32_bit_constants));
+    return context<algorithms::sha256>().update(message).digest();
+}
+
+/// Computes the SHA-384 hash of a message whose length is not known at compile time.
+///
+/// @param message The message for which the SHA-384 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-384 result.
+constexpr std::array<std::byte, detail::bytes<384>> sha384(std::span<const std::byte> message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha384{}, message.size());
+    if (message.size() <= detail::single_block_bytes<std::uint64_t>)
+        return detail::final_digest<384>(detail::sha2_single_block_state(message, detail::sha384_initialization_vector,
+                                                                          detail::sha2_64_bit_constants));
+    return context<algorithms::sha384>().update(message).digest();
+}
+
+/// Computes the SHA-512 hash of a message whose length is not known at compile time.
+///
+/// @param message The message for which the SHA-512 hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-512 result.
+constexpr std::array<std::byte, detail::bytes<512>> sha512(std::span<const std::byte> message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha512{}, message.size());
+    if (message.size() <= detail::single_block_bytes<std::uint64_t>)
+        return detail::final_digest<512>(detail::sha2_single_block_state(message, detail::sha512_initialization_vector,
+                                                                          detail::sha2_64_bit_constants));
+    return context<algorithms::sha512>().update(message).digest();
+}
+
+/// Computes the SHA-512/t hash of a message whose length is not known at compile time.
+///
+/// @tparam hash_bits The number of bits in the final, truncated hash.
+///
+/// @param message The message for which the SHA-512/t hash is being computed.
+///
+/// @returns An array of bytes representing the SHA-512/t result.
+template <std::size_t hash_bits> requires (hash_bits != 0 && hash_bits != 384 && hash_bits < 512)
+constexpr std::array<std::byte, detail::bytes<hash_bits>> sha512_t(std::span<const std::byte> message) {
+    detail::probe_scope<detail::probe_kind::hash> probe(algorithms::sha512_t<hash_bits>{}, message.size());
+    if (message.size() <= detail::single_block_bytes<std::uint64_t>)
+        return detail::final_digest<hash_bits>(detail::sha2_single_block_state(
+            message, detail::sha512_t_initialization_vector<hash_bits>, detail::sha2_64_bit_constants));
+    return context<algorithms::sha512_t<hash_bits>>().update(message).digest();
+}
+
+/// Computes the double SHA-256 hash of each of a batch of byte arrays that all have the same length. In constant
+/// expressions the messages are hashed several at a time with the multi-buffer functions, which process one message per
+/// lane. At runtime each message goes to the runtime kernels.
+///
+/// @tparam num_bytes The number of bytes in each message for which the double SHA-256 hash is being computed.
+///
+/// @param messages The messages for which the double SHA-256 hash is being computed.
+/// @param digests  Receives the double SHA-256 result for each message, in the same order.
+///
+/// @throws std::invalid_argument if messages and digests are not the same size.
+template <std::size_t num_bytes>
+constexpr void sha256d(std::span<const std::array<std::byte, num_bytes>>   messages,
+                       std::span<std::array<std::byte, detail::bytes<256>>> digests) {
+    detail::probe_scope<detail::probe_kind::batch> probe(algorithms::sha256{}, messages.size_bytes());
+    detail::sha256d(messages, digests);
+}
+
+/// Computes the hash of a message that is split into pieces, such as a header, a payload, and a trailer, as if the
+/// pieces were concatenated. The pieces are fed to a context one after another, so they are never joined into one
+/// buffer, and only the bytes that carry over from one piece to the next to make up a whole block are copied. This
+/// works at compile time too.
+///
+/// @tparam algorithm_t The algorithm to use, for example ctsha::algorithms::sha256.
+/// @tparam parts_t     The types of the pieces. These are usually deduced.
+///
+/// @param parts The pieces of the message, in order.
+///
+/// @returns An array of bytes representing the hash result.
+template <typename algorithm_t, typename... parts_t> requires detail::message_parts<parts_t...>
+constexpr typename context<algorithm_t>::digest_t hash_parts(const parts_t&... parts) {
+    context<algorithm_t> ctx;
+    (ctx.update(std::span<const std::byte>(parts)), ...);
+    return ctx.digest();
+}
+
+/// Computes the SHA-1 hash of a message that is split into pieces. See hash_parts.
+///
+/// @param parts The pieces of the message, in order.
+///
+/// @returns An array of bytes representing the SHA-1 result.
+template <typename... parts_t> requires detail::message_parts<parts_t...>
+constexpr std::array<std::byte, detail::bytes<160>> sha1(const parts_t&... parts) {
+    return hash_parts<algorithms::sha1>(parts...);
+}
+
+/// Computes the SHA-224 hash of a message that is split into pieces. See hash_parts.
+///
+/// @param parts The pieces of the message, in order.
+///
+/// @returns An array of bytes representing the SHA-224 result.
+template <typename... parts_t> requires detail::message_parts<parts_t...>
+constexpr std::array<std::byte, detail::bytes<224>> sha224(const parts_t&... parts) {
+    return hash_parts<algorithms::sha224>(parts...);
+}
+
+/// Computes the SHA-256 hash of a message that is split into pieces. See hash_parts.
+///
+/// @param parts The pieces of the message, in order.
+///
+/// @returns An array of bytes representing the SHA-256 result.
+template <typename... parts_t> requires detail::message_parts<parts_t...>
+constexpr std::array<std::byte, detail::bytes<256>> sha256(const parts_t&... parts) {
+    return hash_parts<algorithms::sha256>(parts...);
+}
+
+/// Computes the SHA-384 hash of a message that is split into pieces. See hash_parts.
+///
+/// @param parts The pieces of the message, in order.
+///
+/// @returns An array of bytes representing the SHA-384 result.
+template <typename... parts_t> requires detail::message_parts<parts_t...>
+constexpr std::array<std::byte, detail::bytes<384>> sha384(const parts_t&... parts) {
+    return hash_parts<algorithms::sha384>(parts...);
+}
+
+/// Computes the SHA-512 hash of a message that is split into pieces. See hash_parts.
+///
+/// @param parts The pieces of the message, in order.
+///
+/// @returns An array of bytes representing the SHA-512 result.
+template <typename... parts_t> requires detail::message_parts<parts_t...>
+constexpr std::array<std::byte, detail::bytes<512>> sha512(const parts_t&... parts) {
+    return hash_parts<algorithms::sha512>(parts...);
+}
+
+/// Computes the SHA-512/t hash of a message that is split into pieces. See hash_parts.
+///
+/// @tparam hash_bits The number of bits in the final, truncated hash.
+///
+/// @param parts The pieces of the message, in order.
+///
+/// @returns An array of bytes representing the SHA-512/t result.
+template <std::size_t hash_bits, typename... parts_t>
+    requires (hash_bits != 0 && hash_bits != 384 && hash_bits < 512 && detail::message_parts<parts_t...>)
+constexpr std::array<std::byte, detail::bytes<hash_bits>> sha512_t(const parts_t&... parts) {
+    return hash_parts<algorithms::sha512_t<hash_bits>>(parts...);
+}
+
+/// Computes the SHA-512/t hash of a message, with t chosen at runtime, for example by a protocol that negotiates the
+/// digest width. The initialization vector for each t is computed once and cached. This is runtime-only.
+///
+/// @param hash_bits The number of bits in the truncated hash.
+/// @param message   The message for which the SHA-512/t hash is being computed.
+/// @param digest    Receives the SHA-512/t result. Must be (hash_bits + 7) / 8 bytes.
+///
+/// @throws std::invalid_argument if hash_bits is zero, 384, or 512 or more, or if digest is the wrong size.
+inline void sha512_t(std::size_t hash_bits, std::span<const std::byte> message, std::span<std::byte> digest) {
+    detail::check_sha512_t_bits(hash_bits);
+    if (digest.size() != (hash_bits + detail::bits_per_byte - 1) / detail::bits_per_byte)
+        throw std::invalid_argument("The digest must hold exactly the truncated hash.");
+    detail::probe_scope<detail::probe_kind::hash> probe(detail::compression_function::sha512,
+                                                        static_cast<std::uint16_t>(0x1000 + hash_bits), message.size());
+
+    // SHA-512/t is SHA-512 from a different initialization vector, truncated.
+    auto iv = detail::sha512_t_initialization_vector_at_runtime(hash_bits);
+    auto full_digest = message.size() <= detail::single_block_bytes<std::uint64_t>
+        ? detail::final_digest<512>(detail::sha2_single_block_state(message, iv, detail::sha2_64_bit_constants))
+        : context<algorithms::sha512>(iv).update(message).digest();
+    std::copy(full_digest.begin(), full_digest.begin() + digest.size(), digest.begin());
+}
+
+/// Computes the SHA-512/t hash of a message, with t chosen at runtime. See the overload that takes a digest span.
+///
+/// @param hash_bits The number of bits in the truncated hash.
+/// @param message   The message for which the SHA-512/t hash is being computed.
+///
+/// @returns The SHA-512/t result, which is (hash_bits + 7) / 8 bytes.
+///
+/// @throws std::invalid_argument if hash_bits is zero, 384, or 512 or more.
+inline std::vector<std::byte> sha512_t(std::size_t hash_bits, std::span<const std::byte> message) {
+    detail::check_sha512_t_bits(hash_bits);
+    std::vector<std::byte> digest((hash_bits + detail::bits_per_byte - 1) / detail::bits_per_byte);
+    sha512_t(hash_bits, message, digest);
+    return digest;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Runtime Kernel Selection                                                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// The groups of runtime kernels, named after the instruction set extensions they use. By default each algorithm uses
+/// the fastest kernel the CPU supports. For testing and benchmarking, a backend can be forced by setting the
+/// CTSHA_BACKEND environment variable to its name (see backend_name) before the first hash, or with set_backend.
+using backend = detail::backend;
+
+/// @param kernels A backend.
+///
+/// @returns The name of the backend, such as "avx2".
+inline std::string_view backend_name(backend kernels) {
+    return detail::backend_names.at(static_cast<std::size_t>(kernels));
+}
+
+/// @param kernels A backend.
+///
+/// @returns Whether the CPU supports the backend.
+inline bool backend_supported(backend kernels) {
+    return detail::backend_supported(kernels);
+}
+
+/// @tparam algorithm_t An algorithm, for example ctsha::algorithms::sha256.
+///
+/// @returns The backend whose kernel the algorithm uses at runtime for long messages. SHA-1 has no runtime kernels, so
+///          it always uses the portable backend.
+template <typename algorithm_t>
+backend active_backend() {
+    if constexpr (std::is_same_v<algorithm_t, algorithms::sha1>)
+        return backend::portable;
+    else if constexpr (std::is_same_v<typename algorithm_t::word_t, std::uint32_t>)
+        return detail::active_kernels().load()->sha256.back().source;
+    else
+        return detail::active_kernels().load()->sha512.back().source;
+}
+
+/// Forces the runtime kernels to come from one backend, or goes back to the fastest ones. This overrides
+/// CTSHA_BACKEND.
+///
+/// @param kernels The backend to use for the algorithms it has kernels for, with the portable backend used for the
+///                rest, or nothing to use the fastest kernels the CPU supports.
+///
+/// @throws std::invalid_argument if the CPU does not support the backend.
+///
+/// @note Every backend gives the same results, so hashes in progress on other threads may safely finish with either
+///       the old or the new kernels.
+inline void set_backend(std::optional<backend> kernels) {
+    if (kernels)
+        detail::check_backend(*kernels);
+    detail::active_kernels().store(&detail::kernel_table(kernels));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Usage Counters                                                                                                     //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// The compression functions that usage is counted for. See usage_counters.
+using compression_function = detail::compression_function;
+
+/// The usage counts of one compression function with one backend.
+using usage_counts = detail::usage_counts_t<std::uint64_t>;
+
+/// The usage counts of every compression function with every backend, added up over every thread.
+struct usage_snapshot {
+    /// The counts, indexed by compression function and then by backend.
+    std::array<std::array<usage_counts, detail::backend_names.size()>, detail::num_compression_functions> counts{};
+
+    /// @param function A compression function.
+    /// @param kernels  A backend.
+    ///
+    /// @returns The counts of the compression function with the backend.
+    const usage_counts& at(compression_function function, backend kernels) const {
+        return counts.at(static_cast<std::size_t>(function)).at(static_cast<std::size_t>(kernels));
+    }
+};
+
+/// Adds up the usage counters of every thread, to show how much hashing has been done at runtime and which kernels did
+/// it. Each thread counts the calls it makes to the compression functions in counters of its own, so counting costs a
+/// few plain stores per call and does not slow down other threads. Every function that hashes at runtime is counted,
+/// including the array overloads, the batch and Merkle tree functions, and the job manager, whose multi-buffer lanes
+/// count one portable call per lane. Only hashing done at compile time is not counted.
+///
+/// @returns The counts so far. This takes no locks, so it can be called while other threads are hashing, in which case
+///          each count is one that its thread had at some point during the call.
+///
+/// @note If CTSHA_COUNTERS is defined to 0, nothing is counted and the counts are all zero.
+inline usage_snapshot usage_counters() {
+    usage_snapshot snapshot;
+#if CTSHA_COUNTERS
+    for (auto* thread = detail::counters_list().load(std::memory_order_acquire); thread != nullptr;
+         thread = thread->next) {
+        for (std::size_t function = 0; function < detail::num_compression_functions; ++function) {
+            for (std::size_t source = 0; source < detail::backend_names.size(); ++source) {
+                const auto& from = thread->counts[function][source];
+                auto& to = snapshot.counts[function][source];
+                to.bytes += from.bytes.load(std::memory_order_relaxed);
+                to.calls += from.calls.load(std::memory_order_relaxed);
+                for (std::size_t bucket = 0; bucket < detail::num_call_size_buckets; ++bucket)
+                    to.calls_by_size[bucket] += from.calls_by_size[bucket].load(std::memory_order_relaxed);
+            }
+        }
+    }
+#endif
+    return snapshot;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Merkle Trees                                                                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Computes the root of a binary Merkle tree over SHA-256 digests. Each parent node is the SHA-256 hash of its left
+/// child followed by its right child. When a level has an odd number of nodes the last one is carried up to the next
+/// level unchanged. The root of a tree with one leaf is the leaf itself, and the root of an empty tree is the SHA-256
+/// hash of an empty message.
+///
+/// Each level is hashed in batches with the multi-buffer functions, and is stored in place in the scratch space.
+///
+/// @param leaves  The leaves of the tree.
+/// @param scratch Space for the upper levels of the tree. Must hold at least half as many digests as there are leaves,
+///                rounded up.
+///
+/// @returns The root of the tree.
+///
+/// @throws std::invalid_argument if the scratch space is too small.
+constexpr std::array<std::byte, detail::bytes<256>>
+merkle_root(std::span<const std::array<std::byte, detail::bytes<256>>> leaves,
+            std::span<std::array<std::byte, detail::bytes<256>>>       scratch) {
+    detail::probe_scope<detail::probe_kind::batch> probe(algorithms::sha256{}, leaves.size_bytes());
+    return detail::merkle_root(leaves, scratch);
+}
+
+/// Computes the root of a binary Merkle tree over SHA-256 digests at compile time. See the other overload of
+/// merkle_root for how the tree is built.
+///
+/// @tparam num_leaves The number of leaves in the tree.
+///
+/// @param leaves The leaves of the tree.
+///
+/// @returns The root of the tree.
+template <std::size_t num_leaves>
+consteval std::array<std::byte, detail::bytes<256>>
+merkle_root(const std::array<std::array<std::byte, detail::bytes<256>>, num_leaves>& leaves) {
+    std::array<std::array<std::byte, detail::bytes<256>>, (num_leaves + 1) / 2> scratch{};
+    return detail::merkle_root(leaves, scratch);
+}
+
+/// The type of the hash of a leaf or node of an RFC 6962 Merkle tree.
+using merkle_digest_t = std::array<std::byte, 32>;
+
+/// Computes the hash of a leaf of an RFC 6962 Merkle tree, which is SHA-256(0x00 || entry). The prefix keeps leaves and
+/// interior nodes from being confused with each other, which merkle_root does not do. (RFC 6962 section 2.1.) These
+/// trees are used by ctsha_merkle_log.hpp and ctsha_tree_hash.hpp.
+///
+/// @param entry The contents of the leaf.
+///
+/// @returns The hash of the leaf.
+constexpr merkle_digest_t merkle_leaf_hash(std::span<const std::byte> entry) {
+    return context<algorithms::sha256>().update(std::array{std::byte{0x00}}).update(entry).digest();
+}
+
+/// Computes the hash of an interior node of an RFC 6962 Merkle tree, which is SHA-256(0x01 || left || right). (RFC 6962
+/// section 2.1.) At runtime the first block is hashed straight from the message by the runtime kernels, and only the
+/// last byte is copied to be padded.
+///
+/// @param left  The hash of the left child.
+/// @param right The hash of the right child.
+///
+/// @returns The hash of the node.
+constexpr merkle_digest_t merkle_node_hash(const merkle_digest_t& left, const merkle_digest_t& right) {
+    std::array<std::byte, 1 + 2 * std::tuple_size_v<merkle_digest_t>> message{std::byte{0x01}};
+    std::copy(left.begin(), left.end(), message.begin() + 1);
+    std::copy(right.begin(), right.end(), message.begin() + 1 + left.size());
+    return sha256(message);
+}
+
 /// This namespace contains operators that allow SHA hashes to be constructed from string literals. Unfortunately, they
 /// use a non-standard literal type (literals with templated parameter packs). Hopefully a standards-compliant way to do
 /// this comes along soon. Use "using namespace ctsha::literals;" to get them into the current namespace, then something
@@ -0,0 +1,266 @@
+/// An optional autotuner for the runtime kernels. Without it, each algorithm uses the kernel from the best backend the
+/// CPU supports for messages of every size, which is a guess: which kernel is fastest depends on the microarchitecture
+/// and on how many blocks the kernel is given at once. The autotuner times the kernel of every supported backend for
+/// each size class (see detail::size_class) and uses the fastest one for each.
+///
+/// Timing the kernels takes a few tens of milliseconds, so the choices are cached in a small text file, one line per
+/// CPU, keyed by the CPU's vendor, family, model, and stepping and the backends it supports. Later runs on the same CPU
+/// read the choices from the file instead of timing the kernels again. This header is runtime-only.
+
+#pragma once
+
+#include "ctsha.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace ctsha {
+
+/// The backends chosen by the autotuner for each size class, smallest first.
+struct tuning {
+    /// The backends for SHA-224 and SHA-256.
+    std::array<backend, detail::num_size_classes> sha256{};
+
+    /// The backends for SHA-384, SHA-512, and SHA-512/t.
+    std::array<backend, detail::num_size_classes> sha512{};
+
+    /// Whether the choices were read from the cache rather than measured.
+    bool from_cache = false;
+};
+
+namespace detail {
+
+/// The number of blocks the kernels are timed with for each size class.
+inline constexpr std::array<std::size_t, num_size_classes> tuning_blocks{1, 4, 64};
+
+/// @returns A string that identifies the CPU, made of its vendor, its family, model, and stepping, and the backends it
+///          supports, separated by dashes. For example "GenuineIntel-000806f8-avx2-avx512-sha_ni".
+inline std::string cpu_signature() {
+    std::ostringstream signature;
+#if defined(CTSHA_X86_KERNELS)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) != 0) {
+        for (unsigned int part : {ebx, edx, ecx})
+            for (std::size_t i = 0; i < 4; ++i)
+                signature << static_cast<char>((part >> (8 * i)) & 0xff);
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0)
+            signature << '-' << std::hex << std::setw(8) << std::setfill('0') << eax;
+    }
+#endif
+    if (signature.str().empty())
+        signature << "unknown";
+    for (std::size_t i = 1; i < backend_names.size(); ++i)
+        if (backend_supported(static_cast<backend>(i)))
+            signature << '-' << backend_names.at(i);
+    return signature.str();
+}
+
+/// Times the kernel of every supported backend that has one for a word size, for each size class.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @returns The backend of the fastest kernel for each size class.
+template <typename word_t> requires sha_word<word_t>
+std::array<backend, num_size_classes> measure_kernels() {
+    constexpr std::size_t block_bytes = sizeof(block_t<word_t>);
+    constexpr std::size_t blocks_per_timing = 4096;
+    std::vector<std::byte> data(tuning_blocks.back() * block_bytes, std::byte{0x5a});
+    std::array<backend, num_size_classes> fastest{};
+    for (std::size_t size = 0; size < num_size_classes; ++size) {
+        auto blocks = std::span<const std::byte>(data).first(tuning_blocks.at(size) * block_bytes);
+        auto fastest_time = std::chrono::steady_clock::duration::max();
+        for (std::size_t i = 0; i < backend_names.size(); ++i) {
+            auto source = static_cast<backend>(i);
+            auto kernel = backend_kernel<word_t>(source);
+            if (!kernel || !backend_supported(source))
+                continue;
+
+            // The best of a few runs, so that an interruption does not count against a kernel.
+            std::array<word_t, 8> state{};
+            for (std::size_t run = 0; run < 3; ++run) {
+                auto start = std::chrono::steady_clock::now();
+                for (std::size_t call = 0; call < blocks_per_timing / tuning_blocks.at(size); ++call)
+                    kernel->compress_blocks(state, blocks);
+                auto time = std::chrono::steady_clock::now() - start;
+                if (time < fastest_time) {
+                    fastest_time = time;
+                    fastest.at(size) = source;
+                }
+            }
+        }
+    }
+    return fastest;
+}
+
+/// Formats the choices for one CPU as a line of the cache file, for example
+/// "GenuineIntel-000806f8-avx2-avx512-sha_ni sha256=sha_ni,sha_ni,sha_ni sha512=avx2,avx512,avx512".
+///
+/// @param signature The signature of the CPU.
+/// @param choices   The choices.
+///
+/// @returns The line, without a newline.
+inline std::string format_tuning(const std::string& signature, const tuning& choices) {
+    std::ostringstream line;
+    auto write = [&](const char* name, const auto& backends) {
+        line << ' ' << name << '=';
+        for (std::size_t i = 0; i < backends.size(); ++i)
+            line << (i == 0 ? "" : ",") << backend_names.at(static_cast<std::size_t>(backends.at(i)));
+    };
+    line << signature;
+    write("sha256", choices.sha256);
+    write("sha512", choices.sha512);
+    return line.str();
+}
+
+/// Parses a line of the cache file.
+///
+/// @param line      The line.
+/// @param signature The signature of the CPU.
+///
+/// @returns The choices, or nothing if the line is for a different CPU, is malformed, or names a backend that the CPU
+///          does not support or that has no kernel for the word size.
+inline std::optional<tuning> parse_tuning(const std::string& line, const std::string& signature) {
+    std::istringstream fields(line);
+    std::string line_signature, sha256, sha512;
+    if (!(fields >> line_signature >> sha256 >> sha512) || line_signature != signature)
+        return std::nullopt;
+
+    auto read = [](const std::string& field, const std::string& name, auto& backends, auto word) -> bool {
+        if (field.rfind(name + "=", 0) != 0)
+            return false;
+        std::istringstream names(field.substr(name.size() + 1));
+        std::string backend_name;
+        std::size_t count = 0;
+        for (; std::getline(names, backend_name, ','); ++count) {
+            auto found = std::find(backend_names.begin(), backend_names.end(), backend_name);
+            if (count >= backends.size() || found == backend_names.end())
+                return false;
+            auto source = static_cast<backend>(found - backend_names.begin());
+            if (!backend_supported(source) || !backend_kernel<decltype(word)>(source))
+                return false;
+            backends.at(count) = source;
+        }
+        return count == backends.size();
+    };
+    tuning choices;
+    choices.from_cache = true;
+    if (!read(sha256, "sha256", choices.sha256, std::uint32_t{}) ||
+        !read(sha512, "sha512", choices.sha512, std::uint64_t{}))
+        return std::nullopt;
+    return choices;
+}
+
+/// Reads the choices for this CPU from the cache file.
+///
+/// @param cache The path of the cache file.
+///
+/// @returns The choices, or nothing if the file does not exist or has no usable line for this CPU.
+inline std::optional<tuning> load_tuning(const std::filesystem::path& cache) {
+    std::ifstream file(cache);
+    auto signature = cpu_signature();
+    for (std::string line; std::getline(file, line);)
+        if (auto choices = parse_tuning(line, signature))
+            return choices;
+    return std::nullopt;
+}
+
+/// Writes the choices for this CPU to the cache file, keeping the lines for other CPUs. The file is written under a
+/// temporary name and then renamed, so a process reading it at the same time never sees half a file. The cache is only
+/// there to save time, so any errors are ignored.
+///
+/// @param cache   The path of the cache file.
+/// @param choices The choices.
+inline void save_tuning(const std::filesystem::path& cache, const tuning& choices) {
+    auto signature = cpu_signature();
+    std::vector<std::string> lines;
+    {
+        std::ifstream file(cache);
+        for (std::string line; std::getline(file, line);)
+            if (line.rfind(signature + " ", 0) != 0)
+                lines.push_back(line);
+    }
+    lines.push_back(format_tuning(signature, choices));
+
+    std::error_code error;
+    if (cache.has_parent_path())
+        std::filesystem::create_directories(cache.parent_path(), error);
+    auto temporary = cache;
+    temporary += ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream file(temporary);
+        for (const auto& line : lines)
+            file << line << '\n';
+        file.flush();
+        if (!file)
+            error = std::make_error_code(std::errc::io_error);
+    }
+    if (!error)
+        std::filesystem::rename(temporary, cache, error);
+    if (error)
+        std::filesystem::remove(temporary, error);
+}
+
+/// Builds the kernel table for a set of choices.
+///
+/// @param choices The choices.
+///
+/// @returns The kernels.
+inline kernel_table_t tuned_kernel_table(const tuning& choices) {
+    kernel_table_t kernels;
+    for (std::size_t size = 0; size < num_size_classes; ++size) {
+        kernels.sha256.at(size) = backend_kernel<std::uint32_t>(choices.sha256.at(size)).value();
+        kernels.sha512.at(size) = backend_kernel<std::uint64_t>(choices.sha512.at(size)).value();
+    }
+    return kernels;
+}
+
+} // End namespace detail.
+
+/// Finds the default path of the autotuner's cache file. This is the CTSHA_AUTOTUNE_CACHE environment variable if it
+/// is set, otherwise ctsha-autotune in $XDG_CACHE_HOME, otherwise .cache/ctsha-autotune in $HOME.
+///
+/// @returns The path, or nothing if none of the environment variables are set, in which case nothing is cached.
+inline std::optional<std::filesystem::path> default_autotune_cache() {
+    if (const char* path = std::getenv("CTSHA_AUTOTUNE_CACHE"); path != nullptr && *path != '\0')
+        return std::filesystem::path(path);
+    if (const char* path = std::getenv("XDG_CACHE_HOME"); path != nullptr && *path != '\0')
+        return std::filesystem::path(path) / "ctsha-autotune";
+    if (const char* path = std::getenv("HOME"); path != nullptr && *path != '\0')
+        return std::filesystem::path(path) / ".cache" / "ctsha-autotune";
+    return std::nullopt;
+}
+
+/// Chooses the fastest kernel for each size class, and uses those kernels from now on. The first call reads the
+/// choices from the cache file, or times the kernels and writes the choices to the cache file if it has none for this
+/// CPU. Later calls reuse the choices from the first call. Call this once at startup, before hashing anything large.
+///
+/// @param cache The path of the cache file, or nothing to always time the kernels. Only the first call uses this.
+///
+/// @returns The choices.
+///
+/// @note If the CTSHA_BACKEND environment variable is set, the kernels it forces are left in use, so that tests and
+///       benchmarks of a backend still work in programs that call this. A later call to set_backend also replaces the
+///       tuned kernels until this is called again.
+inline const tuning& autotune(std::optional<std::filesystem::path> cache = default_autotune_cache()) {
+    static const auto tuned = [&]() {
+        std::optional<tuning> choices;
+        if (cache)
+            choices = detail::load_tuning(*cache);
+        if (!choices) {
+            choices = tuning{detail::measure_kernels<std::uint32_t>(), detail::measure_kernels<std::uint64_t>()};
+            if (cache)
+                detail::save_tuning(*cache, *choices);
+        }
+        return std::pair{*choices, detail::tuned_kernel_table(*choices)};
+    }();
+    if (const char* forced = std::getenv("CTSHA_BACKEND"); forced == nullptr || *forced == '\0')
+        detail::active_kernels().store(&tuned.second);
+    return tuned.first;
+}
+
+} // End namespace ctsha.
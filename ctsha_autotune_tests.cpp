@@ -0,0 +1,88 @@
+/// Runtime tests for ctsha_autotune.hpp. The autotuner is run with a cache file in a temporary directory, and the tests
+/// check the choices it makes, what it writes to the cache, that the cache is read back, and that the tuned kernels
+/// give the right results.
+#include "ctsha_autotune.hpp"
+#include "ctsha_tests.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// The message sizes the digests are checked with, which cover every size class.
+const std::vector<std::size_t> message_sizes{0, 100, 300, 1000, 5000, 100000};
+
+/// Hashes messages of every size class with SHA-256 and SHA-512.
+///
+/// @returns The digests, as strings of bytes.
+std::vector<std::string> digests() {
+    std::vector<std::string> result;
+    for (std::size_t size : message_sizes) {
+        auto data = test_data(size);
+        auto sha256 = ctsha::context<ctsha::algorithms::sha256>().update(data).digest();
+        auto sha512 = ctsha::context<ctsha::algorithms::sha512>().update(data).digest();
+        result.emplace_back(reinterpret_cast<const char*>(sha256.data()), sha256.size());
+        result.emplace_back(reinterpret_cast<const char*>(sha512.data()), sha512.size());
+    }
+    return result;
+}
+
+} // End anonymous namespace.
+
+int main() {
+    auto now = std::chrono::system_clock::now().time_since_epoch().count();
+    auto directory = std::filesystem::temp_directory_path() / ("ctsha-autotune-tests-" + std::to_string(now));
+    try {
+        ctsha::set_backend(ctsha::backend::portable);
+        auto expected = digests();
+        ctsha::set_backend(std::nullopt);
+
+        // Another CPU's line must be kept when this CPU's line is written.
+        auto cache = directory / "cache";
+        std::filesystem::create_directories(directory);
+        const std::string all_portable = " sha256=portable,portable,portable sha512=portable,portable,portable";
+        std::ofstream(cache) << "OtherVendor-00000001" << all_portable << "\n";
+
+        const auto& choices = ctsha::autotune(cache);
+        check(!choices.from_cache, "first run measures the kernels");
+        for (std::size_t size = 0; size < ctsha::detail::num_size_classes; ++size) {
+            check(ctsha::backend_supported(choices.sha256.at(size)), "supported SHA-256 backend");
+            check(ctsha::backend_supported(choices.sha512.at(size)), "supported SHA-512 backend");
+        }
+        check(ctsha::active_backend<ctsha::algorithms::sha256>() == choices.sha256.back(), "tuned SHA-256 backend");
+        check(ctsha::active_backend<ctsha::algorithms::sha384>() == choices.sha512.back(), "tuned SHA-384 backend");
+        check(digests() == expected, "digests with the tuned kernels");
+        check(&ctsha::autotune(cache) == &choices, "later calls reuse the choices");
+
+        auto cached = ctsha::detail::load_tuning(cache);
+        check(cached && cached->from_cache, "cache is read back");
+        check(cached && cached->sha256 == choices.sha256 && cached->sha512 == choices.sha512, "cached choices");
+        std::ifstream file(cache);
+        std::string line;
+        check(std::getline(file, line) && line.rfind("OtherVendor-00000001 ", 0) == 0, "other CPUs are kept");
+        check(std::getline(file, line) && line == ctsha::detail::format_tuning(ctsha::detail::cpu_signature(), choices),
+              "this CPU's line");
+
+        // Lines that are malformed or that name backends that cannot be used are ignored.
+        auto signature = ctsha::detail::cpu_signature();
+        check(!ctsha::detail::parse_tuning(signature + " sha256=portable sha512=portable", signature), "too few");
+        check(ctsha::detail::parse_tuning(signature + all_portable, signature).has_value(), "all portable");
+        check(!ctsha::detail::parse_tuning("OtherVendor-00000001" + all_portable, signature), "other CPU");
+        check(!ctsha::detail::parse_tuning(signature + " sha256=sse9,avx2,avx2 sha512=avx2,avx2,avx2", signature),
+              "unknown backend");
+        check(!ctsha::detail::parse_tuning(signature + " sha256=avx512,avx512,avx512 sha512=avx2,avx2,avx2",
+                                           signature), "backend without a kernel");
+        check(!ctsha::detail::parse_tuning(signature + " sha256=portable,portable,portable", signature), "truncated");
+        check(!ctsha::detail::load_tuning(directory / "missing"), "missing cache");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ++failures;
+    }
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+
+    std::cout << "Autotune tests " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
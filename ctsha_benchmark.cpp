@@ -0,0 +1,468 @@
+/// Measures how fast the hash functions run at runtime, and writes the results as JSON so they can be compared between
+/// versions to catch regressions. There are two sets of measurements:
+///
+/// - "hash": every algorithm (SHA-1, SHA-224, SHA-256, SHA-384, SHA-512, SHA-512/224, and SHA-512/256) with every
+///   backend the CPU supports, hashing messages from 0 bytes to 1 GiB with the functions that take a span. Each result
+///   has the time per call, the throughput, and the cycles per byte.
+/// - "threads": how the batch version of sha256d (many 80-byte messages) and the tree hash of ctsha_tree_hash.hpp (one
+///   large object split into shards) scale with the number of threads. The total work is the same for every number of
+///   threads, so the speedup is the time with one thread divided by the time with this many.
+///
+/// Cycles are counted with perf_event_open where the kernel allows it (see /proc/sys/kernel/perf_event_paranoid),
+/// which also gives the instructions per cycle. Otherwise, on x86-64, they are counted with the time stamp counter,
+/// which ticks at a fixed rate that can differ from the core clock, so treat those figures with care. The "cycles"
+/// field of the output says which was used.
+///
+/// Usage: ctsha_benchmark [--max-bytes N] [--min-time SECONDS] [--max-threads N] [--output FILE]
+///
+/// --max-bytes   The largest message to hash, which defaults to 1 GiB. The tree hash object is at most 256 MiB.
+/// --min-time    How long to repeat each measurement for, which defaults to 0.2 seconds.
+/// --max-threads The most threads to use, which defaults to the number of hardware threads.
+/// --output      Where to write the JSON, which defaults to the standard output. Progress goes to the standard error.
+#include "ctsha_autotune.hpp"
+#include "ctsha_tree_hash.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// The settings given on the command line.
+struct options {
+    /// The largest message to hash.
+    std::size_t max_bytes = std::size_t{1} << 30;
+
+    /// How long to repeat each measurement for, in seconds.
+    double min_seconds = 0.2;
+
+    /// The most threads to use.
+    std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    /// Where to write the JSON, or empty for the standard output.
+    std::string output;
+};
+
+/// The message sizes to measure, including the sizes either side of the single block limits (55 and 111 bytes) and
+/// the block sizes.
+constexpr std::array<std::size_t, 18> message_sizes{
+    0, 1, 16, 55, 56, 64, 111, 112, 128, 256, 1024, 4096, 16384, std::size_t{1} << 16,
+    std::size_t{1} << 20, std::size_t{1} << 24, std::size_t{1} << 28, std::size_t{1} << 30,
+};
+
+/// The cycle and instruction counts of the calling thread at some point in time.
+struct counter_reading {
+    /// The number of cycles.
+    std::uint64_t cycles = 0;
+
+    /// The number of instructions, if they are being counted.
+    std::optional<std::uint64_t> instructions;
+};
+
+/// Counts the cycles and instructions run by the calling thread, in user space only. perf_event_open is used if the
+/// kernel allows it, and the time stamp counter otherwise.
+class cycle_counter {
+public:
+    /// Opens the hardware counters if possible.
+    cycle_counter() {
+#if __has_include(<linux/perf_event.h>)
+        auto open = [](std::uint64_t config, int group) {
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.config = config;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_GROUP;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, group, 0));
+        };
+        cycles_fd_ = open(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (cycles_fd_ >= 0)
+            instructions_fd_ = open(PERF_COUNT_HW_INSTRUCTIONS, cycles_fd_);
+#endif
+    }
+
+    cycle_counter(const cycle_counter&) = delete;
+    cycle_counter& operator=(const cycle_counter&) = delete;
+
+    /// Closes the hardware counters.
+    ~cycle_counter() {
+#if __has_include(<linux/perf_event.h>)
+        for (int fd : {instructions_fd_, cycles_fd_})
+            if (fd >= 0)
+                close(fd);
+#endif
+    }
+
+    /// @returns How cycles are counted: "perf", "tsc", or "none" if they are not.
+    std::string source() const {
+        if (cycles_fd_ >= 0)
+            return "perf";
+#if defined(__x86_64__)
+        return "tsc";
+#else
+        return "none";
+#endif
+    }
+
+    /// @returns The counts so far, or nothing if cycles are not counted.
+    std::optional<counter_reading> read() const {
+#if __has_include(<linux/perf_event.h>)
+        if (cycles_fd_ >= 0) {
+            // With PERF_FORMAT_GROUP, the leader reads the number of counters followed by each counter's value.
+            std::array<std::uint64_t, 3> values{};
+            if (::read(cycles_fd_, values.data(), sizeof(values)) < static_cast<ssize_t>(2 * sizeof(std::uint64_t)))
+                return std::nullopt;
+            counter_reading reading{values.at(1), std::nullopt};
+            if (values.at(0) == 2)
+                reading.instructions = values.at(2);
+            return reading;
+        }
+#endif
+#if defined(__x86_64__)
+        return counter_reading{__rdtsc(), std::nullopt};
+#else
+        return std::nullopt;
+#endif
+    }
+
+private:
+    /// The file descriptor of the cycle counter, which leads the group, or -1.
+    int cycles_fd_ = -1;
+
+    /// The file descriptor of the instruction counter, or -1.
+    int instructions_fd_ = -1;
+};
+
+/// The result of timing a function.
+struct measurement {
+    /// The number of calls timed.
+    std::uint64_t calls = 0;
+
+    /// The time taken by all of the calls, in seconds.
+    double seconds = 0;
+
+    /// The cycles taken by all of the calls, if they were counted.
+    std::optional<std::uint64_t> cycles;
+
+    /// The instructions run by all of the calls, if they were counted.
+    std::optional<std::uint64_t> instructions;
+};
+
+/// Keeps the results of the functions being timed, so the compiler cannot leave the calls out.
+volatile std::byte sink{};
+
+/// Calls a function repeatedly until the minimum time has passed. The clock is read after runs of calls that double
+/// in length, so reading it does not slow down the calls of fast functions.
+///
+/// @param function    The function, which returns some bytes.
+/// @param min_seconds The minimum time.
+/// @param counter     Counts the cycles.
+/// @param warm_up     Whether to make one call before starting the clock.
+///
+/// @returns The measurement.
+template <typename function_t>
+measurement measure(function_t&& function, double min_seconds, const cycle_counter& counter, bool warm_up = true) {
+    if (warm_up)
+        sink = function()[0];
+
+    measurement result;
+    auto start_counts = counter.read();
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t run = 1;; run *= 2) {
+        for (std::uint64_t call = 0; call < run; ++call)
+            sink = function()[0];
+        result.calls += run;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (result.seconds >= min_seconds)
+            break;
+    }
+    auto end_counts = counter.read();
+    if (start_counts && end_counts) {
+        result.cycles = end_counts->cycles - start_counts->cycles;
+        if (start_counts->instructions && end_counts->instructions)
+            result.instructions = *end_counts->instructions - *start_counts->instructions;
+    }
+    return result;
+}
+
+/// Formats a number for JSON, which has no infinities or NaNs.
+///
+/// @param value The number.
+///
+/// @returns The number, or null if it is not finite.
+std::string json_number(std::optional<double> value) {
+    if (!value || !std::isfinite(*value))
+        return "null";
+    std::ostringstream text;
+    text.precision(6);
+    text << *value;
+    return text.str();
+}
+
+/// Times one algorithm with every backend that has a kernel for it, over every message size.
+///
+/// @tparam algorithm_t The algorithm, for example ctsha::algorithms::sha256.
+///
+/// @param name     The name of the algorithm in the output.
+/// @param hash     The function that hashes a span with the algorithm.
+/// @param message  A buffer as large as the largest message.
+/// @param settings The settings.
+/// @param counter  Counts the cycles.
+/// @param results  Receives a JSON object for each measurement.
+template <typename algorithm_t, typename hash_t>
+void benchmark_algorithm(const std::string& name, hash_t hash, std::span<const std::byte> message,
+                         const options& settings, const cycle_counter& counter, std::vector<std::string>& results) {
+    for (std::size_t i = 0; i < ctsha::detail::backend_names.size(); ++i) {
+        auto kernels = static_cast<ctsha::backend>(i);
+        if (!ctsha::backend_supported(kernels))
+            continue;
+
+        // A backend without a kernel for this algorithm falls back to the portable one, which is measured anyway.
+        ctsha::set_backend(kernels);
+        if (ctsha::active_backend<algorithm_t>() != kernels)
+            continue;
+
+        for (std::size_t bytes : message_sizes) {
+            if (bytes > settings.max_bytes)
+                break;
+            std::cerr << name << " " << ctsha::backend_name(kernels) << " " << bytes << " bytes" << std::endl;
+
+            // The largest messages take long enough that warming up would only waste time.
+            auto part = message.first(bytes);
+            auto result = measure([&]() { return hash(part); }, settings.min_seconds, counter, bytes < (1 << 24));
+            double calls = static_cast<double>(result.calls);
+            auto per_byte = [&](std::optional<std::uint64_t> count) -> std::optional<double> {
+                if (!count || bytes == 0)
+                    return std::nullopt;
+                return static_cast<double>(*count) / (calls * static_cast<double>(bytes));
+            };
+            auto ratio = [](std::optional<std::uint64_t> numerator,
+                            std::optional<std::uint64_t> denominator) -> std::optional<double> {
+                if (!numerator || !denominator || *denominator == 0)
+                    return std::nullopt;
+                return static_cast<double>(*numerator) / static_cast<double>(*denominator);
+            };
+
+            std::ostringstream json;
+            json << "{\"algorithm\": \"" << name << "\", \"backend\": \"" << ctsha::backend_name(kernels)
+                 << "\", \"bytes\": " << bytes << ", \"calls\": " << result.calls
+                 << ", \"ns_per_call\": " << json_number(result.seconds * 1e9 / calls)
+                 << ", \"bytes_per_second\": " << json_number(static_cast<double>(bytes) * calls / result.seconds)
+                 << ", \"cycles_per_call\": "
+                 << json_number(result.cycles ? std::optional(static_cast<double>(*result.cycles) / calls)
+                                              : std::nullopt)
+                 << ", \"cycles_per_byte\": " << json_number(per_byte(result.cycles))
+                 << ", \"instructions_per_cycle\": " << json_number(ratio(result.instructions, result.cycles)) << "}";
+            results.push_back(json.str());
+        }
+    }
+    ctsha::set_backend(std::nullopt);
+}
+
+/// Runs a job split between several threads, repeatedly until the minimum time has passed.
+///
+/// @param num_threads The number of threads.
+/// @param min_seconds The minimum time.
+/// @param job         The job, which is called on each thread with the index of the thread.
+/// @param finish      Called on the calling thread after the threads of each run have finished.
+///
+/// @returns The average time of a run, in seconds.
+double time_threads(std::size_t num_threads, double min_seconds, const std::function<void(std::size_t)>& job,
+                    const std::function<void()>& finish) {
+    std::size_t runs = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        std::vector<std::thread> threads;
+        for (std::size_t thread = 0; thread < num_threads; ++thread)
+            threads.emplace_back(job, thread);
+        for (auto& thread : threads)
+            thread.join();
+        finish();
+        ++runs;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < min_seconds);
+    return seconds / static_cast<double>(runs);
+}
+
+/// Measures how the batch version of sha256d and the tree hash scale with the number of threads.
+///
+/// @param message  A buffer to take the messages from.
+/// @param settings The settings.
+/// @param results  Receives a JSON object for each measurement.
+void benchmark_threads(std::span<const std::byte> message, const options& settings,
+                       std::vector<std::string>& results) {
+    constexpr std::size_t header_bytes = 80;
+    constexpr std::size_t num_headers = 1 << 16;
+    constexpr std::size_t chunk_bytes = 4096;
+    std::vector<std::array<std::byte, header_bytes>> headers(num_headers);
+    for (std::size_t i = 0; i < headers.size(); ++i)
+        for (std::size_t j = 0; j < header_bytes; ++j)
+            headers.at(i).at(j) = static_cast<std::byte>(i * 7 + j);
+    std::vector<std::array<std::byte, 32>> digests(num_headers);
+    auto object = message.first(std::min(message.size(), std::size_t{1} << 28));
+
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads = 1; threads < settings.max_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(settings.max_threads);
+
+    // Each thread takes an equal share of the work, which for the tree hash must start on a chunk boundary.
+    auto share = [](std::size_t total, std::size_t unit, std::size_t num_threads, std::size_t thread) {
+        std::size_t units = (total + unit - 1) / unit;
+        auto boundary = [&](std::size_t index) { return std::min(total, units * index / num_threads * unit); };
+        return std::pair{boundary(thread), boundary(thread + 1)};
+    };
+
+    for (std::string mode : {"batch_sha256d", "tree_hash"}) {
+        double single_thread_seconds = 0;
+        for (std::size_t num_threads : thread_counts) {
+            std::cerr << mode << " with " << num_threads << " threads" << std::endl;
+            double seconds = 0;
+            std::size_t bytes = 0;
+            if (mode == "batch_sha256d") {
+                bytes = num_headers * header_bytes;
+                seconds = time_threads(num_threads, settings.min_seconds, [&](std::size_t thread) {
+                    auto [begin, end] = share(num_headers, 1, num_threads, thread);
+                    ctsha::sha256d(std::span<const std::array<std::byte, header_bytes>>(headers).subspan(begin,
+                                                                                                      end - begin),
+                                   std::span(digests).subspan(begin, end - begin));
+                }, [&]() { sink = digests.back()[0]; });
+            } else {
+                bytes = object.size();
+                std::vector<ctsha::shard_digest<chunk_bytes>> shards(num_threads);
+                seconds = time_threads(num_threads, settings.min_seconds, [&](std::size_t thread) {
+                    auto [begin, end] = share(object.size(), chunk_bytes, num_threads, thread);
+                    shards.at(thread) = ctsha::shard_digest<chunk_bytes>::hash(begin, object.subspan(begin,
+                                                                                                   end - begin));
+                }, [&]() {
+                    auto whole = shards.front();
+                    for (std::size_t thread = 1; thread < num_threads; ++thread)
+                        whole = ctsha::combine(whole, shards.at(thread));
+                    sink = whole.root()[0];
+                });
+            }
+            if (num_threads == 1)
+                single_thread_seconds = seconds;
+
+            std::ostringstream json;
+            json << "{\"mode\": \"" << mode << "\", \"threads\": " << num_threads << ", \"bytes\": " << bytes
+                 << ", \"seconds\": " << json_number(seconds)
+                 << ", \"bytes_per_second\": " << json_number(static_cast<double>(bytes) / seconds)
+                 << ", \"speedup\": " << json_number(single_thread_seconds / seconds) << "}";
+            results.push_back(json.str());
+        }
+    }
+}
+
+/// Parses the command line.
+///
+/// @param argc The number of arguments.
+/// @param argv The arguments.
+///
+/// @returns The settings.
+///
+/// @throws std::invalid_argument if an argument is not recognized or has a bad value.
+options parse_options(int argc, char** argv) {
+    options settings;
+    for (int i = 1; i < argc; ++i) {
+        std::string name = argv[i];
+        if (i + 1 == argc)
+            throw std::invalid_argument("Missing value for " + name + ".");
+        std::string value = argv[++i];
+        if (name == "--max-bytes")
+            settings.max_bytes = std::stoull(value);
+        else if (name == "--min-time")
+            settings.min_seconds = std::stod(value);
+        else if (name == "--max-threads")
+            settings.max_threads = std::max<std::size_t>(1, std::stoull(value));
+        else if (name == "--output")
+            settings.output = value;
+        else
+            throw std::invalid_argument("Unknown option " + name + ".");
+    }
+    return settings;
+}
+
+} // End anonymous namespace.
+
+int main(int argc, char** argv) {
+    options settings;
+    try {
+        settings = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl << "Usage: " << argv[0]
+                  << " [--max-bytes N] [--min-time SECONDS] [--max-threads N] [--output FILE]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::vector<std::byte> message(std::min(settings.max_bytes, message_sizes.back()));
+        for (std::size_t i = 0; i < message.size(); ++i)
+            message.at(i) = static_cast<std::byte>(i % 251);
+
+        cycle_counter counter;
+        std::vector<std::string> hashes;
+        benchmark_algorithm<ctsha::algorithms::sha1>(
+            "sha1", [](auto m) { return ctsha::sha1(m); }, message, settings, counter, hashes);
+        benchmark_algorithm<ctsha::algorithms::sha224>(
+            "sha224", [](auto m) { return ctsha::sha224(m); }, message, settings, counter, hashes);
+        benchmark_algorithm<ctsha::algorithms::sha256>(
+            "sha256", [](auto m) { return ctsha::sha256(m); }, message, settings, counter, hashes);
+        benchmark_algorithm<ctsha::algorithms::sha384>(
+            "sha384", [](auto m) { return ctsha::sha384(m); }, message, settings, counter, hashes);
+        benchmark_algorithm<ctsha::algorithms::sha512>(
+            "sha512", [](auto m) { return ctsha::sha512(m); }, message, settings, counter, hashes);
+        benchmark_algorithm<ctsha::algorithms::sha512_t<224>>(
+            "sha512_224", [](auto m) { return ctsha::sha512_t<224>(m); }, message, settings, counter, hashes);
+        benchmark_algorithm<ctsha::algorithms::sha512_t<256>>(
+            "sha512_256", [](auto m) { return ctsha::sha512_t<256>(m); }, message, settings, counter, hashes);
+
+        std::vector<std::string> threads;
+        benchmark_threads(message, settings, threads);
+
+        std::ofstream file;
+        if (!settings.output.empty()) {
+            file.open(settings.output);
+            if (!file)
+                throw std::runtime_error("Could not open " + settings.output + ".");
+        }
+        std::ostream& out = settings.output.empty() ? std::cout : file;
+        auto write_list = [&](const std::vector<std::string>& items) {
+            for (std::size_t i = 0; i < items.size(); ++i)
+                out << "    " << items.at(i) << (i + 1 < items.size() ? ",\n" : "\n");
+        };
+        out << "{\n  \"cpu\": \"" << ctsha::detail::cpu_signature() << "\",\n  \"cycles\": \"" << counter.source()
+            << "\",\n  \"hash\": [\n";
+        write_list(hashes);
+        out << "  ],\n  \"threads\": [\n";
+        write_list(threads);
+        out << "  ]\n}\n";
+        if (!out)
+            throw std::runtime_error("Could not write the results.");
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,278 @@
+/// A multi-buffer job manager for the SHA-2 algorithms, which hashes a stream of messages of any lengths a lane's worth
+/// at a time. The static batch functions (such as the batch version of sha256d) need every message in a batch to have
+/// the same length, and hashing messages of different lengths side by side would leave the lanes of the short messages
+/// idle until the longest one is done. Instead, the job manager gives each lane its own message, and as soon as one
+/// message is done, the next waiting message takes over its lane, so the lanes stay busy under a mix of sizes.
+///
+/// The lanes only run in step when several of them can be processed together: with the interleaved SHA extensions
+/// kernel for SHA-224 and SHA-256, or with the portable multi-buffer functions when the portable backend is in use.
+/// With the other runtime kernels, which work on one message at a time, each job is simply finished in one go.
+///
+/// Jobs are submitted with submit, and their digests are collected in the order they were submitted with pop. The
+/// lanes only run once they are all full, so call flush to finish the jobs in partially filled lanes, for example at
+/// the end of a batch of work. This header is runtime-only.
+
+#pragma once
+
+#include "ctsha.hpp"
+
+#include <deque>
+#include <optional>
+
+namespace ctsha {
+
+/// Hashes a stream of messages of any lengths with the multi-buffer functions. See the top of this file.
+///
+/// @tparam algorithm_t The algorithm to use, which must be one of the SHA-2 algorithms, for example
+///                     ctsha::algorithms::sha256.
+template <typename algorithm_t>
+    requires (std::tuple_size_v<std::remove_const_t<decltype(algorithm_t::initialization_vector)>> == 8)
+class job_manager {
+public:
+    /// The type of words used by the algorithm.
+    using word_t = typename algorithm_t::word_t;
+
+    /// The type of the digest produced by the algorithm.
+    using digest_t = typename context<algorithm_t>::digest_t;
+
+    /// The number of bytes in a block.
+    static constexpr std::size_t block_bytes = context<algorithm_t>::block_bytes;
+
+    /// The number of messages that are hashed side by side.
+    static constexpr std::size_t num_lanes = detail::sha2_lanes;
+
+    /// The result of a job.
+    struct completed_job {
+        /// The id that submit returned for the job.
+        std::uint64_t id;
+
+        /// The digest of the message.
+        digest_t digest;
+    };
+
+    /// Submits a message to be hashed. If this fills the last free lane, the lanes run until at least one of them is
+    /// free again, so some jobs may be completed before this returns.
+    ///
+    /// @param message The message. It is not copied, so it must stay valid until the job has completed.
+    ///
+    /// @returns The id of the job. Jobs are numbered from zero in the order they are submitted.
+    std::uint64_t submit(std::span<const std::byte> message) {
+        std::uint64_t id = first_result_id_ + results_.size();
+        results_.emplace_back();
+        waiting_.push_back({id, message});
+        run(false);
+        return id;
+    }
+
+    /// Completes every job that has been submitted, even if that means running with some lanes empty.
+    void flush() {
+        run(true);
+    }
+
+    /// Collects the result of the oldest job that has not been collected yet. Results are collected in the order the
+    /// jobs were submitted, so a completed job waits until every job submitted before it has been collected.
+    ///
+    /// @returns The result, or nothing if the oldest job has not completed yet.
+    std::optional<completed_job> pop() {
+        if (results_.empty() || !results_.front())
+            return std::nullopt;
+        completed_job job{first_result_id_++, *results_.front()};
+        results_.pop_front();
+        return job;
+    }
+
+private:
+    /// A job that has not been given a lane yet.
+    struct waiting_job {
+        /// The id of the job.
+        std::uint64_t id;
+
+        /// The message.
+        std::span<const std::byte> message;
+    };
+
+    /// The progress of the job in one lane.
+    struct lane_t {
+        /// Whether the lane has a job.
+        bool active = false;
+
+        /// The id of the job.
+        std::uint64_t id = 0;
+
+        /// The message.
+        std::span<const std::byte> message;
+
+        /// The number of blocks that have been processed.
+        std::size_t blocks_done = 0;
+
+        /// The number of blocks in the padded message.
+        std::size_t num_blocks = 0;
+
+        /// The last one or two blocks of the padded message, which hold the end of the message that does not fill a
+        /// whole block followed by the padding. (FIPS 180-4 section 5.1.)
+        std::array<std::byte, 2 * block_bytes> tail{};
+    };
+
+    /// Puts waiting jobs in free lanes, and runs the lanes until no more jobs can be started.
+    ///
+    /// @param drain Whether to run the lanes even if some of them are empty, until every job has completed.
+    void run(bool drain) {
+        for (;;) {
+            std::size_t num_active = 0;
+            for (std::size_t lane = 0; lane < num_lanes; ++lane) {
+                if (!lanes_.at(lane).active && !waiting_.empty()) {
+                    start(lane, waiting_.front());
+                    waiting_.pop_front();
+                }
+                num_active += lanes_.at(lane).active ? 1 : 0;
+            }
+            if (num_active == 0 || (!drain && num_active < num_lanes))
+                return;
+            advance();
+        }
+    }
+
+    /// Gives a job a lane, and prepares the padded end of its message.
+    ///
+    /// @param lane The index of a free lane.
+    /// @param job  The job.
+    void start(std::size_t lane, const waiting_job& job) {
+        auto& state = lanes_.at(lane);
+        std::size_t whole_blocks = job.message.size() / block_bytes;
+        std::size_t tail_bytes = job.message.size() % block_bytes;
+
+        // As in context::digest, only 64 bits of length are supported even though the 64-bit word algorithms allow 128
+        // bits. The length goes at the very end of the tail, which is one block long unless it does not fit.
+        std::size_t tail_blocks = (tail_bytes + 1 + 2 * sizeof(word_t) > block_bytes) ? 2 : 1;
+        state.tail.fill(std::byte{0});
+        std::copy(job.message.end() - tail_bytes, job.message.end(), state.tail.begin());
+        state.tail.at(tail_bytes) = std::byte{0b10000000};
+        auto size = detail::to_bytes<std::endian::big>(std::array{std::uint64_t{job.message.size()} * 8});
+        std::copy(size.begin(), size.end(), state.tail.begin() + tail_blocks * block_bytes - size.size());
+
+        state.active = true;
+        state.id = job.id;
+        state.message = job.message;
+        state.blocks_done = 0;
+        state.num_blocks = whole_blocks + tail_blocks;
+        states_.at(lane) = algorithm_t::initialization_vector;
+    }
+
+    /// Whether the lanes run in step. See the top of this file.
+    ///
+    /// @returns True if the blocks of several lanes are processed together by the active backend.
+    static bool in_step() {
+        backend source = active_backend<algorithm_t>();
+        return source == backend::sha_ni || source == backend::portable;
+    }
+
+    /// Runs the lanes until at least one job has completed, and records the results of the jobs that completed.
+    void advance() {
+        bool lanes_in_step = in_step();
+        for (std::size_t lane = 0; lane < num_lanes && !lanes_in_step; ++lane) {
+            // Each job goes through the runtime kernel on its own in two calls: the rest of the whole blocks of the
+            // message, then the rest of the tail.
+            auto& state = lanes_.at(lane);
+            if (!state.active)
+                continue;
+            std::size_t whole_blocks = state.message.size() / block_bytes;
+            std::size_t whole_done = std::min(state.blocks_done, whole_blocks);
+            std::size_t tail_done = state.blocks_done - whole_done;
+            auto message = state.message.first(whole_blocks * block_bytes).subspan(whole_done * block_bytes);
+            auto tail = std::span(state.tail).first((state.num_blocks - whole_blocks) * block_bytes);
+            detail::sha2_compress_blocks(states_.at(lane), message);
+            detail::sha2_compress_blocks(states_.at(lane), tail.subspan(tail_done * block_bytes));
+            state.blocks_done = state.num_blocks;
+        }
+
+        for (bool completed = !lanes_in_step; !completed;) {
+            // Each message is processed in two runs of consecutive blocks: the whole blocks of the message, then the
+            // tail. Process as many blocks as possible before one of the lanes reaches the end of a run.
+            std::array<std::array<word_t, 8>*, num_lanes> states{};
+            std::array<const std::byte*, num_lanes> blocks{};
+            std::size_t num_active = 0;
+            std::size_t num_blocks = SIZE_MAX;
+            for (std::size_t lane = 0; lane < num_lanes; ++lane) {
+                auto& state = lanes_.at(lane);
+                if (!state.active)
+                    continue;
+                std::size_t whole_blocks = state.message.size() / block_bytes;
+                states.at(num_active) = &states_.at(lane);
+                if (state.blocks_done < whole_blocks) {
+                    blocks.at(num_active++) = state.message.data() + state.blocks_done * block_bytes;
+                    num_blocks = std::min(num_blocks, whole_blocks - state.blocks_done);
+                } else {
+                    blocks.at(num_active++) = state.tail.data() + (state.blocks_done - whole_blocks) * block_bytes;
+                    num_blocks = std::min(num_blocks, state.num_blocks - state.blocks_done);
+                }
+            }
+            compress(std::span(states).first(num_active), std::span(blocks).first(num_active), num_blocks);
+            for (auto& state : lanes_) {
+                state.blocks_done += state.active ? num_blocks : 0;
+                completed = completed || (state.active && state.blocks_done == state.num_blocks);
+            }
+        }
+
+        for (std::size_t lane = 0; lane < num_lanes; ++lane) {
+            auto& state = lanes_.at(lane);
+            if (!state.active || state.blocks_done < state.num_blocks)
+                continue;
+            results_.at(state.id - first_result_id_) = detail::final_digest<algorithm_t::digest_bits>(states_.at(lane));
+            state.active = false;
+        }
+    }
+
+    /// Processes consecutive blocks for each active lane. SHA-256 and SHA-224 use the interleaved SHA extensions kernel
+    /// if that backend is in use, which only does the work of the active lanes. Otherwise all of the lanes run through
+    /// the multi-buffer functions, and the inactive lanes hash blocks of zeros whose results are ignored.
+    ///
+    /// @param states     The intermediate hash value of each active lane.
+    /// @param blocks     The next block of each active lane, in big endian byte order.
+    /// @param num_blocks The number of consecutive blocks to process for each lane.
+    static void compress(std::span<std::array<word_t, 8>* const> states,
+                         std::span<const std::byte* const>        blocks,
+                         std::size_t                              num_blocks) {
+        if constexpr (std::is_same_v<word_t, std::uint32_t>)
+            if (detail::sha256_compress_interleaved(states, blocks, num_blocks))
+                return;
+
+        std::array<std::array<word_t, 8>, num_lanes> lane_states{};
+        for (std::size_t i = 0; i < states.size(); ++i)
+            lane_states.at(i) = *states[i];
+        auto transposed = detail::transpose(lane_states);
+        for (std::size_t block_index = 0; block_index < num_blocks; ++block_index) {
+            std::array<detail::block_t<word_t>, num_lanes> lane_blocks{};
+            for (std::size_t i = 0; i < blocks.size(); ++i)
+                lane_blocks.at(i) = detail::from_bytes<std::endian::big, word_t>(
+                    std::span<const std::byte, block_bytes>(blocks[i] + block_index * block_bytes, block_bytes));
+            constexpr const auto& constants = detail::sha2_constants<word_t>();
+            detail::sha2_compress_lanes(transposed, detail::sha2_add_constants_lanes(
+                detail::sha2_message_schedule_lanes<constants.size()>(detail::transpose(lane_blocks)), constants));
+        }
+        lane_states = detail::transpose(transposed);
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            *states[i] = lane_states.at(i);
+            // The multi-buffer functions are the portable code, so each active lane counts as a portable call.
+            detail::count_compression(algorithm_t::compression, backend::portable, num_blocks,
+                                      num_blocks * block_bytes);
+        }
+    }
+
+    /// The intermediate hash value of the job in each lane.
+    std::array<std::array<word_t, 8>, num_lanes> states_{};
+
+    /// The progress of the job in each lane.
+    std::array<lane_t, num_lanes> lanes_{};
+
+    /// The jobs that have not been given a lane yet, in the order they were submitted.
+    std::deque<waiting_job> waiting_;
+
+    /// The result of every job that has not been collected yet, in the order they were submitted, or nothing for jobs
+    /// that have not completed.
+    std::deque<std::optional<digest_t>> results_;
+
+    /// The id of the job at the front of results_.
+    std::uint64_t first_result_id_ = 0;
+};
+
+} // End namespace ctsha.
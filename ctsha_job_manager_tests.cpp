@@ -0,0 +1,157 @@
+/// Runtime tests for ctsha_job_manager.hpp. Streams of messages with a mix of lengths are hashed by the job manager,
+/// and the digests are checked against the streaming interface, along with the order they are collected in.
+#include "ctsha_job_manager.hpp"
+#include "ctsha_tests.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ctsha::literals;
+
+namespace {
+
+/// Hashes a stream of messages with a job manager, collecting results as they become available, and checks them.
+///
+/// @tparam algorithm_t The algorithm to check.
+///
+/// @param messages    The messages.
+/// @param description A description of the messages.
+template <typename algorithm_t>
+void check_stream(const std::vector<std::vector<std::byte>>& messages, const std::string& description) {
+    ctsha::job_manager<algorithm_t> manager;
+    std::vector<typename ctsha::job_manager<algorithm_t>::completed_job> results;
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        check(manager.submit(messages.at(i)) == i, description + " (id)");
+        while (auto job = manager.pop())
+            results.push_back(*job);
+    }
+    manager.flush();
+    while (auto job = manager.pop())
+        results.push_back(*job);
+
+    check(results.size() == messages.size(), description + " (count)");
+    for (std::size_t i = 0; i < results.size() && i < messages.size(); ++i) {
+        check(results.at(i).id == i, description + " (order)");
+        check(results.at(i).digest == ctsha::context<algorithm_t>().update(messages.at(i)).digest(),
+              description + " (digest of message " + std::to_string(i) + ")");
+    }
+}
+
+/// Checks an algorithm with messages of every length around the block and padding boundaries, and with a stream of
+/// messages of random lengths.
+///
+/// @tparam algorithm_t The algorithm to check.
+template <typename algorithm_t>
+void check_algorithm() {
+    constexpr std::size_t block_bytes = ctsha::job_manager<algorithm_t>::block_bytes;
+    std::mt19937 random(12345);
+    auto message = [&](std::size_t size) {
+        std::vector<std::byte> bytes(size);
+        for (auto& byte : bytes)
+            byte = static_cast<std::byte>(random());
+        return bytes;
+    };
+
+    std::vector<std::vector<std::byte>> boundaries;
+    for (std::size_t size = 0; size <= 2 * block_bytes + 1; ++size)
+        boundaries.push_back(message(size));
+    check_stream<algorithm_t>(boundaries, "boundary lengths");
+
+    // Mostly short messages with the odd long one, so lanes finish at very different times.
+    std::vector<std::vector<std::byte>> mixed;
+    for (std::size_t i = 0; i < 200; ++i)
+        mixed.push_back(message(random() % 16 == 0 ? random() % 100000 : random() % 300));
+    check_stream<algorithm_t>(mixed, "mixed lengths");
+
+    // Fewer jobs than lanes only complete when flushed.
+    ctsha::job_manager<algorithm_t> manager;
+    constexpr auto abc = "abc"_bytes;
+    manager.submit(abc);
+    check(!manager.pop(), "job in a partially filled batch");
+    manager.flush();
+    auto job = manager.pop();
+    check(job && job->digest == ctsha::context<algorithm_t>().update(abc).digest(), "flushed job");
+    check(!manager.pop(), "no more jobs");
+}
+
+/// Checks switching from a backend that runs the lanes in step to one that does not while jobs are part way done.
+///
+/// @tparam algorithm_t The algorithm to check.
+template <typename algorithm_t>
+void check_backend_switch() {
+    auto vector_backend = ctsha::backend_supported(ctsha::backend::avx2) ? ctsha::backend::avx2
+                                                                         : ctsha::backend::portable;
+    std::vector<std::vector<std::byte>> messages;
+    for (std::size_t i = 0; i < ctsha::job_manager<algorithm_t>::num_lanes; ++i)
+        messages.push_back(test_data(1000 + 300 * i));
+
+    ctsha::set_backend(ctsha::backend::portable);
+    ctsha::job_manager<algorithm_t> manager;
+    for (const auto& message : messages)
+        manager.submit(message);
+    ctsha::set_backend(vector_backend);
+    manager.flush();
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        auto job = manager.pop();
+        check(job && job->digest == ctsha::context<algorithm_t>().update(messages.at(i)).digest(),
+              "job " + std::to_string(i) + " across a backend switch");
+    }
+    ctsha::set_backend(std::nullopt);
+}
+
+/// Checks that the multi-buffer lanes of the portable backend count a call for each lane in the usage counters.
+void check_usage_counters() {
+    using algorithm_t = ctsha::algorithms::sha256;
+    constexpr std::size_t num_lanes = ctsha::job_manager<algorithm_t>::num_lanes;
+    auto message = test_data(1000);
+    ctsha::set_backend(ctsha::backend::portable);
+    auto before = ctsha::usage_counters();
+
+    // Each message takes two runs of blocks: its 15 whole blocks, then the final block with the padding.
+    ctsha::job_manager<algorithm_t> manager;
+    for (std::size_t i = 0; i < num_lanes; ++i)
+        manager.submit(message);
+    manager.flush();
+    while (manager.pop())
+        ;
+
+    auto after = ctsha::usage_counters();
+    std::uint64_t calls = CTSHA_COUNTERS ? 2 * num_lanes : 0;
+    const auto& old_counts = before.at(ctsha::compression_function::sha256, ctsha::backend::portable);
+    const auto& new_counts = after.at(ctsha::compression_function::sha256, ctsha::backend::portable);
+    check(new_counts.bytes - old_counts.bytes == 512 * calls && new_counts.calls - old_counts.calls == calls,
+          "usage counters of the multi-buffer lanes");
+    ctsha::set_backend(std::nullopt);
+}
+
+} // End anonymous namespace.
+
+int main() {
+    try {
+        // The lanes run in step with some backends and not with others, so every backend is checked.
+        for (std::size_t i = 0; i < ctsha::detail::backend_names.size(); ++i) {
+            auto kernels = static_cast<ctsha::backend>(i);
+            if (!ctsha::backend_supported(kernels))
+                continue;
+            ctsha::set_backend(kernels);
+            check_algorithm<ctsha::algorithms::sha224>();
+            check_algorithm<ctsha::algorithms::sha256>();
+            check_algorithm<ctsha::algorithms::sha384>();
+            check_algorithm<ctsha::algorithms::sha512>();
+            check_algorithm<ctsha::algorithms::sha512_t<256>>();
+        }
+        ctsha::set_backend(std::nullopt);
+        check_backend_switch<ctsha::algorithms::sha256>();
+        check_backend_switch<ctsha::algorithms::sha512>();
+        check_usage_counters();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ++failures;
+    }
+
+    std::cout << "Job manager tests " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,608 @@
+/// An append-only, tamper-evident log built on the SHA-256 functions in ctsha.hpp. The log is a Merkle tree as defined
+/// by RFC 6962 section 2.1 (see https://www.rfc-editor.org/rfc/rfc6962#section-2.1), so it can produce inclusion proofs
+/// (that an entry is in the log) and consistency proofs (that a later version of the log only appends to an earlier
+/// one), which can be checked by anyone who knows the root hashes.
+///
+/// Only the roots of the perfect subtrees along the right edge of the tree (the "frontier") are needed to append an
+/// entry and compute the new root, which takes O(log n) hashes. Every complete node of the tree is also written to a
+/// storage object so that proofs can be generated for any earlier version of the log. The nodes can be kept in memory,
+/// or in memory-mapped files so that logs with billions of entries do not need to fit in RAM.
+///
+/// Unlike the rest of the library, this is only usable at runtime, and the memory-mapped storage requires POSIX.
+
+#pragma once
+
+#include "ctsha.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ctsha {
+
+/// Stores the nodes of a Merkle log in memory. Level 0 holds the leaf hashes, and node i of level k is the root of the
+/// perfect subtree over leaves [i * 2^k, (i + 1) * 2^k). Any type with the same member functions can be used as the
+/// storage of a merkle_log.
+class memory_node_storage {
+public:
+    /// Gets the number of levels that hold at least one node.
+    ///
+    /// @returns The number of levels.
+    std::size_t levels() const {
+        return levels_.size();
+    }
+
+    /// Gets the number of nodes in a level.
+    ///
+    /// @param level The level, where 0 is the leaves.
+    ///
+    /// @returns The number of nodes in the level, which is 0 for levels that have not been created yet.
+    std::uint64_t size(std::size_t level) const {
+        return level < levels_.size() ? levels_[level].size() : 0;
+    }
+
+    /// Gets a node.
+    ///
+    /// @param level The level, where 0 is the leaves.
+    /// @param index The index of the node within the level.
+    ///
+    /// @returns The hash of the node.
+    ///
+    /// @throws std::out_of_range if the node does not exist.
+    merkle_digest_t get(std::size_t level, std::uint64_t index) const {
+        return levels_.at(level).at(index);
+    }
+
+    /// Adds a node to the end of a level, creating the level if needed.
+    ///
+    /// @param level  The level, where 0 is the leaves. This may be at most levels().
+    /// @param digest The hash of the node.
+    void push_back(std::size_t level, const merkle_digest_t& digest) {
+        if (level == levels_.size())
+            levels_.emplace_back();
+        levels_.at(level).push_back(digest);
+    }
+
+private:
+    /// The nodes of each level.
+    std::vector<std::vector<merkle_digest_t>> levels_;
+};
+
+/// Stores the nodes of a Merkle log in memory-mapped files, one file per level, named level-00, level-01, and so on in
+/// a directory. Each file starts with a header holding the number of nodes in the level, followed by the nodes. Files
+/// grow geometrically as nodes are added, so appending is amortized O(1). A node is written before the count that
+/// includes it, so an interrupted append never exposes a partially written node.
+class mapped_node_storage {
+public:
+    /// Opens the storage in a directory, creating the directory if it does not exist. Existing levels are reopened.
+    ///
+    /// @param directory The directory holding the level files.
+    ///
+    /// @throws std::system_error if a file cannot be opened or mapped.
+    /// @throws std::runtime_error if a level file is corrupt.
+    explicit mapped_node_storage(std::filesystem::path directory) : directory_(std::move(directory)) {
+        std::filesystem::create_directories(directory_);
+        while (std::filesystem::exists(level_path(levels_.size())))
+            levels_.emplace_back(level_path(levels_.size()));
+    }
+
+    /// Gets the number of levels that hold at least one node.
+    ///
+    /// @returns The number of levels.
+    std::size_t levels() const {
+        return levels_.size();
+    }
+
+    /// Gets the number of nodes in a level.
+    ///
+    /// @param level The level, where 0 is the leaves.
+    ///
+    /// @returns The number of nodes in the level, which is 0 for levels that have not been created yet.
+    std::uint64_t size(std::size_t level) const {
+        return level < levels_.size() ? levels_[level].size() : 0;
+    }
+
+    /// Gets a node.
+    ///
+    /// @param level The level, where 0 is the leaves.
+    /// @param index The index of the node within the level.
+    ///
+    /// @returns The hash of the node.
+    ///
+    /// @throws std::out_of_range if the node does not exist.
+    merkle_digest_t get(std::size_t level, std::uint64_t index) const {
+        if (index >= size(level))
+            throw std::out_of_range("Merkle log node does not exist.");
+        merkle_digest_t digest;
+        std::memcpy(digest.data(), levels_[level].node(index), digest.size());
+        return digest;
+    }
+
+    /// Adds a node to the end of a level, creating the level if needed.
+    ///
+    /// @param level  The level, where 0 is the leaves. This may be at most levels().
+    /// @param digest The hash of the node.
+    ///
+    /// @throws std::system_error if a file cannot be created or grown.
+    void push_back(std::size_t level, const merkle_digest_t& digest) {
+        if (level == levels_.size())
+            levels_.emplace_back(level_path(level));
+        levels_.at(level).push_back(digest);
+    }
+
+    /// Flushes all levels to disk.
+    ///
+    /// @throws std::system_error if a level cannot be flushed.
+    void sync() {
+        for (auto& file : levels_)
+            file.sync();
+    }
+
+private:
+    /// A single memory-mapped level file.
+    class level_file {
+    public:
+        /// The number of bytes in the header, which is the size of a node so that the nodes stay aligned.
+        static constexpr std::size_t header_bytes = std::tuple_size_v<merkle_digest_t>;
+
+        /// The number of nodes a new file has room for.
+        static constexpr std::uint64_t initial_capacity = 1024;
+
+        /// Opens or creates a level file and maps it.
+        ///
+        /// @param path The path of the file.
+        ///
+        /// @throws std::system_error if the file cannot be opened or mapped.
+        /// @throws std::runtime_error if the header counts more nodes than the file holds, which happens if the file
+        ///         is corrupt or has been truncated.
+        explicit level_file(const std::filesystem::path& path) {
+            fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd_ < 0)
+                throw std::system_error(errno, std::generic_category(), "Could not open " + path.string());
+
+            // The destructor doesn't run if the constructor throws, so clean up here.
+            try {
+                struct stat status{};
+                if (::fstat(fd_, &status) != 0)
+                    fail("Could not stat " + path.string());
+                std::uint64_t file_bytes = static_cast<std::uint64_t>(status.st_size);
+                map(file_bytes < header_bytes ? initial_capacity : (file_bytes - header_bytes) / node_bytes);
+                if (size() > capacity_)
+                    throw std::runtime_error("Merkle log level " + path.string() + " is corrupt.");
+            } catch (...) {
+                unmap();
+                ::close(fd_);
+                throw;
+            }
+        }
+
+        level_file(level_file&& other) noexcept
+            : fd_(std::exchange(other.fd_, -1)),
+              data_(std::exchange(other.data_, nullptr)),
+              capacity_(std::exchange(other.capacity_, 0)) {}
+
+        level_file& operator=(level_file&& other) noexcept {
+            std::swap(fd_, other.fd_);
+            std::swap(data_, other.data_);
+            std::swap(capacity_, other.capacity_);
+            return *this;
+        }
+
+        ~level_file() {
+            unmap();
+            if (fd_ >= 0)
+                ::close(fd_);
+        }
+
+        /// @returns The number of nodes in the level.
+        std::uint64_t size() const {
+            std::uint64_t count;
+            std::memcpy(&count, data_, sizeof(count));
+            return count;
+        }
+
+        /// @param index The index of a node.
+        ///
+        /// @returns A pointer to the node.
+        const std::byte* node(std::uint64_t index) const {
+            return data_ + header_bytes + index * node_bytes;
+        }
+
+        /// Appends a node, growing the file if it is full.
+        ///
+        /// @param digest The hash of the node.
+        void push_back(const merkle_digest_t& digest) {
+            std::uint64_t count = size();
+            if (count == capacity_) {
+                unmap();
+                map(std::max(capacity_ * 2, initial_capacity));
+            }
+            std::memcpy(data_ + header_bytes + count * node_bytes, digest.data(), digest.size());
+            ++count;
+            std::memcpy(data_, &count, sizeof(count));
+        }
+
+        /// Flushes the mapping to disk.
+        void sync() {
+            if (::msync(data_, header_bytes + capacity_ * node_bytes, MS_SYNC) != 0)
+                fail("Could not sync Merkle log level");
+        }
+
+    private:
+        /// The number of bytes in a node.
+        static constexpr std::size_t node_bytes = std::tuple_size_v<merkle_digest_t>;
+
+        /// Sizes the file to hold a number of nodes and maps all of it.
+        ///
+        /// @param capacity The number of nodes the file should have room for.
+        void map(std::uint64_t capacity) {
+            std::size_t bytes = header_bytes + capacity * node_bytes;
+            if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0)
+                fail("Could not grow Merkle log level");
+            void* data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (data == MAP_FAILED)
+                fail("Could not map Merkle log level");
+            data_ = static_cast<std::byte*>(data);
+            capacity_ = capacity;
+        }
+
+        /// Unmaps the file, if it is mapped.
+        void unmap() {
+            if (data_ != nullptr)
+                ::munmap(data_, header_bytes + capacity_ * node_bytes);
+            data_ = nullptr;
+        }
+
+        /// Throws a std::system_error for the current errno.
+        ///
+        /// @param what A description of what failed.
+        [[noreturn]] static void fail(const std::string& what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        /// The file descriptor of the level file.
+        int fd_ = -1;
+
+        /// The mapping of the whole file.
+        std::byte* data_ = nullptr;
+
+        /// The number of nodes the file has room for.
+        std::uint64_t capacity_ = 0;
+    };
+
+    /// @param level A level.
+    ///
+    /// @returns The path of the file holding the level.
+    std::filesystem::path level_path(std::size_t level) const {
+        char name[] = "level-00";
+        name[6] = static_cast<char>('0' + level / 10);
+        name[7] = static_cast<char>('0' + level % 10);
+        return directory_ / name;
+    }
+
+    /// The directory holding the level files.
+    std::filesystem::path directory_;
+
+    /// The mapped level files.
+    std::vector<level_file> levels_;
+};
+
+/// An append-only Merkle log of SHA-256 hashes, as described at the top of this file.
+///
+/// @tparam storage_t The type that stores the nodes of the tree, such as memory_node_storage or mapped_node_storage.
+template <typename storage_t = memory_node_storage>
+class merkle_log {
+public:
+    /// Creates a log from storage, which may already hold the nodes of an earlier log. Levels left incomplete by an
+    /// interrupted append are filled in.
+    ///
+    /// @param storage The storage holding the nodes of the tree.
+    explicit merkle_log(storage_t storage = storage_t()) : storage_(std::move(storage)) {
+        for (std::size_t level = 0; level < storage_.levels(); ++level) {
+            for (std::uint64_t index = storage_.size(level + 1); index < storage_.size(level) / 2; ++index)
+                storage_.push_back(level + 1, merkle_node_hash(storage_.get(level, 2 * index),
+                                                               storage_.get(level, 2 * index + 1)));
+        }
+
+        size_ = storage_.size(0);
+        for (std::size_t level = 0; level < frontier_.size(); ++level) {
+            if ((size_ >> level) & 1)
+                frontier_.at(level) = storage_.get(level, (size_ >> level) - 1);
+        }
+    }
+
+    /// @returns The number of entries in the log.
+    std::uint64_t size() const {
+        return size_;
+    }
+
+    /// @returns The storage holding the nodes of the tree.
+    storage_t& storage() {
+        return storage_;
+    }
+
+    /// Appends an entry to the log.
+    ///
+    /// @param entry The entry.
+    ///
+    /// @returns The index of the entry.
+    std::uint64_t append(std::span<const std::byte> entry) {
+        return append_hash(merkle_leaf_hash(entry));
+    }
+
+    /// Appends an entry to the log given the hash of its leaf, as computed by merkle_leaf_hash.
+    ///
+    /// @param leaf_hash The hash of the leaf.
+    ///
+    /// @returns The index of the entry.
+    std::uint64_t append_hash(const merkle_digest_t& leaf_hash) {
+        // This works like incrementing a binary counter: each subtree that the new leaf completes is merged with the
+        // frontier subtree of the same height to its left, carrying into the next level.
+        merkle_digest_t carry = leaf_hash;
+        storage_.push_back(0, carry);
+        std::size_t level = 0;
+        for (; (size_ >> level) & 1; ++level) {
+            carry = merkle_node_hash(frontier_.at(level), carry);
+            storage_.push_back(level + 1, carry);
+        }
+        frontier_.at(level) = carry;
+        return size_++;
+    }
+
+    /// Computes the root hash of the log using only the frontier, which takes O(log n) hashes and no storage accesses.
+    ///
+    /// @returns The root hash.
+    merkle_digest_t root() const {
+        if (size_ == 0)
+            return sha256(std::array<std::byte, 0>{});
+
+        // Fold the frontier subtrees together from the smallest (rightmost) to the largest (leftmost).
+        std::size_t level = static_cast<std::size_t>(std::countr_zero(size_));
+        merkle_digest_t result = frontier_.at(level);
+        for (++level; level < frontier_.size(); ++level) {
+            if ((size_ >> level) & 1)
+                result = merkle_node_hash(frontier_.at(level), result);
+        }
+        return result;
+    }
+
+    /// Computes the root hash of an earlier version of the log.
+    ///
+    /// @param tree_size The number of entries in the earlier version of the log.
+    ///
+    /// @returns The root hash.
+    ///
+    /// @throws std::invalid_argument if tree_size is larger than the log.
+    merkle_digest_t root(std::uint64_t tree_size) const {
+        check_size(tree_size);
+        return tree_size == 0 ? sha256(std::array<std::byte, 0>{}) : subtree_hash(0, tree_size);
+    }
+
+    /// Generates a proof that an entry is in a version of the log. (RFC 6962 section 2.1.1.)
+    ///
+    /// @param index     The index of the entry.
+    /// @param tree_size The number of entries in the version of the log.
+    ///
+    /// @returns The audit path, starting with the sibling of the leaf.
+    ///
+    /// @throws std::invalid_argument if index is not less than tree_size, or tree_size is larger than the log.
+    std::vector<merkle_digest_t> inclusion_proof(std::uint64_t index, std::uint64_t tree_size) const {
+        check_size(tree_size);
+        if (index >= tree_size)
+            throw std::invalid_argument("Merkle log index is not in the tree.");
+
+        std::vector<merkle_digest_t> proof;
+        path(index, 0, tree_size, proof);
+        return proof;
+    }
+
+    /// Generates a proof that one version of the log is a prefix of another. (RFC 6962 section 2.1.2.)
+    ///
+    /// @param old_size The number of entries in the earlier version of the log.
+    /// @param new_size The number of entries in the later version of the log.
+    ///
+    /// @returns The consistency proof, which is empty if old_size is 0 or equal to new_size.
+    ///
+    /// @throws std::invalid_argument if old_size is larger than new_size, or new_size is larger than the log.
+    std::vector<merkle_digest_t> consistency_proof(std::uint64_t old_size, std::uint64_t new_size) const {
+        check_size(new_size);
+        if (old_size > new_size)
+            throw std::invalid_argument("Merkle log sizes are out of order.");
+
+        std::vector<merkle_digest_t> proof;
+        if (old_size > 0 && old_size < new_size)
+            subproof(old_size, 0, new_size, true, proof);
+        return proof;
+    }
+
+private:
+    /// @param tree_size The number of entries in a version of the log.
+    ///
+    /// @throws std::invalid_argument if tree_size is larger than the log.
+    void check_size(std::uint64_t tree_size) const {
+        if (tree_size > size_)
+            throw std::invalid_argument("Merkle log is smaller than the requested tree size.");
+    }
+
+    /// Computes MTH(D[start:start + count]). In every call made by this class start is a multiple of the smallest power
+    /// of two not less than count, so every perfect subtree involved is a node in storage.
+    ///
+    /// @param start The index of the first leaf.
+    /// @param count The number of leaves, which must not be 0.
+    ///
+    /// @returns The hash of the subtree.
+    merkle_digest_t subtree_hash(std::uint64_t start, std::uint64_t count) const {
+        if (std::has_single_bit(count)) {
+            auto level = static_cast<std::size_t>(std::countr_zero(count));
+            return storage_.get(level, start >> level);
+        }
+        std::uint64_t split = std::bit_floor(count - 1);
+        return merkle_node_hash(subtree_hash(start, split), subtree_hash(start + split, count - split));
+    }
+
+    /// Computes PATH(index, D[start:start + count]) and appends it to a proof.
+    ///
+    /// @param index The index of the leaf, relative to start.
+    /// @param start The index of the first leaf.
+    /// @param count The number of leaves.
+    /// @param proof The proof to append to.
+    void path(std::uint64_t index,
+              std::uint64_t start,
+              std::uint64_t count,
+              std::vector<merkle_digest_t>& proof) const {
+        if (count == 1)
+            return;
+        std::uint64_t split = std::bit_floor(count - 1);
+        if (index < split) {
+            path(index, start, split, proof);
+            proof.push_back(subtree_hash(start + split, count - split));
+        } else {
+            path(index - split, start + split, count - split, proof);
+            proof.push_back(subtree_hash(start, split));
+        }
+    }
+
+    /// Computes SUBPROOF(old_size, D[start:start + count], complete) and appends it to a proof.
+    ///
+    /// @param old_size The number of leaves in the earlier version of the subtree.
+    /// @param start    The index of the first leaf.
+    /// @param count    The number of leaves.
+    /// @param complete Whether the earlier subtree is a complete subtree of the original old tree, whose root the
+    ///                 verifier already knows.
+    /// @param proof    The proof to append to.
+    void subproof(std::uint64_t old_size,
+                  std::uint64_t start,
+                  std::uint64_t count,
+                  bool complete,
+                  std::vector<merkle_digest_t>& proof) const {
+        if (old_size == count) {
+            if (!complete)
+                proof.push_back(subtree_hash(start, count));
+            return;
+        }
+        std::uint64_t split = std::bit_floor(count - 1);
+        if (old_size <= split) {
+            subproof(old_size, start, split, complete, proof);
+            proof.push_back(subtree_hash(start + split, count - split));
+        } else {
+            subproof(old_size - split, start + split, count - split, false, proof);
+            proof.push_back(subtree_hash(start, split));
+        }
+    }
+
+    /// The storage holding every complete node of the tree.
+    storage_t storage_;
+
+    /// The number of entries in the log.
+    std::uint64_t size_ = 0;
+
+    /// The root of the perfect subtree of height k along the right edge of the tree, for each bit k set in size_.
+    std::array<merkle_digest_t, 64> frontier_{};
+};
+
+/// Verifies a proof that an entry is in a version of a Merkle log. (RFC 9162 section 2.1.3.2.)
+///
+/// @param leaf_hash The hash of the leaf, as computed by merkle_leaf_hash.
+/// @param index     The index of the entry.
+/// @param tree_size The number of entries in the version of the log.
+/// @param proof     The audit path, as generated by merkle_log::inclusion_proof.
+/// @param root      The root hash of the version of the log.
+///
+/// @returns True if the proof is valid, false otherwise.
+inline bool verify_inclusion(const merkle_digest_t& leaf_hash,
+                             std::uint64_t index,
+                             std::uint64_t tree_size,
+                             std::span<const merkle_digest_t> proof,
+                             const merkle_digest_t& root) {
+    if (index >= tree_size)
+        return false;
+
+    std::uint64_t node = index;
+    std::uint64_t last = tree_size - 1;
+    merkle_digest_t result = leaf_hash;
+    for (const auto& sibling : proof) {
+        if (last == 0)
+            return false;
+        if ((node & 1) || node == last) {
+            result = merkle_node_hash(sibling, result);
+            while (!(node & 1) && node != 0) {
+                node >>= 1;
+                last >>= 1;
+            }
+        } else {
+            result = merkle_node_hash(result, sibling);
+        }
+        node >>= 1;
+        last >>= 1;
+    }
+    return last == 0 && result == root;
+}
+
+/// Verifies a proof that one version of a Merkle log is a prefix of another. (RFC 9162 section 2.1.4.2.)
+///
+/// @param old_size The number of entries in the earlier version of the log.
+/// @param new_size The number of entries in the later version of the log.
+/// @param old_root The root hash of the earlier version of the log.
+/// @param new_root The root hash of the later version of the log.
+/// @param proof    The consistency proof, as generated by merkle_log::consistency_proof.
+///
+/// @returns True if the proof is valid, false otherwise.
+inline bool verify_consistency(std::uint64_t old_size,
+                               std::uint64_t new_size,
+                               const merkle_digest_t& old_root,
+                               const merkle_digest_t& new_root,
+                               std::span<const merkle_digest_t> proof) {
+    if (old_size > new_size)
+        return false;
+    if (old_size == new_size)
+        return proof.empty() && old_root == new_root;
+    if (old_size == 0)
+        return proof.empty();
+    if (proof.empty())
+        return false;
+
+    // If the old tree is a perfect subtree of the new one, the verifier already knows its root, so it is not sent.
+    std::vector<merkle_digest_t> path;
+    if (std::has_single_bit(old_size))
+        path.push_back(old_root);
+    path.insert(path.end(), proof.begin(), proof.end());
+
+    std::uint64_t node = old_size - 1;
+    std::uint64_t last = new_size - 1;
+    while (node & 1) {
+        node >>= 1;
+        last >>= 1;
+    }
+
+    merkle_digest_t old_result = path.front();
+    merkle_digest_t new_result = path.front();
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        if (last == 0)
+            return false;
+        if ((node & 1) || node == last) {
+            old_result = merkle_node_hash(path.at(i), old_result);
+            new_result = merkle_node_hash(path.at(i), new_result);
+            while (!(node & 1) && node != 0) {
+                node >>= 1;
+                last >>= 1;
+            }
+        } else {
+            new_result = merkle_node_hash(new_result, path.at(i));
+        }
+        node >>= 1;
+        last >>= 1;
+    }
+    return last == 0 && old_result == old_root && new_result == new_root;
+}
+
+} // End namespace ctsha.
@@ -0,0 +1,190 @@
+/// Runtime tests for ctsha_merkle_log.hpp. The roots and proofs of every log size up to a limit are checked against a
+/// straightforward recursive implementation of RFC 6962, and against the test vectors used by the RFC 6962 reference
+/// implementation.
+#include "ctsha_merkle_log.hpp"
+#include "ctsha_tests.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+using namespace ctsha::literals;
+
+namespace {
+
+/// @param text A string.
+///
+/// @returns The bytes of the string.
+std::span<const std::byte> bytes_of(const std::string& text) {
+    return std::as_bytes(std::span(text));
+}
+
+/// Computes MTH(D[start:start + count]) directly from the definition in RFC 6962 section 2.1.
+///
+/// @param leaves The leaf hashes.
+/// @param start  The index of the first leaf.
+/// @param count  The number of leaves.
+///
+/// @returns The hash of the tree.
+ctsha::merkle_digest_t reference_root(const std::vector<ctsha::merkle_digest_t>& leaves,
+                                      std::size_t start,
+                                      std::size_t count) {
+    if (count == 0)
+        return ctsha::sha256(std::array<std::byte, 0>{});
+    if (count == 1)
+        return leaves.at(start);
+    std::size_t split = 1;
+    while (split * 2 < count)
+        split *= 2;
+    return ctsha::merkle_node_hash(reference_root(leaves, start, split),
+                                   reference_root(leaves, start + split, count - split));
+}
+
+/// Builds a log of the given size, and checks its roots and every inclusion and consistency proof against the reference
+/// implementation, including that tampered proofs are rejected.
+///
+/// @tparam storage_t The type of storage for the log.
+///
+/// @param log      An empty log.
+/// @param max_size The number of entries to append.
+template <typename storage_t>
+void check_log(ctsha::merkle_log<storage_t>& log, std::size_t max_size) {
+    std::vector<ctsha::merkle_digest_t> leaves;
+    for (std::size_t size = 1; size <= max_size; ++size) {
+        auto entry = std::to_string(size - 1);
+        leaves.push_back(ctsha::merkle_leaf_hash(bytes_of(entry)));
+        check(log.append(bytes_of(entry)) == size - 1, "append index");
+        check(log.root() == reference_root(leaves, 0, size), "root of size " + std::to_string(size));
+    }
+
+    for (std::size_t size = 0; size <= max_size; ++size) {
+        auto root = reference_root(leaves, 0, size);
+        check(log.root(size) == root, "historical root of size " + std::to_string(size));
+
+        for (std::size_t index = 0; index < size; ++index) {
+            auto description = "inclusion of " + std::to_string(index) + " in " + std::to_string(size);
+            auto proof = log.inclusion_proof(index, size);
+            check(ctsha::verify_inclusion(leaves.at(index), index, size, proof, root), description);
+            check(!ctsha::verify_inclusion(leaves.at(index), index + 1, size, proof, root), description + " (index)");
+            for (std::size_t i = 0; i < proof.size(); ++i) {
+                auto tampered = proof;
+                tampered.at(i).at(0) ^= std::byte{1};
+                check(!ctsha::verify_inclusion(leaves.at(index), index, size, tampered, root),
+                      description + " (tamper)");
+            }
+        }
+
+        for (std::size_t old_size = 0; old_size <= size; ++old_size) {
+            auto description = "consistency of " + std::to_string(old_size) + " with " + std::to_string(size);
+            auto old_root = reference_root(leaves, 0, old_size);
+            auto proof = log.consistency_proof(old_size, size);
+            check(ctsha::verify_consistency(old_size, size, old_root, root, proof), description);
+            if (old_size > 0 && old_size < size) {
+                auto wrong_root = old_root;
+                wrong_root.at(0) ^= std::byte{1};
+                check(!ctsha::verify_consistency(old_size, size, wrong_root, root, proof), description + " (root)");
+                for (std::size_t i = 0; i < proof.size(); ++i) {
+                    auto tampered = proof;
+                    tampered.at(i).at(0) ^= std::byte{1};
+                    check(!ctsha::verify_consistency(old_size, size, old_root, root, tampered),
+                          description + " (tamper)");
+                }
+            }
+        }
+    }
+}
+
+/// Checks that level files which are too short are grown or rejected instead of being read or written past their ends.
+///
+/// @param directory An empty directory to put the level files in.
+void check_damaged_levels(const std::filesystem::path& directory) {
+    auto write_level = [&](std::uint64_t count, std::size_t file_bytes) {
+        std::vector<char> contents(file_bytes);
+        std::memcpy(contents.data(), &count, std::min(sizeof(count), file_bytes));
+        std::ofstream(directory / "level-00", std::ios::binary | std::ios::trunc).write(contents.data(),
+                                                                                       contents.size());
+    };
+
+    // A header with room for no nodes must grow on the first append.
+    write_level(0, 40);
+    {
+        ctsha::mapped_node_storage storage(directory);
+        for (std::uint64_t i = 0; i < 3000; ++i)
+            storage.push_back(0, ctsha::sha256(bytes_of(std::to_string(i))));
+        check(storage.size(0) == 3000 && storage.get(0, 2999) == ctsha::sha256(bytes_of("2999")), "grow empty level");
+    }
+
+    // A header counting more nodes than the file holds must be rejected.
+    for (auto [count, file_bytes] : {std::pair{std::uint64_t{1}, std::size_t{40}}, std::pair{std::uint64_t{100},
+                                     std::size_t{32 + 99 * 32}}, std::pair{~std::uint64_t{0}, std::size_t{32}}}) {
+        write_level(count, file_bytes);
+        bool rejected = false;
+        try {
+            ctsha::mapped_node_storage storage(directory);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        check(rejected, "reject level of " + std::to_string(file_bytes) + " bytes with count " + std::to_string(count));
+    }
+}
+
+} // End anonymous namespace.
+
+int main() {
+    // The leaves used by the test vectors of the RFC 6962 reference implementation.
+    std::vector<std::vector<std::byte>> entries = {
+        {},
+        {std::byte{0x00}},
+        {std::byte{0x10}},
+        {std::byte{0x20}, std::byte{0x21}},
+        {std::byte{0x30}, std::byte{0x31}},
+        {std::byte{0x40}, std::byte{0x41}, std::byte{0x42}, std::byte{0x43}},
+    };
+    ctsha::merkle_log<> vectors;
+    check(vectors.root() == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"_hex_bytes, "empty root");
+    for (const auto& entry : entries)
+        vectors.append(entry);
+    check(vectors.root(1) == "6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d"_hex_bytes, "vector 1");
+    check(vectors.root(4) == "d37ee418976dd95753c1c73862b9398fa2a2cf9b4ff0fdfe8b30cd95209614b7"_hex_bytes, "vector 4");
+    check(vectors.root(6) == "76e67dadbcdf1e10e1b74ddc608abd2f98dfb16fbce75277b5232a127f2087ef"_hex_bytes, "vector 6");
+
+    ctsha::merkle_log<> memory_log;
+    check_log(memory_log, 40);
+
+    // Build a log in memory-mapped storage, then reopen it to make sure the frontier is recovered.
+    char directory[] = "/tmp/ctsha_merkle_log_XXXXXX";
+    if (::mkdtemp(directory) == nullptr) {
+        std::cerr << "Could not create a temporary directory." << std::endl;
+        return EXIT_FAILURE;
+    }
+    try {
+        {
+            ctsha::merkle_log<ctsha::mapped_node_storage> mapped_log{ctsha::mapped_node_storage(directory)};
+            check_log(mapped_log, 40);
+            for (std::size_t i = 40; i < 5000; ++i)
+                mapped_log.append(bytes_of(std::to_string(i)));
+        }
+        ctsha::merkle_log<> expected;
+        for (std::size_t i = 0; i < 5001; ++i)
+            expected.append(bytes_of(std::to_string(i)));
+
+        ctsha::merkle_log<ctsha::mapped_node_storage> reopened{ctsha::mapped_node_storage(directory)};
+        check(reopened.size() == 5000, "reopened size");
+        check(reopened.root() == expected.root(5000), "reopened root");
+        reopened.append(bytes_of("5000"));
+        check(reopened.root() == expected.root(), "reopened append");
+        check(reopened.inclusion_proof(1234, 5001) == expected.inclusion_proof(1234, 5001), "reopened proof");
+
+        std::filesystem::create_directory(std::filesystem::path(directory) / "damaged");
+        check_damaged_levels(std::filesystem::path(directory) / "damaged");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ++failures;
+    }
+    std::filesystem::remove_all(directory);
+
+    std::cout << "Merkle log tests " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
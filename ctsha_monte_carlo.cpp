@@ -0,0 +1,112 @@
+/// Runs the full FIPS 180-4 Monte Carlo Tests (see section 6.4 of The Secure Hash Algorithm Validation System) at
+/// runtime. Each test chains 100,000 hashes of three concatenated digests, so this also serves as a rough benchmark of
+/// the latency of hashing short, fixed-size messages.
+///
+/// Usage: ctsha_monte_carlo <directory containing the SHA*Monte.rsp files>
+#include "ctsha.hpp"
+#include "ctsha_tests.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// The number of checkpoints in a Monte Carlo Test.
+constexpr std::size_t checkpoints = 100;
+
+/// The number of hashes computed for each checkpoint.
+constexpr std::size_t iterations = 1000;
+
+/// Converts a string of hex digits to an array of bytes.
+///
+/// @tparam num_bytes The number of bytes expected.
+///
+/// @param hex The hex digits to convert.
+///
+/// @returns The converted bytes.
+///
+/// @throws std::invalid_argument if the string is not exactly num_bytes bytes of hex digits.
+template <std::size_t num_bytes>
+std::array<std::byte, num_bytes> parse_hex(const std::string& hex) {
+    if (hex.size() != num_bytes * 2)
+        throw std::invalid_argument("Hex string \"" + hex + "\" has the wrong length.");
+
+    std::array<std::byte, num_bytes> bytes{};
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+        bytes.at(i) = static_cast<std::byte>(std::stoul(hex.substr(i * 2, 2), nullptr, 16));
+    return bytes;
+}
+
+/// Runs the full Monte Carlo Test for one algorithm, checking the result of every checkpoint against the test vectors.
+///
+/// @tparam digest_bytes The number of bytes in a digest.
+/// @tparam hash_t       The type of the hash function. This parameter is usually deduced.
+///
+/// @param file The .rsp file containing the seed and the expected checkpoint results.
+/// @param hash The hash function to test.
+///
+/// @returns True if every checkpoint matched, false otherwise.
+template <std::size_t digest_bytes, typename hash_t>
+bool run_monte_carlo(const std::filesystem::path& file, hash_t hash) {
+    // Read the seed and expected digests. Lines look like "Seed = 0123..." and "MD = 0123...".
+    std::ifstream input(file);
+    if (!input)
+        throw std::runtime_error("Could not open " + file.string() + ".");
+
+    std::array<std::byte, digest_bytes> seed{};
+    std::vector<std::array<std::byte, digest_bytes>> expected;
+    for (std::string line; std::getline(input, line);) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.starts_with("Seed = "))
+            seed = parse_hex<digest_bytes>(line.substr(7));
+        else if (line.starts_with("MD = "))
+            expected.push_back(parse_hex<digest_bytes>(line.substr(5)));
+    }
+    if (expected.size() != checkpoints)
+        throw std::runtime_error(file.string() + " does not contain " + std::to_string(checkpoints) + " digests.");
+
+    // Chain all of the checkpoints together, the same way the test vectors were generated.
+    std::size_t failures = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& expected_digest : expected) {
+        seed = monte_carlo_checkpoint(hash, seed, iterations);
+        failures += seed != expected_digest;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << file.stem().string() << ": " << checkpoints * iterations << " hashes of " << 3 * digest_bytes
+              << " bytes, " << elapsed.count() / (checkpoints * iterations) << " ns/hash, "
+              << (failures == 0 ? "ok" : std::to_string(failures) + " checkpoints FAILED") << std::endl;
+    return failures == 0;
+}
+
+} // End anonymous namespace.
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <directory containing the SHA*Monte.rsp files>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::filesystem::path dir(argv[1]);
+        bool passed = true;
+        passed &= run_monte_carlo<20>(dir / "SHA1Monte.rsp",       [](auto& m) { return ctsha::sha1(m); });
+        passed &= run_monte_carlo<28>(dir / "SHA224Monte.rsp",     [](auto& m) { return ctsha::sha224(m); });
+        passed &= run_monte_carlo<32>(dir / "SHA256Monte.rsp",     [](auto& m) { return ctsha::sha256(m); });
+        passed &= run_monte_carlo<48>(dir / "SHA384Monte.rsp",     [](auto& m) { return ctsha::sha384(m); });
+        passed &= run_monte_carlo<64>(dir / "SHA512Monte.rsp",     [](auto& m) { return ctsha::sha512(m); });
+        passed &= run_monte_carlo<28>(dir / "SHA512_224Monte.rsp", [](auto& m) { return ctsha::sha512_t<224>(m); });
+        passed &= run_monte_carlo<32>(dir / "SHA512_256Monte.rsp", [](auto& m) { return ctsha::sha512_t<256>(m); });
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
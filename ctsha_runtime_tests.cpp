@@ -0,0 +1,562 @@
+/// Runtime tests for the parts of ctsha.hpp that behave differently at runtime than at compile time, so cannot be
+/// checked by the static_asserts in ctsha_tests.cpp. The results are checked against the constexpr code paths.
+#include "ctsha.hpp"
+#include "ctsha_tests.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ctsha::literals;
+
+namespace {
+
+/// Checks copying and hashing messages of various sizes into destinations of every alignment, both in one piece and
+/// split so that the second piece starts part way through a block.
+///
+/// @tparam algorithm_t The algorithm to check.
+template <typename algorithm_t>
+void check_copy_and_hash() {
+    for (std::size_t size : {0, 1, 15, 16, 63, 64, 65, 127, 128, 129, 1000, 100003}) {
+        auto source = test_data(size);
+        auto expected = ctsha::context<algorithm_t>().update(source).digest();
+        for (std::size_t alignment = 0; alignment < 16; ++alignment) {
+            auto description = std::to_string(size) + " bytes at alignment " + std::to_string(alignment);
+            std::vector<std::byte> buffer(size + 16);
+            auto destination = std::span(buffer).subspan(alignment, size);
+
+            ctsha::context<algorithm_t> whole;
+            ctsha::copy_and_hash(destination, source, whole);
+            check(whole.digest() == expected, description + " (digest)");
+            check(std::equal(destination.begin(), destination.end(), source.begin()), description + " (copy)");
+
+            std::fill(buffer.begin(), buffer.end(), std::byte{0});
+            ctsha::context<algorithm_t> split;
+            std::size_t first = size / 3;
+            ctsha::copy_and_hash(destination.first(first), std::span(source).first(first), split);
+            ctsha::copy_and_hash(destination.subspan(first), std::span(source).subspan(first), split);
+            check(split.digest() == expected, description + " in two pieces (digest)");
+            check(std::equal(destination.begin(), destination.end(), source.begin()),
+                  description + " in two pieces (copy)");
+        }
+    }
+
+    try {
+        std::array<std::byte, 2> destination{};
+        ctsha::context<algorithm_t> ctx;
+        ctsha::copy_and_hash(destination, "abc"_bytes, ctx);
+        check(false, "copying to a destination that is too small");
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+/// Checks the single-block fast paths of the functions that hash a whole message, which are taken for messages of up
+/// to 55 bytes (or 111 bytes for the algorithms with 64-bit words), against the streaming interface.
+void check_single_block() {
+    auto data = test_data(130);
+    for (std::size_t size = 0; size <= data.size(); ++size) {
+        auto message = std::span<const std::byte>(data).first(size);
+        auto description = "single block fast path with " + std::to_string(size) + " bytes";
+        check(ctsha::sha1(message) == ctsha::context<ctsha::algorithms::sha1>().update(message).digest(),
+              description + " (SHA-1)");
+        check(ctsha::sha224(message) == ctsha::context<ctsha::algorithms::sha224>().update(message).digest(),
+              description + " (SHA-224)");
+        check(ctsha::sha256(message) == ctsha::context<ctsha::algorithms::sha256>().update(message).digest(),
+              description + " (SHA-256)");
+        check(ctsha::sha384(message) == ctsha::context<ctsha::algorithms::sha384>().update(message).digest(),
+              description + " (SHA-384)");
+        check(ctsha::sha512(message) == ctsha::context<ctsha::algorithms::sha512>().update(message).digest(),
+              description + " (SHA-512)");
+        check(ctsha::sha512_t<256>(message) ==
+                  ctsha::context<ctsha::algorithms::sha512_t<256>>().update(message).digest(),
+              description + " (SHA-512/256)");
+    }
+
+    // The fixed-size functions take the same path at runtime for short messages.
+    std::array<std::byte, 32> digest{};
+    std::copy(data.begin(), data.begin() + 32, digest.begin());
+    check(ctsha::sha256_32(digest) == ctsha::sha256(std::span<const std::byte>(digest)), "sha256_32");
+    check(ctsha::sha256(digest) == ctsha::sha256(std::span<const std::byte>(digest)), "32-byte array");
+    std::array<std::byte, 111> longest{};
+    std::copy(data.begin(), data.begin() + 111, longest.begin());
+    check(ctsha::sha512(longest) == ctsha::sha512(std::span<const std::byte>(longest)), "111-byte array");
+    check(ctsha::sha256d(longest) == ctsha::sha256(ctsha::sha256(std::span<const std::byte>(longest))), "sha256d");
+}
+
+/// Checks the functions that hash fixed-size arrays of more than one block, which go to the runtime kernels, against
+/// the streaming interface.
+///
+/// @tparam sizes The sizes of array to check.
+template <std::size_t... sizes>
+void check_arrays() {
+    auto data = test_data(std::max({sizes...}));
+    auto check_size = [&data]<std::size_t size>() {
+        std::array<std::byte, size> message{};
+        std::copy_n(data.begin(), size, message.begin());
+        auto span = std::span<const std::byte>(message);
+        auto description = std::to_string(size) + "-byte array";
+        check(ctsha::sha1(message) == ctsha::sha1(span), description + " (SHA-1)");
+        check(ctsha::sha224(message) == ctsha::sha224(span), description + " (SHA-224)");
+        check(ctsha::sha256(message) == ctsha::sha256(span), description + " (SHA-256)");
+        check(ctsha::sha384(message) == ctsha::sha384(span), description + " (SHA-384)");
+        check(ctsha::sha512(message) == ctsha::sha512(span), description + " (SHA-512)");
+        check(ctsha::sha512_t<256>(message) == ctsha::sha512_t<256>(span), description + " (SHA-512/256)");
+        check(ctsha::sha256d(message) == ctsha::sha256(ctsha::sha256(span)), description + " (double SHA-256)");
+        if constexpr (size == 32)
+            check(ctsha::sha256_32(message) == ctsha::sha256(span), description + " (sha256_32)");
+        if constexpr (size == 64)
+            check(ctsha::sha256_64(message) == ctsha::sha256(span), description + " (sha256_64)");
+    };
+    (check_size.template operator()<sizes>(), ...);
+}
+
+/// Checks hashing messages in pieces, both as separate arguments and as scatter/gather arrays, with pieces that start
+/// and end at every offset within a block.
+void check_parts() {
+    for (std::size_t size : {0, 1, 55, 64, 100, 129, 1000}) {
+        auto message = test_data(size);
+        auto description = std::to_string(size) + " bytes in pieces";
+        for (std::size_t first = 0; first <= size; first += (first < 130 ? 1 : 97)) {
+            std::size_t second = (size - first) / 2;
+            auto header = std::span<const std::byte>(message).first(first);
+            auto payload = std::span<const std::byte>(message).subspan(first, second);
+            auto trailer = std::span<const std::byte>(message).subspan(first + second);
+            check(ctsha::sha256(header, payload, trailer) == ctsha::sha256(std::span<const std::byte>(message)),
+                  description + " (SHA-256)");
+            check(ctsha::sha512(header, payload, trailer) == ctsha::sha512(std::span<const std::byte>(message)),
+                  description + " (SHA-512)");
+#if __has_include(<sys/uio.h>)
+            std::vector<iovec> buffers;
+            for (auto part : {header, payload, trailer})
+                buffers.push_back({const_cast<std::byte*>(part.data()), part.size()});
+            check(ctsha::context<ctsha::algorithms::sha1>().update(buffers).digest() ==
+                      ctsha::sha1(std::span<const std::byte>(message)),
+                  description + " (iovec)");
+#endif
+        }
+    }
+    std::vector<std::byte> header{std::byte{'a'}};
+    constexpr auto payload = "b"_bytes;
+    check(ctsha::sha224(header, payload, std::span(payload).first(0), "c"_bytes) == "abc"_sha224,
+          "mixed piece types");
+}
+
+/// Checks that a context serialized part way through a message can be resumed, and that blobs which are corrupt or
+/// for a different algorithm are rejected.
+///
+/// @tparam algorithm_t The algorithm to check.
+template <typename algorithm_t>
+void check_serialize() {
+    using context_t = ctsha::context<algorithm_t>;
+    auto message = test_data(1000);
+    auto expected = context_t().update(message).digest();
+    for (std::size_t split : {0, 1, 55, 64, 111, 128, 129, 999, 1000}) {
+        auto description = "resuming after " + std::to_string(split) + " bytes";
+        auto blob = context_t().update(std::span(message).first(split)).serialize();
+        check(blob.size() == context_t::serialized_header_bytes + split % context_t::block_bytes,
+              description + " (size)");
+        check(blob.size() <= context_t::max_serialized_bytes, description + " (max size)");
+        auto resumed = context_t::deserialize(blob);
+        check(resumed.serialize() == blob, description + " (round trip)");
+        check(resumed.update(std::span(message).subspan(split)).digest() == expected, description);
+    }
+
+    auto blob = context_t().update(std::span(message).first(70)).serialize();
+    auto rejects = [&](std::vector<std::byte> corrupt, const std::string& description) {
+        try {
+            context_t::deserialize(corrupt);
+            check(false, description);
+        } catch (const std::invalid_argument&) {
+        }
+    };
+    rejects({}, "deserializing an empty blob");
+    rejects(std::vector(blob.begin(), blob.end() - 1), "deserializing a truncated blob");
+    auto other_version = blob;
+    other_version.front() = std::byte{2};
+    rejects(other_version, "deserializing a blob of another version");
+    auto other_algorithm = ctsha::context<ctsha::algorithms::sha512_t<224>>().serialize();
+    rejects(other_algorithm, "deserializing a blob of another algorithm");
+}
+
+/// Checks that the usage counters count the calls to the compression functions on every thread, or count nothing if
+/// they are compiled out.
+void check_usage_counters() {
+    using ctsha::compression_function;
+    auto message = test_data(1000);
+    for (std::size_t i = 0; i < ctsha::detail::backend_names.size(); ++i) {
+        auto kernels = static_cast<ctsha::backend>(i);
+        if (!ctsha::backend_supported(kernels))
+            continue;
+        ctsha::set_backend(kernels);
+        auto sha256_kernels = ctsha::active_backend<ctsha::algorithms::sha256>();
+        auto sha512_kernels = ctsha::active_backend<ctsha::algorithms::sha512>();
+        auto before = ctsha::usage_counters();
+
+        // Each thread hashes 1000 bytes with each algorithm, which takes two calls: one for the 15 whole blocks of 64
+        // bytes (or 7 of 128 bytes), and one for the final block with the padding.
+        constexpr std::size_t num_threads = 4;
+        std::vector<std::thread> threads;
+        for (std::size_t thread = 0; thread < num_threads; ++thread) {
+            threads.emplace_back([&]() {
+                ctsha::sha1(std::span<const std::byte>(message));
+                ctsha::sha256(std::span<const std::byte>(message));
+                ctsha::sha512(std::span<const std::byte>(message));
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        auto after = ctsha::usage_counters();
+        auto description = "usage counters with the " + std::string(ctsha::backend_name(kernels)) + " backend";
+        auto counted = [&](compression_function function, ctsha::backend source, std::size_t whole_blocks_bucket) {
+            const auto& old_counts = before.at(function, source);
+            const auto& new_counts = after.at(function, source);
+            std::uint64_t calls = CTSHA_COUNTERS ? num_threads : 0;
+            return new_counts.bytes - old_counts.bytes == 1024 * calls &&
+                   new_counts.calls - old_counts.calls == 2 * calls &&
+                   new_counts.calls_by_size.at(0) - old_counts.calls_by_size.at(0) == calls &&
+                   new_counts.calls_by_size.at(whole_blocks_bucket) -
+                           old_counts.calls_by_size.at(whole_blocks_bucket) == calls;
+        };
+        check(counted(compression_function::sha1, ctsha::backend::portable, 3), description + " (SHA-1)");
+        check(counted(compression_function::sha256, sha256_kernels, 3), description + " (SHA-256)");
+        check(counted(compression_function::sha512, sha512_kernels, 2), description + " (SHA-512)");
+
+        // Updates that leave less than a block buffered must not count a call. 100 updates of 10 bytes fill 15 blocks
+        // one at a time, and the padding goes in one more block.
+        before = ctsha::usage_counters();
+        ctsha::context<ctsha::algorithms::sha256> ctx;
+        for (std::size_t offset = 0; offset < message.size(); offset += 10)
+            ctx.update(std::span(message).subspan(offset, 10));
+        ctx.digest();
+        after = ctsha::usage_counters();
+        std::uint64_t calls = CTSHA_COUNTERS ? 16 : 0;
+        const auto& old_counts = before.at(compression_function::sha256, sha256_kernels);
+        const auto& new_counts = after.at(compression_function::sha256, sha256_kernels);
+        check(new_counts.bytes - old_counts.bytes == 64 * calls && new_counts.calls - old_counts.calls == calls &&
+                  new_counts.calls_by_size.at(0) - old_counts.calls_by_size.at(0) == calls,
+              description + " (small updates)");
+
+        // Arrays are hashed like spans: the 15 whole blocks in one call and the padding in another. A 64-byte message
+        // and its padding block take one more call, and an RFC 6962 node hash takes two calls of one block each.
+        std::array<std::byte, 1000> array{};
+        before = ctsha::usage_counters();
+        ctsha::sha256(array);
+        ctsha::sha256_64(std::array<std::byte, 64>{});
+        ctsha::merkle_node_hash({}, {});
+        after = ctsha::usage_counters();
+        calls = CTSHA_COUNTERS ? 5 : 0;
+        const auto& old_array_counts = before.at(compression_function::sha256, sha256_kernels);
+        const auto& new_array_counts = after.at(compression_function::sha256, sha256_kernels);
+        check(new_array_counts.bytes - old_array_counts.bytes == 256 * calls &&
+                  new_array_counts.calls - old_array_counts.calls == calls,
+              description + " (array)");
+    }
+    ctsha::set_backend(std::nullopt);
+}
+
+/// Checks the batch functions against hashing one message at a time. Besides the static_asserts in ctsha_tests.cpp,
+/// this makes sure the runtime versions, which have tracing probes, are built and run.
+void check_batches() {
+    std::vector<std::array<std::byte, 80>> messages(5);
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        std::copy_n(test_data(80 + i).begin() + static_cast<std::ptrdiff_t>(i), 80, messages.at(i).begin());
+    std::vector<std::array<std::byte, 32>> digests(messages.size());
+    ctsha::sha256d(std::span<const std::array<std::byte, 80>>(messages), std::span(digests));
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        check(digests.at(i) == ctsha::sha256d(messages.at(i)), "batch sha256d " + std::to_string(i));
+
+    std::vector<std::array<std::byte, 32>> scratch(3);
+    auto root = ctsha::merkle_root(digests, scratch);
+    auto left = ctsha::sha256(digests.at(0), digests.at(1));
+    auto right = ctsha::sha256(digests.at(2), digests.at(3));
+    check(root == ctsha::sha256(ctsha::sha256(left, right), digests.at(4)), "Merkle root");
+}
+
+/// Checks merkle_root against hashing one node at a time, for small trees with odd-sized levels and for one large
+/// tree.
+void check_merkle_root() {
+    for (std::size_t num_leaves : {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000}) {
+        std::vector<std::array<std::byte, 32>> level(num_leaves);
+        for (std::size_t i = 0; i < level.size(); ++i)
+            level.at(i) = ctsha::sha256(std::span<const std::byte>(test_data(i)));
+        std::vector<std::array<std::byte, 32>> scratch((num_leaves + 1) / 2);
+        auto root = ctsha::merkle_root(level, scratch);
+
+        auto expected = ctsha::sha256(std::span<const std::byte>());
+        while (level.size() > 1) {
+            std::vector<std::array<std::byte, 32>> parents;
+            for (std::size_t i = 0; i + 1 < level.size(); i += 2)
+                parents.push_back(ctsha::sha256(std::span<const std::byte>(level.at(i)), level.at(i + 1)));
+            if (level.size() % 2 != 0)
+                parents.push_back(level.back());
+            level = parents;
+        }
+        if (!level.empty())
+            expected = level.front();
+        check(root == expected, "Merkle root of " + std::to_string(num_leaves) + " leaves");
+    }
+
+    auto left = ctsha::sha256(std::span<const std::byte>(test_data(1)));
+    auto right = ctsha::sha256(std::span<const std::byte>(test_data(2)));
+    auto node = ctsha::context<ctsha::algorithms::sha256>().update(std::array{std::byte{0x01}});
+    check(ctsha::merkle_node_hash(left, right) == node.update(left).update(right).digest(), "RFC 6962 node hash");
+}
+
+/// Checks hashing with the USDT probes enabled, by setting their semaphores as an attached tracer would. The probes
+/// then compute their arguments and run their nops, which must not change any results.
+void check_probes() {
+#if CTSHA_PROBES
+    namespace detail = ctsha::detail;
+    std::array semaphores{&detail::hash_entry_semaphore,   &detail::hash_return_semaphore,
+                          &detail::update_entry_semaphore, &detail::update_return_semaphore,
+                          &detail::digest_entry_semaphore, &detail::digest_return_semaphore,
+                          &detail::batch_entry_semaphore,  &detail::batch_return_semaphore};
+    for (auto* semaphore : semaphores)
+        *semaphore = 1;
+    auto message = test_data(1000);
+    check(ctsha::sha256(std::span<const std::byte>(message)) ==
+              ctsha::context<ctsha::algorithms::sha256>().update(message).digest(),
+          "hashing with the probes enabled");
+    check_arrays<32, 64, 1000>();
+    check_batches();
+    for (auto* semaphore : semaphores)
+        *semaphore = 0;
+#endif
+}
+
+/// Checks SHA-512/t with t chosen at runtime against the compile-time version, for several values of t.
+///
+/// @tparam hash_bits The values of t to compare with.
+template <std::size_t... hash_bits>
+void check_runtime_sha512_t() {
+    for (std::size_t size : {0, 3, 111, 112, 128, 1000}) {
+        auto message = test_data(size);
+        auto check_bits = [&](auto expected, std::size_t bits) {
+            auto digest = ctsha::sha512_t(bits, message);
+            check(std::equal(digest.begin(), digest.end(), expected.begin(), expected.end()),
+                  "SHA-512/" + std::to_string(bits) + " of " + std::to_string(size) + " bytes");
+        };
+        (check_bits(ctsha::sha512_t<hash_bits>(std::span<const std::byte>(message)), hash_bits), ...);
+    }
+
+    // Every thread computes the same vectors at the same time, and they must all agree.
+    std::vector<std::vector<std::vector<std::byte>>> results(4);
+    std::vector<std::thread> threads;
+    for (auto& result : results)
+        threads.emplace_back([&result]() {
+            for (std::size_t bits = 1; bits < 512; ++bits)
+                result.push_back(bits == 384 ? std::vector<std::byte>{} : ctsha::sha512_t(bits, "abc"_bytes));
+        });
+    for (auto& thread : threads)
+        thread.join();
+    for (const auto& result : results)
+        check(result == results.front(), "SHA-512/t from several threads");
+    constexpr auto expected = "abc"_sha512_256;
+    check(results.front().at(255) == std::vector<std::byte>(expected.begin(), expected.end()),
+          "SHA-512/256 from the table");
+
+    for (std::size_t bits : {0, 384, 512, 1000}) {
+        try {
+            ctsha::sha512_t(bits, "abc"_bytes);
+            check(false, "SHA-512/" + std::to_string(bits));
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    try {
+        std::array<std::byte, 31> digest{};
+        ctsha::sha512_t(256, "abc"_bytes, digest);
+        check(false, "SHA-512/t with the wrong digest size");
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+/// Processes blocks of a SHA-2 message with the constexpr functions, to check the runtime kernels against.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param state  The intermediate hash value, which is updated in place.
+/// @param blocks The blocks, in big endian byte order.
+template <typename word_t>
+void reference_compress(std::array<word_t, 8>& state, std::span<const std::byte> blocks) {
+    constexpr std::size_t block_bytes = sizeof(ctsha::detail::block_t<word_t>);
+    constexpr const auto& constants = ctsha::detail::sha2_constants<word_t>();
+    for (; !blocks.empty(); blocks = blocks.subspan(block_bytes)) {
+        auto block = ctsha::detail::from_bytes<std::endian::big, word_t>(blocks.first<block_bytes>());
+        ctsha::detail::sha2_compress(
+            state, ctsha::detail::sha2_add_constants(ctsha::detail::sha2_message_schedule<constants.size()>(block),
+                                                     constants));
+    }
+}
+
+#if defined(CTSHA_X86_KERNELS)
+/// Checks the interleaved SHA extensions kernel against the constexpr functions, with each message starting from a
+/// different state.
+///
+/// @tparam ways The number of messages to interleave.
+template <std::size_t ways>
+void check_shani() {
+    constexpr std::size_t num_blocks = 5;
+    auto data = test_data(ways * num_blocks * 64 + 1);
+    std::array<std::array<std::uint32_t, 8>, ways> states{};
+    std::array<std::array<std::uint32_t, 8>*, ways> state_pointers{};
+    std::array<const std::byte*, ways> blocks{};
+    for (std::size_t way = 0; way < ways; ++way) {
+        states.at(way) = ctsha::detail::sha256_initialization_vector;
+        states.at(way).at(way % 8) += static_cast<std::uint32_t>(way);
+        state_pointers.at(way) = &states.at(way);
+        blocks.at(way) = data.data() + 1 + way * num_blocks * 64; // Deliberately misaligned.
+    }
+    auto expected = states;
+    for (std::size_t way = 0; way < ways; ++way)
+        reference_compress(expected.at(way), std::span(blocks.at(way), num_blocks * 64));
+
+    ctsha::detail::shani::sha256_compress<ways>(state_pointers, blocks, num_blocks);
+    check(states == expected, std::to_string(ways) + "-way SHA extensions kernel");
+}
+
+/// Checks a kernel against the constexpr functions, with both even and odd numbers of blocks.
+///
+/// @tparam word_t The type of words used by the algorithm.
+///
+/// @param kernel The kernel.
+/// @param name   The name of the kernel.
+template <typename word_t>
+void check_kernel(void (*kernel)(std::array<word_t, 8>&, std::span<const std::byte>), const std::string& name) {
+    constexpr std::size_t block_bytes = sizeof(ctsha::detail::block_t<word_t>);
+    for (std::size_t num_blocks : {1, 2, 3, 6, 17}) {
+        auto data = test_data(num_blocks * block_bytes + 1);
+        auto blocks = std::span(data).subspan(1); // Deliberately misaligned.
+        std::array<word_t, 8> state{};
+        for (std::size_t i = 0; i < state.size(); ++i)
+            state.at(i) = static_cast<word_t>(0x0123456789abcdef * (i + 1));
+        auto expected = state;
+        reference_compress(expected, blocks);
+        kernel(state, blocks);
+        check(state == expected, name + " kernel with " + std::to_string(num_blocks) + " blocks of " +
+                                     std::to_string(sizeof(word_t) * 8) + "-bit words");
+    }
+}
+#endif
+
+/// Checks the runtime kernels that the CPU supports against the constexpr functions.
+void check_kernels() {
+#if defined(CTSHA_X86_KERNELS)
+    if (ctsha::detail::cpu_features().sha) {
+        check_shani<1>();
+        check_shani<2>();
+    } else {
+        std::cout << "Skipping the SHA extensions kernel tests because the CPU does not support them" << std::endl;
+    }
+    if (ctsha::detail::cpu_features().avx2 && ctsha::detail::cpu_features().bmi2) {
+        check_kernel<std::uint32_t>(ctsha::detail::avx2::sha2_compress_blocks, "AVX2");
+        check_kernel<std::uint64_t>(ctsha::detail::avx2::sha2_compress_blocks, "AVX2");
+    } else {
+        std::cout << "Skipping the AVX2 kernel tests because the CPU does not support them" << std::endl;
+    }
+    if (ctsha::detail::cpu_features().avx512 && ctsha::detail::cpu_features().bmi2)
+        check_kernel<std::uint64_t>(ctsha::detail::avx512::sha512_compress_blocks, "AVX-512");
+    else
+        std::cout << "Skipping the AVX-512 kernel tests because the CPU does not support them" << std::endl;
+#endif
+
+    // Whichever kernel is in use, whole blocks must give the same results as the constexpr functions.
+    for (std::size_t size : {0, 128, 1024, 100096}) {
+        auto data = test_data(size);
+        auto description = "kernel with " + std::to_string(size) + " bytes";
+        std::array<std::uint32_t, 8> state256 = ctsha::detail::sha256_initialization_vector;
+        std::array<std::uint32_t, 8> expected256 = state256;
+        ctsha::detail::sha2_compress_blocks(state256, data);
+        reference_compress(expected256, data);
+        check(state256 == expected256, description + " (SHA-256 blocks)");
+        std::array<std::uint64_t, 8> state512 = ctsha::detail::sha512_initialization_vector;
+        std::array<std::uint64_t, 8> expected512 = state512;
+        ctsha::detail::sha2_compress_blocks(state512, data);
+        reference_compress(expected512, data);
+        check(state512 == expected512, description + " (SHA-512 blocks)");
+    }
+}
+
+/// Forces each backend the CPU supports in turn, and checks that the algorithms use the right kernels and still give
+/// the right results.
+void check_backends() {
+    using ctsha::backend;
+    for (std::size_t i = 0; i < ctsha::detail::backend_names.size(); ++i) {
+        auto kernels = static_cast<backend>(i);
+        auto name = std::string(ctsha::backend_name(kernels));
+        check(ctsha::detail::parse_backend(name) == kernels, "parsing the name of the " + name + " backend");
+        if (!ctsha::backend_supported(kernels)) {
+            std::cout << "Skipping the " << name << " backend because the CPU does not support it" << std::endl;
+            try {
+                ctsha::set_backend(kernels);
+                check(false, "forcing the unsupported " + name + " backend");
+            } catch (const std::invalid_argument&) {
+            }
+            continue;
+        }
+
+        ctsha::set_backend(kernels);
+        bool has_sha256 = kernels != backend::avx512;
+        bool has_sha512 = kernels != backend::sha_ni;
+        check(ctsha::active_backend<ctsha::algorithms::sha1>() == backend::portable, name + " backend (SHA-1)");
+        check(ctsha::active_backend<ctsha::algorithms::sha224>() == (has_sha256 ? kernels : backend::portable),
+              name + " backend (SHA-224)");
+        check(ctsha::active_backend<ctsha::algorithms::sha512_t<256>>() == (has_sha512 ? kernels : backend::portable),
+              name + " backend (SHA-512/256)");
+        check_copy_and_hash<ctsha::algorithms::sha256>();
+        check_copy_and_hash<ctsha::algorithms::sha512>();
+        check_single_block();
+        check_arrays<56, 63, 64, 65, 112, 119, 128, 200, 1000>();
+        check_batches();
+        check_merkle_root();
+    }
+
+    ctsha::set_backend(std::nullopt);
+    check(ctsha::active_backend<ctsha::algorithms::sha256>() ==
+              (ctsha::backend_supported(backend::sha_ni) ? backend::sha_ni
+               : ctsha::backend_supported(backend::avx2) ? backend::avx2
+                                                          : backend::portable),
+          "fastest SHA-256 backend");
+    check(ctsha::active_backend<ctsha::algorithms::sha512>() ==
+              (ctsha::backend_supported(backend::avx512) ? backend::avx512
+               : ctsha::backend_supported(backend::avx2) ? backend::avx2
+                                                          : backend::portable),
+          "fastest SHA-512 backend");
+
+    try {
+        ctsha::detail::parse_backend("sse9");
+        check(false, "parsing an unknown backend");
+    } catch (const std::invalid_argument&) {
+    }
+}
+
+} // End anonymous namespace.
+
+int main() {
+    try {
+        check_kernels();
+        check_backends();
+        check_single_block();
+        check_arrays<56, 63, 64, 65, 112, 119, 128, 200, 1000>();
+        check_runtime_sha512_t<1, 8, 100, 128, 200, 224, 256, 264, 383, 385, 504, 511>();
+        check_parts();
+        check_batches();
+        check_merkle_root();
+        check_probes();
+        check_usage_counters();
+        check_serialize<ctsha::algorithms::sha1>();
+        check_serialize<ctsha::algorithms::sha256>();
+        check_serialize<ctsha::algorithms::sha512_t<256>>();
+        check_copy_and_hash<ctsha::algorithms::sha1>();
+        check_copy_and_hash<ctsha::algorithms::sha256>();
+        check_copy_and_hash<ctsha::algorithms::sha512>();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ++failures;
+    }
+
+    std::cout << "Runtime tests " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,246 @@
+/// A deadline-aware scheduler that chooses, for each message, between hashing it right away on its own and batching it
+/// with other messages in a job_manager. Batching keeps more lanes busy, so it gets through more messages per second,
+/// but a message waits in its batch until the lanes fill or the batch is flushed. Each message is submitted with a
+/// deadline. A message whose deadline is close is hashed on its own straight away, and any other message is batched.
+/// A batch is flushed once its oldest message has waited for the flush interval, or when the deadline of a message in
+/// it gets close.
+///
+/// The scheduler does not start any threads, so the flush interval is only noticed when poll is called. An event loop
+/// can use next_poll to find out when that needs to be. The latency of each message, from submit until its digest is
+/// delivered, is recorded in a histogram for each of the two ways of hashing, so the margin and flush interval can be
+/// tuned. This header is runtime-only.
+
+#pragma once
+
+#include "ctsha_job_manager.hpp"
+
+#include <bit>
+#include <chrono>
+#include <functional>
+
+namespace ctsha {
+
+/// A histogram of latencies, with buckets whose bounds are powers of two nanoseconds.
+class latency_histogram {
+public:
+    /// The number of buckets. Bucket i counts latencies of at least 2^(i - 1) and less than 2^i nanoseconds, except
+    /// that bucket 0 counts latencies of less than a nanosecond.
+    static constexpr std::size_t num_buckets = 64;
+
+    /// Records a latency.
+    ///
+    /// @param latency The latency.
+    void record(std::chrono::nanoseconds latency) {
+        auto nanoseconds = static_cast<std::uint64_t>(std::max(latency.count(), std::chrono::nanoseconds::rep{0}));
+        ++buckets_.at(std::min<std::size_t>(std::bit_width(nanoseconds), num_buckets - 1));
+        ++count_;
+    }
+
+    /// @returns The number of latencies recorded.
+    std::uint64_t count() const {
+        return count_;
+    }
+
+    /// @param index The index of a bucket.
+    ///
+    /// @returns The number of latencies recorded in the bucket.
+    std::uint64_t bucket(std::size_t index) const {
+        return buckets_.at(index);
+    }
+
+    /// Finds an upper bound for a quantile of the latencies, such as the 99th percentile.
+    ///
+    /// @param fraction The fraction of latencies that are less than the result, between 0 and 1.
+    ///
+    /// @returns The upper bound of the bucket containing the quantile, or zero if no latencies have been recorded.
+    std::chrono::nanoseconds quantile(double fraction) const {
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < num_buckets && count_ > 0; ++i) {
+            seen += buckets_.at(i);
+            if (static_cast<double>(seen) >= fraction * static_cast<double>(count_))
+                return std::chrono::nanoseconds{std::int64_t{1} << std::min<std::size_t>(i, 62)};
+        }
+        return std::chrono::nanoseconds{0};
+    }
+
+private:
+    /// The number of latencies in each bucket.
+    std::array<std::uint64_t, num_buckets> buckets_{};
+
+    /// The total number of latencies recorded.
+    std::uint64_t count_ = 0;
+};
+
+/// Hashes messages either on their own or in batches, depending on their deadlines. See the top of this file.
+///
+/// @tparam algorithm_t The algorithm to use, which must be one of the SHA-2 algorithms, for example
+///                     ctsha::algorithms::sha256.
+template <typename algorithm_t>
+class scheduler {
+public:
+    /// The clock used for deadlines.
+    using clock = std::chrono::steady_clock;
+
+    /// The type of the digest produced by the algorithm.
+    using digest_t = typename job_manager<algorithm_t>::digest_t;
+
+    /// The type of function that receives the results of jobs. It is called with the id that submit returned for the
+    /// job and the digest of the message.
+    using callback_t = std::function<void(std::uint64_t, const digest_t&)>;
+
+    /// The ways a message can be hashed.
+    enum class job_class {
+        /// Hashed on its own as soon as it was submitted, because its deadline was close.
+        single_stream,
+
+        /// Hashed in a batch with other messages.
+        batched,
+    };
+
+    /// Settings that control the trade-off between latency and throughput.
+    struct options {
+        /// A message whose deadline is less than this far away is hashed on its own, and a batch is flushed when the
+        /// deadline of any message in it is less than this far away.
+        clock::duration margin = std::chrono::microseconds{100};
+
+        /// The longest a message waits in a batch that has not filled before the batch is flushed.
+        clock::duration flush_interval = std::chrono::milliseconds{1};
+    };
+
+    /// Creates a scheduler.
+    ///
+    /// @param on_complete The function that receives the results of jobs.
+    /// @param settings    The margin and flush interval.
+    explicit scheduler(callback_t on_complete, options settings = {})
+        : on_complete_(std::move(on_complete)), options_(settings) {}
+
+    /// Submits a message to be hashed. If its deadline is close, it is hashed and its result delivered before this
+    /// returns. Otherwise it is batched, and its result may be delivered during this or any later call to submit,
+    /// poll, or flush.
+    ///
+    /// @param message  The message. It is not copied, so it must stay valid until its result has been delivered.
+    /// @param deadline When the result is needed by.
+    ///
+    /// @returns The id of the job. Jobs are numbered from zero in the order they are submitted.
+    std::uint64_t submit(std::span<const std::byte> message, clock::time_point deadline) {
+        std::uint64_t id = next_id_++;
+        auto now = clock::now();
+        if (deadline - now < options_.margin) {
+            auto digest = context<algorithm_t>().update(message).digest();
+            finish(job_class::single_stream, id, now, deadline, digest);
+        } else {
+            batched_.push_back({id, now, deadline});
+            while (!earliest_deadlines_.empty() && earliest_deadlines_.back().deadline >= deadline)
+                earliest_deadlines_.pop_back();
+            earliest_deadlines_.push_back(batched_.back());
+            manager_.submit(message);
+            deliver();
+        }
+        poll();
+        return id;
+    }
+
+    /// Flushes the batch if its oldest message has waited for the flush interval, or if the deadline of any message in
+    /// it is close. Call this no later than next_poll.
+    void poll() {
+        if (!batched_.empty() && clock::now() >= next_poll())
+            flush();
+    }
+
+    /// Finishes every message that has been submitted, and delivers the results.
+    void flush() {
+        manager_.flush();
+        deliver();
+    }
+
+    /// @returns When poll next needs to be called, or clock::time_point::max() if no messages are waiting.
+    clock::time_point next_poll() const {
+        if (batched_.empty())
+            return clock::time_point::max();
+        return std::min(batched_.front().submitted + options_.flush_interval,
+                        earliest_deadlines_.front().deadline - options_.margin);
+    }
+
+    /// @param type A way of hashing messages.
+    ///
+    /// @returns The latencies of the messages that were hashed that way.
+    const latency_histogram& latencies(job_class type) const {
+        return latencies_.at(static_cast<std::size_t>(type));
+    }
+
+    /// @param type A way of hashing messages.
+    ///
+    /// @returns The number of messages that were hashed that way whose results were delivered after their deadlines.
+    std::uint64_t missed_deadlines(job_class type) const {
+        return missed_deadlines_.at(static_cast<std::size_t>(type));
+    }
+
+private:
+    /// A message that is in the job manager.
+    struct batched_job {
+        /// The id of the job.
+        std::uint64_t id;
+
+        /// When the job was submitted.
+        clock::time_point submitted;
+
+        /// When the result is needed by.
+        clock::time_point deadline;
+    };
+
+    /// Delivers the results of the batched jobs that have completed. The job manager returns results in the order the
+    /// jobs were submitted, which is the order of batched_.
+    void deliver() {
+        while (auto job = manager_.pop()) {
+            auto batched = batched_.front();
+            batched_.pop_front();
+            if (earliest_deadlines_.front().id == batched.id)
+                earliest_deadlines_.pop_front();
+            finish(job_class::batched, batched.id, batched.submitted, batched.deadline, job->digest);
+        }
+    }
+
+    /// Records the latency of a job and delivers its result.
+    ///
+    /// @param type      The way the message was hashed.
+    /// @param id        The id of the job.
+    /// @param submitted When the job was submitted.
+    /// @param deadline  When the result was needed by.
+    /// @param digest    The digest of the message.
+    void finish(job_class type, std::uint64_t id, clock::time_point submitted, clock::time_point deadline,
+                const digest_t& digest) {
+        auto now = clock::now();
+        latencies_.at(static_cast<std::size_t>(type)).record(now - submitted);
+        missed_deadlines_.at(static_cast<std::size_t>(type)) += (now > deadline) ? 1 : 0;
+        on_complete_(id, digest);
+    }
+
+    /// The function that receives the results of jobs.
+    callback_t on_complete_;
+
+    /// The margin and flush interval.
+    options options_;
+
+    /// Hashes the batched messages.
+    job_manager<algorithm_t> manager_;
+
+    /// The messages in the job manager, in the order they were submitted. The front is the one that has waited
+    /// longest.
+    std::deque<batched_job> batched_;
+
+    /// The messages in the job manager whose deadlines are earlier than those of every message submitted after them,
+    /// in the order they were submitted. The front has the earliest deadline of all, so next_poll does not need to look
+    /// at every message.
+    std::deque<batched_job> earliest_deadlines_;
+
+    /// The id of the next job.
+    std::uint64_t next_id_ = 0;
+
+    /// The latencies of each class of job.
+    std::array<latency_histogram, 2> latencies_{};
+
+    /// The number of missed deadlines of each class of job.
+    std::array<std::uint64_t, 2> missed_deadlines_{};
+};
+
+} // End namespace ctsha.
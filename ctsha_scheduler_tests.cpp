@@ -0,0 +1,85 @@
+/// Runtime tests for ctsha_scheduler.hpp. Messages with close and distant deadlines are submitted, and the tests check
+/// which way each one was hashed, when its result was delivered, that the result is right, and that the latency
+/// histograms count every message.
+#include "ctsha_scheduler.hpp"
+#include "ctsha_tests.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ctsha::literals;
+
+int main() {
+    using scheduler_t = ctsha::scheduler<ctsha::algorithms::sha256>;
+    using namespace std::chrono_literals;
+
+    try {
+        std::map<std::uint64_t, scheduler_t::digest_t> results;
+        scheduler_t scheduler([&](std::uint64_t id, const auto& digest) { results[id] = digest; }, {50ms, 200ms});
+        constexpr auto abc = "abc"_bytes;
+        constexpr auto expected = "abc"_sha256;
+        auto now = scheduler_t::clock::now();
+
+        // A message with a close deadline is hashed right away.
+        auto id = scheduler.submit(abc, now);
+        check(results.count(id) == 1 && results.at(id) == expected, "close deadline");
+
+        // Messages with distant deadlines wait until the lanes fill...
+        std::vector<std::uint64_t> ids;
+        for (std::size_t i = 0; i + 1 < ctsha::job_manager<ctsha::algorithms::sha256>::num_lanes; ++i)
+            ids.push_back(scheduler.submit(abc, now + 1h));
+        check(results.size() == 1, "partial batch");
+        ids.push_back(scheduler.submit(abc, now + 1h));
+        check(results.size() == 1 + ids.size(), "full batch");
+        for (auto batched_id : ids)
+            check(results.count(batched_id) == 1 && results.at(batched_id) == expected, "batched result");
+
+        // ...or until the flush interval has passed.
+        results.clear();
+        id = scheduler.submit(abc, scheduler_t::clock::now() + 1h);
+        scheduler.poll();
+        check(results.empty(), "poll before the flush interval");
+        check(scheduler.next_poll() <= scheduler_t::clock::now() + 200ms, "next poll");
+        std::this_thread::sleep_until(scheduler.next_poll());
+        scheduler.poll();
+        check(results.count(id) == 1, "poll after the flush interval");
+
+        // A batch is flushed early if a deadline in it gets close.
+        results.clear();
+        id = scheduler.submit(abc, scheduler_t::clock::now() + 60ms);
+        check(results.empty(), "deadline not close yet");
+        std::this_thread::sleep_for(20ms);
+        scheduler.poll();
+        check(results.count(id) == 1, "deadline close");
+
+        // The next poll is for the earliest deadline in the batch, whatever order the deadlines came in, and forgets
+        // the deadlines of messages that have been delivered.
+        scheduler_t patient([](std::uint64_t, const auto&) {}, {50ms, 24h});
+        auto base = scheduler_t::clock::now();
+        for (auto hours : {10h, 5h, 7h})
+            patient.submit(abc, base + hours);
+        check(patient.next_poll() == base + 5h - 50ms, "next poll for the earliest deadline");
+        while (patient.next_poll() != scheduler_t::clock::time_point::max())
+            patient.submit(abc, base + 9h);
+        patient.submit(abc, base + 8h);
+        check(patient.next_poll() == base + 8h - 50ms, "next poll after a batch is delivered");
+
+        using job_class = scheduler_t::job_class;
+        check(scheduler.latencies(job_class::single_stream).count() == 1, "single stream latency count");
+        check(scheduler.latencies(job_class::batched).count() == ids.size() + 2, "batched latency count");
+        check(scheduler.missed_deadlines(job_class::single_stream) == 1, "missed deadline");
+        check(scheduler.missed_deadlines(job_class::batched) == 0, "no missed deadlines");
+        check(scheduler.latencies(job_class::batched).quantile(1.0) >= 100ms, "slowest batched latency");
+        check(scheduler.latencies(job_class::batched).quantile(0.5) < 100ms, "median batched latency");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ++failures;
+    }
+
+    std::cout << "Scheduler tests " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
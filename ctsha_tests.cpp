@@ -32,6 +32,12 @@ static_assert(ctsha::detail::to_bytes<std::endian::big>   (std::array<std::uint1
 static_assert(ctsha::detail::to_bytes<std::endian::little>(std::array<std::uint16_t, 2>{0x0123, 0x4567}) ==
               "23016745"_hex_bytes);
 
+// Test the "from_bytes" function.
+static_assert(ctsha::detail::from_bytes<std::endian::big,    std::uint16_t>("01234567"_hex_bytes) ==
+              std::array<std::uint16_t, 2>{0x0123, 0x4567});
+static_assert(ctsha::detail::from_bytes<std::endian::little, std::uint16_t>("23016745"_hex_bytes) ==
+              std::array<std::uint16_t, 2>{0x0123, 0x4567});
+
 // Test the "float128_root" function. (Simple tests. Other tests later will test it more thoroughly.)
 static_assert(ctsha::detail::float128_root( 9, 2) == 3);
 static_assert(ctsha::detail::float128_root(27, 3) == 3);
@@ -382,3 +388,189 @@ static_assert("abc"_sha512     == "ddaf35a193617abacc417349ae20413112e6fa4e89a97
                                   "3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"_hex_bytes);
 static_assert("abc"_sha512_224 == "4634270f707b6a54daae7530460842e20e37ed265ceee9a43e8924aa"_hex_bytes);
 static_assert("abc"_sha512_256 == "53048e2681941ef99b2e29b76b4c7dabe4c2d0c634fc6d46e0e2f13107e7af23"_hex_bytes);
+
+// Test the fixed-size SHA-256 functions, and make sure they agree with the generic implementation.
+static_assert(ctsha::sha256_32("abc"_sha256) ==
+              "4f8b42c22dd3729b519ba6f68d2da7cc5b2d606d05daed5ad5128cc03e6c6358"_hex_bytes);
+static_assert(ctsha::sha256_32(std::array<std::byte, 32>{}) ==
+              "66687aadf862bd776c8fc18b8e9f8e20089714856ee233b3902a591d0d5f2925"_hex_bytes);
+static_assert(ctsha::sha256_64("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+                               "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"_hex_bytes) ==
+              "3b771ca97e3c17698aff21227fa046b5622a30d8ee5d2de4ee1111a1cdf258ee"_hex_bytes);
+static_assert(ctsha::sha256_64(std::array<std::byte, 64>{}) ==
+              "f5a5fd42d16a20302798ef6ed309979b43003d2320d9f0e8ea9831a92759fb4b"_hex_bytes);
+static_assert(ctsha::sha256_32("abc"_sha256) ==
+              ctsha::detail::sha2<256>("abc"_sha256, ctsha::detail::sha256_initialization_vector,
+                                       ctsha::detail::sha2_32_bit_constants));
+static_assert(ctsha::sha256_64("abc"_sha512) ==
+              ctsha::detail::sha2<256>("abc"_sha512, ctsha::detail::sha256_initialization_vector,
+                                       ctsha::detail::sha2_32_bit_constants));
+
+// Test the "transpose" function.
+static_assert(ctsha::detail::transpose(std::array{std::array{1, 2, 3}, std::array{4, 5, 6}}) ==
+              std::array{std::array{1, 4}, std::array{2, 5}, std::array{3, 6}});
+
+// Test the double SHA-256 functions. The batch version is tested with more messages than there are lanes so that a
+// partially filled batch is tested too.
+static_assert(ctsha::sha256d(std::array<std::byte, 0>{}) ==
+              "5df6e0e2761359d30a8275058e299fcc0381534545f55cf43e41983f5d4c9456"_hex_bytes);
+static_assert(ctsha::sha256d("abc"_bytes) == ctsha::sha256_32("abc"_sha256));
+static_assert(ctsha::sha256d("abc"_sha512) == ctsha::sha256_32(ctsha::sha256_64("abc"_sha512)));
+static_assert([]() {
+    constexpr std::size_t num_messages = ctsha::detail::sha2_lanes + 3;
+    std::array<std::array<std::byte, 3>, num_messages> messages{};
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        messages.at(i) = {std::byte{'a'}, std::byte{'b'}, static_cast<std::byte>('a' + i)};
+
+    std::array<std::array<std::byte, 32>, num_messages> digests{};
+    ctsha::sha256d(std::span<const std::array<std::byte, 3>>(messages), std::span(digests));
+    for (std::size_t i = 0; i < messages.size(); ++i)
+        if (digests.at(i) != ctsha::sha256d(messages.at(i)))
+            return false;
+    return digests.at(2) == ctsha::sha256d("abc"_bytes);
+}());
+
+// Test the Merkle root functions. Leaf i is the SHA-256 hash of the single byte i. The 17-leaf and 40-leaf trees have
+// enough nodes to fill the lanes of the multi-buffer functions.
+constexpr auto merkle_leaves = []<std::size_t num_leaves>() {
+    std::array<std::array<std::byte, 32>, num_leaves> leaves{};
+    for (std::size_t i = 0; i < leaves.size(); ++i)
+        leaves.at(i) = ctsha::sha256(std::array{static_cast<std::byte>(i)});
+    return leaves;
+};
+static_assert(ctsha::merkle_root(merkle_leaves.operator()<0>()) == ctsha::sha256(std::array<std::byte, 0>{}));
+static_assert(ctsha::merkle_root(merkle_leaves.operator()<1>()) ==
+              "6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d"_hex_bytes);
+static_assert(ctsha::merkle_root(merkle_leaves.operator()<2>()) ==
+              "30e1867424e66e8b6d159246db94e3486778136f7e386ff5f001859d6b8484ab"_hex_bytes);
+static_assert(ctsha::merkle_root(merkle_leaves.operator()<3>()) ==
+              "773a93ac37ea78b3f14ac31872c83886b0a0f1fec562c4e848e023c889c2ce9f"_hex_bytes);
+static_assert(ctsha::merkle_root(merkle_leaves.operator()<5>()) ==
+              "5174b138f822e56503c04bce38e368672593b4a2694466c2e60f1216caf234be"_hex_bytes);
+static_assert(ctsha::merkle_root(merkle_leaves.operator()<17>()) ==
+              "1c9c00e531158d0fef3ed4fd8cdf302bf5e99f83fcba1c176205c2ab92fcde1c"_hex_bytes);
+static_assert(ctsha::merkle_root(merkle_leaves.operator()<40>()) ==
+              "980bff0f00f41bbfbbc35acc5ecf3143089fa5fa90af1b018904abf15d8bcc11"_hex_bytes);
+
+// Hash functions to pass to the test helpers below.
+constexpr auto sha1_hash   = [](const auto& message) { return ctsha::sha1(message); };
+constexpr auto sha256_hash = [](const auto& message) { return ctsha::sha256(message); };
+constexpr auto sha512_hash = [](const auto& message) { return ctsha::sha512(message); };
+
+// Test the streaming interface. Messages around the block and padding boundaries are fed in one piece and one byte at a
+// time, and compared against the fixed-size functions.
+constexpr auto stream_matches = []<typename algorithm_t, std::size_t num_bytes>(auto hash) {
+    auto message = test_array<num_bytes>();
+
+    ctsha::context<algorithm_t> bytewise;
+    for (std::size_t i = 0; i < message.size(); ++i)
+        bytewise.update(std::span(message).subspan(i, 1));
+    auto whole = ctsha::context<algorithm_t>().update(message).digest();
+    return whole == hash(message) && bytewise.digest() == hash(message);
+};
+static_assert(ctsha::context<ctsha::algorithms::sha256>().update("abc"_bytes).digest() == "abc"_sha256);
+static_assert(ctsha::sha1(std::span<const std::byte>("abc"_bytes)) == "abc"_sha1);
+static_assert(ctsha::sha224(std::span<const std::byte>("abc"_bytes)) == "abc"_sha224);
+static_assert(ctsha::sha256(std::span<const std::byte>("abc"_bytes)) == "abc"_sha256);
+static_assert(ctsha::sha384(std::span<const std::byte>("abc"_bytes)) == "abc"_sha384);
+static_assert(ctsha::sha512(std::span<const std::byte>("abc"_bytes)) == "abc"_sha512);
+static_assert(ctsha::sha512_t<224>(std::span<const std::byte>("abc"_bytes)) == "abc"_sha512_224);
+static_assert(ctsha::sha512_t<256>(std::span<const std::byte>("abc"_bytes)) == "abc"_sha512_256);
+
+// A context started from another initial hash value, as the runtime SHA-512/t does.
+static_assert([]() {
+    auto expected = "abc"_sha512_256;
+    auto digest = ctsha::context<ctsha::algorithms::sha512>(ctsha::detail::sha512_t_initialization_vector<256>)
+                      .update("abc"_bytes).digest();
+    return std::equal(expected.begin(), expected.end(), digest.begin());
+}());
+
+static_assert(stream_matches.operator()<ctsha::algorithms::sha1, 55>(sha1_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha1, 64>(sha1_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 0>(sha256_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 55>(sha256_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 56>(sha256_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 64>(sha256_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 129>(sha256_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha512, 111>(sha512_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha512, 112>(sha512_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha512, 128>(sha512_hash));
+
+// The functions that take a span have a fast path for messages that fit in a single block.
+constexpr auto sha1_span_hash   = [](const auto& message) { return ctsha::sha1(std::span(message)); };
+constexpr auto sha256_span_hash = [](const auto& message) { return ctsha::sha256(std::span(message)); };
+constexpr auto sha512_span_hash = [](const auto& message) { return ctsha::sha512(std::span(message)); };
+static_assert(stream_matches.operator()<ctsha::algorithms::sha1, 55>(sha1_span_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha1, 56>(sha1_span_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 0>(sha256_span_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 55>(sha256_span_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha256, 56>(sha256_span_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha512, 111>(sha512_span_hash));
+static_assert(stream_matches.operator()<ctsha::algorithms::sha512, 112>(sha512_span_hash));
+
+// Messages in pieces are hashed as if the pieces were concatenated, including pieces that end part way through a block.
+static_assert(ctsha::sha256("a"_bytes, "b"_bytes, "c"_bytes) == "abc"_sha256);
+static_assert(ctsha::sha1("ab"_bytes, "c"_bytes) == "abc"_sha1);
+static_assert(ctsha::sha224("a"_bytes, "bc"_bytes) == "abc"_sha224);
+static_assert(ctsha::sha384("abc"_bytes, ""_bytes) == "abc"_sha384);
+static_assert(ctsha::sha512(""_bytes, "abc"_bytes) == "abc"_sha512);
+static_assert(ctsha::sha512_t<224>("a"_bytes, "b"_bytes, "c"_bytes) == "abc"_sha512_224);
+static_assert(ctsha::sha256("abcdbcdecdefdefgefghfghighij"_bytes, "hijkijkljklmklmnlmnomnopnopq"_bytes) ==
+              "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"_sha256);
+static_assert([]() {
+    auto message = test_array<200>();
+    auto header = std::span(message).first(13);
+    auto payload = std::span(message).subspan(13, 150);
+    auto trailer = std::span(message).subspan(163);
+    return ctsha::sha256(header, payload, trailer) == ctsha::sha256(message) &&
+           ctsha::sha512(header, payload, trailer) == ctsha::sha512(message);
+}());
+
+// Test checkpointing a context part way through a block and resuming it.
+static_assert([]() {
+    auto message = test_array<200>();
+
+    using sha384_context = ctsha::context<ctsha::algorithms::sha384>;
+    auto blob = sha384_context().update(std::span(message).first(150)).serialize();
+    auto resumed = sha384_context::deserialize(blob).update(std::span(message).subspan(150)).digest();
+    return blob.size() == sha384_context::serialized_header_bytes + 22 && resumed == ctsha::sha384(message);
+}());
+static_assert([]() {
+    using sha1_context = ctsha::context<ctsha::algorithms::sha1>;
+    auto blob = sha1_context().update("ab"_bytes).serialize();
+    return sha1_context::deserialize(blob).update("c"_bytes).digest() == "abc"_sha1;
+}());
+
+// Test hashing with several algorithms at once.
+static_assert(ctsha::multi_hash<ctsha::algorithms::sha1, ctsha::algorithms::sha256, ctsha::algorithms::sha512>(
+                  "abc"_bytes) == std::tuple{"abc"_sha1, "abc"_sha256, "abc"_sha512});
+static_assert([]() {
+    auto message = test_array<130>();
+
+    ctsha::multi_hasher<ctsha::algorithms::sha224, ctsha::algorithms::sha384> hasher;
+    hasher.update(std::span(message).first(1)).update(std::span(message).subspan(1, 64)).update(
+        std::span(message).subspan(65));
+    return hasher.digest<ctsha::algorithms::sha224>() == ctsha::sha224(message) &&
+           hasher.digest<ctsha::algorithms::sha384>() == ctsha::sha384(message);
+}());
+
+// Test copying a message while hashing it, including into a context that already holds part of a block.
+static_assert([]() {
+    auto message = test_array<130>();
+
+    std::array<std::byte, 129> destination{};
+    ctsha::context<ctsha::algorithms::sha256> ctx;
+    ctx.update(std::span(message).first(1));
+    ctsha::copy_and_hash(destination, std::span(message).subspan(1), ctx);
+    return ctx.digest() == ctsha::sha256(message) &&
+           std::equal(destination.begin(), destination.end(), message.begin() + 1);
+}());
+
+// Test the Monte Carlo Test checkpoint helper with a couple of iterations. (The full 1000-iteration checkpoints are run
+// against the FIPS test vectors by the test script.)
+static_assert(monte_carlo_checkpoint(sha1_hash, "abc"_sha1, 1) == "3df69147893a17f0b7192a41dac2230a2d132cc8"_hex_bytes);
+static_assert(monte_carlo_checkpoint(sha1_hash, "abc"_sha1, 2) == "5f0a0dc51c4db47133a705b201b55749b6555795"_hex_bytes);
+static_assert(monte_carlo_checkpoint(sha256_hash, "abc"_sha256, 1) ==
+              "832e3fd3ca9fc0ee00b14515851db22a4013b25190020c68cdd85267e0bb01b7"_hex_bytes);
+static_assert(monte_carlo_checkpoint(sha256_hash, "abc"_sha256, 2) ==
+              "885769d819a757efeef0227ec7ffe81f536ffa57055b0b8a7ea81b93b1c277d7"_hex_bytes);
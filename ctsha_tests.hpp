@@ -1,9 +1,13 @@
 /// Utility functions used only by the ctsha tests.
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <iostream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 /// Allows easier, more readable declaration of std::array<std::byte> using a string literal where the string literal is
 /// interpreted as hex digits.
@@ -45,3 +49,64 @@ template <typename char_t, char_t... chars>
 static constexpr std::array<std::byte, sizeof...(chars)> operator "" _bytes() {
     return std::array<std::byte, sizeof...(chars)>{std::byte{chars}...};
 }
+
+/// Runs one checkpoint of the Monte Carlo Test (MCT) defined in section 6.4 of The Secure Hash Algorithm Validation
+/// System (SHAVS). Each iteration hashes the concatenation of the previous three digests, starting from three copies of
+/// the seed. The full test runs 100 checkpoints, using the result of each one as the seed for the next.
+///
+/// @tparam hash_t       The type of the hash function. It must accept a std::array<std::byte, 3 * digest_bytes>.
+/// @tparam digest_bytes The number of bytes in a digest. This parameter is usually deduced.
+///
+/// @param hash       The hash function to test.
+/// @param seed       The seed for this checkpoint.
+/// @param iterations The number of chained hashes in the checkpoint. SHAVS uses 1000.
+///
+/// @returns The digest at the end of the checkpoint.
+template <typename hash_t, std::size_t digest_bytes>
+constexpr std::array<std::byte, digest_bytes> monte_carlo_checkpoint(hash_t                                     hash,
+                                                                     const std::array<std::byte, digest_bytes>& seed,
+                                                                     std::size_t iterations = 1000) {
+    std::array<std::array<std::byte, digest_bytes>, 3> digests{seed, seed, seed};
+    for (std::size_t i = 0; i < iterations; ++i) {
+        std::array<std::byte, 3 * digest_bytes> message{};
+        for (auto current_byte = message.begin(); const auto& digest : digests)
+            current_byte = std::copy(digest.begin(), digest.end(), current_byte);
+        digests = {digests.at(1), digests.at(2), hash(message)};
+    }
+    return digests.at(2);
+}
+
+/// The number of failed checks in the runtime tests.
+inline std::size_t failures = 0;
+
+/// Records the result of a runtime check, printing a message if it failed.
+///
+/// @param passed      Whether the check passed.
+/// @param description A description of the check.
+inline void check(bool passed, const std::string& description) {
+    if (!passed) {
+        std::cerr << "FAILED: " << description << std::endl;
+        ++failures;
+    }
+}
+
+/// @param size The number of bytes.
+///
+/// @returns Test data where byte i is i modulo 251, so that no two blocks are the same.
+inline std::vector<std::byte> test_data(std::size_t size) {
+    std::vector<std::byte> data(size);
+    for (std::size_t i = 0; i < data.size(); ++i)
+        data.at(i) = static_cast<std::byte>(i % 251);
+    return data;
+}
+
+/// @tparam size The number of bytes.
+///
+/// @returns A test message where byte i is i modulo 256, for tests that run at compile time.
+template <std::size_t size>
+constexpr std::array<std::byte, size> test_array() {
+    std::array<std::byte, size> message{};
+    for (std::size_t i = 0; i < message.size(); ++i)
+        message.at(i) = static_cast<std::byte>(i);
+    return message;
+}
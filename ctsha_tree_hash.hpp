@@ -0,0 +1,422 @@
+/// A tree hash over SHA-256 whose work can be split between independent processes or machines. The object being hashed
+/// is divided into fixed-size chunks, and the digest is the root of the RFC 6962 Merkle tree (see merkle_leaf_hash and
+/// merkle_node_hash) over the chunks, so it is the same as the root of a merkle_log with one entry per chunk.
+///
+/// Each worker hashes a chunk-aligned range of the object into a shard_digest, which holds the roots of the largest
+/// aligned perfect subtrees covering the range. These are small and can be serialized, sent to one place, and combined
+/// in order, and the result does not depend on how the object was split. Combining is cheap: two shards merge in
+/// O(log n) hashes.
+///
+/// Every all-zero chunk has the same digest, and so does every all-zero subtree of a given height. These digests are
+/// computed at compile time, so runs of zeros, such as the holes in a sparse file, can be added to a tree hash without
+/// hashing them. The functions that hash files find the holes with SEEK_DATA and SEEK_HOLE, so hashing a sparse file
+/// takes time proportional to its allocated data. They require POSIX.
+
+#pragma once
+
+#include "ctsha.hpp"
+
+#include <bit>
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ctsha {
+
+namespace detail {
+
+/// Computes the hash of a leaf made of zeros, without needing a buffer of zeros as long as the leaf.
+///
+/// @param bytes The number of bytes in the leaf.
+///
+/// @returns The hash of the leaf.
+constexpr merkle_digest_t zero_leaf_hash(std::uint64_t bytes) {
+    constexpr std::array<std::byte, 64> zeros{};
+    context<algorithms::sha256> leaf;
+    leaf.update(std::array{std::byte{0x00}});
+    for (; bytes > 0; bytes -= std::min<std::uint64_t>(bytes, zeros.size()))
+        leaf.update(std::span(zeros).first(std::min<std::uint64_t>(bytes, zeros.size())));
+    return leaf.digest();
+}
+
+/// The root of an all-zero perfect subtree of each height, where height 0 is a single chunk. Heights up to 63 cover
+/// any object that fits in 2^64 bytes.
+///
+/// @tparam chunk_bytes The number of bytes in a chunk.
+template <std::size_t chunk_bytes>
+constexpr std::array<merkle_digest_t, 64> zero_subtree_roots = []() consteval {
+    std::array<merkle_digest_t, 64> roots{};
+    roots.at(0) = zero_leaf_hash(chunk_bytes);
+    for (std::size_t height = 1; height < roots.size(); ++height)
+        roots.at(height) = merkle_node_hash(roots.at(height - 1), roots.at(height - 1));
+    return roots;
+}();
+
+} // End namespace detail.
+
+/// The root of a perfect subtree of a tree hash, covering 2^height chunks starting at an offset that is a multiple of
+/// that many chunks. Only the last chunk of an object may be short, so the subtree covering it may cover fewer bytes.
+struct subtree_result {
+    /// The root hash of the subtree.
+    merkle_digest_t root{};
+
+    /// The offset of the first byte covered by the subtree.
+    std::uint64_t begin = 0;
+
+    /// The offset just past the last byte covered by the subtree.
+    std::uint64_t end = 0;
+
+    /// The height of the subtree, where a single chunk has height 0.
+    std::uint8_t height = 0;
+
+    friend constexpr bool operator==(const subtree_result&, const subtree_result&) = default;
+};
+
+/// The tree hash of a contiguous, chunk-aligned range of an object, as described at the top of this file.
+///
+/// @tparam chunk_bytes The number of bytes in a chunk. Every shard of an object must use the same chunk size.
+template <std::size_t chunk_bytes = 4096> requires (chunk_bytes > 0)
+class shard_digest {
+public:
+    /// The largest number of subtrees a shard can hold, which is enough for any range of a 2^64 byte object.
+    static constexpr std::size_t max_subtrees = 128;
+
+    /// Creates an empty shard.
+    ///
+    /// @param offset The offset of the start of the shard in the object.
+    ///
+    /// @throws std::invalid_argument if the offset is not a multiple of the chunk size.
+    constexpr explicit shard_digest(std::uint64_t offset = 0) : begin_(offset), end_(offset) {
+        if (offset % chunk_bytes != 0)
+            throw std::invalid_argument("A shard must start on a chunk boundary.");
+    }
+
+    /// Hashes a range of an object.
+    ///
+    /// @param offset The offset of the start of the range in the object, which must be a multiple of the chunk size.
+    /// @param data   The data in the range. If its size is not a multiple of the chunk size, the range must end at the
+    ///               end of the object.
+    ///
+    /// @returns The tree hash of the range.
+    ///
+    /// @throws std::invalid_argument if the offset is not a multiple of the chunk size.
+    static constexpr shard_digest hash(std::uint64_t offset, std::span<const std::byte> data) {
+        shard_digest result(offset);
+        for (; !data.empty(); data = data.subspan(std::min(data.size(), chunk_bytes)))
+            result.append_chunk(data.first(std::min(data.size(), chunk_bytes)));
+        return result;
+    }
+
+    /// Appends the next chunk of the object.
+    ///
+    /// @param chunk The chunk, which must not be empty. It may be shorter than the chunk size only if it is the last
+    ///              chunk of the object.
+    ///
+    /// @throws std::invalid_argument if the chunk is empty or too long, or follows a short chunk.
+    constexpr void append_chunk(std::span<const std::byte> chunk) {
+        if (chunk.empty() || chunk.size() > chunk_bytes)
+            throw std::invalid_argument("A chunk must hold between one byte and the chunk size.");
+        append({merkle_leaf_hash(chunk), end_, end_ + chunk.size(), 0});
+    }
+
+    /// Appends zeros to the shard. Whole subtrees of zeros are appended using precomputed roots, so this takes
+    /// O(log n) hashes however many zeros there are.
+    ///
+    /// @param bytes The number of zeros. If the end of the shard plus this is not a multiple of the chunk size, this
+    ///              must be the end of the object.
+    ///
+    /// @throws std::invalid_argument if the shard ends with a short chunk.
+    constexpr void append_zeros(std::uint64_t bytes) {
+        while (bytes >= chunk_bytes) {
+            // Use the tallest subtree that starts here and fits.
+            auto alignment = static_cast<std::size_t>(std::countr_zero(end_ / chunk_bytes));
+            auto height = std::min(alignment, static_cast<std::size_t>(std::bit_width(bytes / chunk_bytes)) - 1);
+            std::uint64_t subtree_bytes = std::uint64_t{chunk_bytes} << height;
+            append({detail::zero_subtree_roots<chunk_bytes>.at(height), end_, end_ + subtree_bytes,
+                    static_cast<std::uint8_t>(height)});
+            bytes -= subtree_bytes;
+        }
+        if (bytes > 0)
+            append({detail::zero_leaf_hash(bytes), end_, end_ + bytes, 0});
+    }
+
+    /// Appends a subtree that has already been hashed, such as one from another shard.
+    ///
+    /// @param subtree The subtree, which must start at the end of this shard.
+    ///
+    /// @throws std::invalid_argument if the subtree does not start at the end of this shard, is not aligned or sized
+    ///                               for its height, or follows a short chunk.
+    constexpr void append(const subtree_result& subtree) {
+        if (subtree.begin != end_ || subtree.end < subtree.begin)
+            throw std::invalid_argument("A subtree must start at the end of the shard.");
+        if (subtree.height >= 64 || std::uint64_t{chunk_bytes} > (~std::uint64_t{0} >> subtree.height))
+            throw std::invalid_argument("A subtree is too tall.");
+        std::uint64_t full_bytes = std::uint64_t{chunk_bytes} << subtree.height;
+        std::uint64_t bytes = subtree.end - subtree.begin;
+        if (subtree.begin % full_bytes != 0 || bytes > full_bytes || bytes + chunk_bytes <= full_bytes)
+            throw std::invalid_argument("A subtree must be aligned to and sized for its height.");
+        if (count_ > 0 && !is_full(subtrees_.at(count_ - 1)))
+            throw std::invalid_argument("Only the last chunk of an object may be short.");
+        if (count_ == max_subtrees)
+            throw std::invalid_argument("Too many subtrees in a shard.");
+
+        // Merge neighboring subtrees of the same height that are siblings, until the last two are not. The left one
+        // is a sibling if it starts on a boundary of the next height up.
+        subtrees_.at(count_++) = subtree;
+        end_ = subtree.end;
+        while (count_ >= 2) {
+            auto& left = subtrees_.at(count_ - 2);
+            const auto& right = subtrees_.at(count_ - 1);
+            if (left.height != right.height || (left.begin / (std::uint64_t{chunk_bytes} << left.height)) % 2 != 0)
+                break;
+            left = {merkle_node_hash(left.root, right.root), left.begin, right.end,
+                    static_cast<std::uint8_t>(left.height + 1)};
+            --count_;
+        }
+    }
+
+    /// @returns The offset of the start of the shard in the object.
+    constexpr std::uint64_t begin() const {
+        return begin_;
+    }
+
+    /// @returns The offset just past the end of the shard in the object.
+    constexpr std::uint64_t end() const {
+        return end_;
+    }
+
+    /// @returns The largest aligned perfect subtrees covering the shard, in order.
+    constexpr std::span<const subtree_result> subtrees() const {
+        return std::span(subtrees_).first(count_);
+    }
+
+    /// Computes the digest of the whole object, which this shard must cover.
+    ///
+    /// @returns The root of the tree over the chunks of the object. An empty object has the SHA-256 hash of an empty
+    ///          message, as in RFC 6962.
+    ///
+    /// @throws std::invalid_argument if the shard does not start at the beginning of the object.
+    constexpr merkle_digest_t root() const {
+        if (begin_ != 0)
+            throw std::invalid_argument("Only a shard covering the whole object has a root.");
+        if (count_ == 0)
+            return sha256(std::array<std::byte, 0>{});
+
+        // The subtrees get smaller from left to right, so fold them together from the right as RFC 6962 does.
+        merkle_digest_t result = subtrees_.at(count_ - 1).root;
+        for (std::size_t i = count_ - 1; i-- > 0;)
+            result = merkle_node_hash(subtrees_.at(i).root, result);
+        return result;
+    }
+
+    /// Serializes the shard so that it can be combined somewhere else. All integers are big endian.
+    ///
+    /// @returns The magic number "ctshatr1", then the chunk size, the offsets of the start and end of the shard, and
+    ///          the number of subtrees as 64-bit integers, then the root, start, end, and height of each subtree as a
+    ///          32-byte digest, two 64-bit integers, and an 8-bit integer.
+    std::vector<std::byte> serialize() const {
+        std::vector<std::byte> result;
+        auto put = [&](const auto& bytes) { result.insert(result.end(), bytes.begin(), bytes.end()); };
+        put(magic);
+        put(detail::to_bytes<std::endian::big>(std::array<std::uint64_t, 4>{chunk_bytes, begin_, end_, count_}));
+        for (const auto& subtree : subtrees()) {
+            put(subtree.root);
+            put(detail::to_bytes<std::endian::big>(std::array{subtree.begin, subtree.end}));
+            result.push_back(std::byte{subtree.height});
+        }
+        return result;
+    }
+
+    /// Deserializes a shard produced by serialize.
+    ///
+    /// @param bytes The serialized shard.
+    ///
+    /// @returns The shard.
+    ///
+    /// @throws std::invalid_argument if the bytes are not a valid shard with this chunk size.
+    static shard_digest deserialize(std::span<const std::byte> bytes) {
+        auto get = [&]<std::size_t num_bytes>() {
+            if (bytes.size() < num_bytes)
+                throw std::invalid_argument("Serialized shard is truncated.");
+            std::array<std::byte, num_bytes> result{};
+            std::copy(bytes.begin(), bytes.begin() + num_bytes, result.begin());
+            bytes = bytes.subspan(num_bytes);
+            return result;
+        };
+        auto get_integer = [&]() {
+            return detail::from_bytes<std::endian::big, std::uint64_t>(get.template operator()<8>()).front();
+        };
+
+        if (get.template operator()<magic.size()>() != magic || get_integer() != chunk_bytes)
+            throw std::invalid_argument("Serialized shard has the wrong format or chunk size.");
+        std::uint64_t begin = get_integer();
+        std::uint64_t end = get_integer();
+        std::uint64_t count = get_integer();
+
+        // Appending the subtrees checks that they are consistent with each other.
+        shard_digest result(begin);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            subtree_result subtree;
+            subtree.root = get.template operator()<std::tuple_size_v<merkle_digest_t>>();
+            subtree.begin = get_integer();
+            subtree.end = get_integer();
+            subtree.height = static_cast<std::uint8_t>(get.template operator()<1>().front());
+            result.append(subtree);
+        }
+        if (!bytes.empty() || result.end() != end || result.count_ != count)
+            throw std::invalid_argument("Serialized shard is inconsistent.");
+        return result;
+    }
+
+private:
+    /// Identifies the serialization format.
+    static constexpr std::array<std::byte, 8> magic = {std::byte{'c'}, std::byte{'t'}, std::byte{'s'}, std::byte{'h'},
+                                                       std::byte{'a'}, std::byte{'t'}, std::byte{'r'}, std::byte{'1'}};
+
+    /// @param subtree A subtree.
+    ///
+    /// @returns True if no chunk in the subtree is short.
+    static constexpr bool is_full(const subtree_result& subtree) {
+        return subtree.end - subtree.begin == std::uint64_t{chunk_bytes} << subtree.height;
+    }
+
+    /// The offset of the start of the shard.
+    std::uint64_t begin_;
+
+    /// The offset just past the end of the shard.
+    std::uint64_t end_;
+
+    /// The subtrees covering the shard. Only the first count_ are used.
+    std::array<subtree_result, max_subtrees> subtrees_{};
+
+    /// The number of subtrees covering the shard.
+    std::size_t count_ = 0;
+};
+
+/// Combines the tree hashes of two adjacent ranges of an object into the tree hash of both ranges.
+///
+/// @tparam chunk_bytes The number of bytes in a chunk. This parameter is usually deduced.
+///
+/// @param left  The tree hash of the first range.
+/// @param right The tree hash of the range immediately following it.
+///
+/// @returns The tree hash of both ranges together.
+///
+/// @throws std::invalid_argument if the ranges are not adjacent, or the left one ends with a short chunk.
+template <std::size_t chunk_bytes>
+constexpr shard_digest<chunk_bytes> combine(shard_digest<chunk_bytes> left, const shard_digest<chunk_bytes>& right) {
+    if (left.end() != right.begin())
+        throw std::invalid_argument("Only adjacent shards can be combined.");
+    for (const auto& subtree : right.subtrees())
+        left.append(subtree);
+    return left;
+}
+
+/// Computes the tree hash of a whole object in one place.
+///
+/// @tparam chunk_bytes The number of bytes in a chunk.
+///
+/// @param data The object.
+///
+/// @returns The root of the tree over the chunks of the object.
+template <std::size_t chunk_bytes = 4096>
+constexpr merkle_digest_t tree_hash(std::span<const std::byte> data) {
+    return shard_digest<chunk_bytes>::hash(0, data).root();
+}
+
+/// Computes the tree hash of a range of a file. Holes in the file are found with SEEK_DATA and SEEK_HOLE and added as
+/// zeros without being read or hashed, so this takes time proportional to the data in the range. If the file system
+/// does not support finding holes, every chunk is read and hashed.
+///
+/// @tparam chunk_bytes The number of bytes in a chunk.
+///
+/// @param path   The path of the file.
+/// @param offset The offset of the start of the range, which must be a multiple of the chunk size.
+/// @param length The number of bytes in the range. If the range does not end on a chunk boundary it must end at the
+///               end of the file.
+///
+/// @returns The tree hash of the range.
+///
+/// @throws std::system_error if the file cannot be read.
+/// @throws std::invalid_argument if the range is not aligned to chunks or extends past the end of the file.
+template <std::size_t chunk_bytes = 4096>
+shard_digest<chunk_bytes>
+hash_file_range(const std::filesystem::path& path, std::uint64_t offset, std::uint64_t length) {
+    struct file_descriptor {
+        int fd;
+        ~file_descriptor() { ::close(fd); }
+    } file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    auto fail = [&](const std::string& what) {
+        throw std::system_error(errno, std::generic_category(), what + " " + path.string());
+    };
+    if (file.fd < 0)
+        fail("Could not open");
+    struct stat status{};
+    if (::fstat(file.fd, &status) != 0)
+        fail("Could not stat");
+    std::uint64_t file_bytes = static_cast<std::uint64_t>(status.st_size);
+    if (offset > file_bytes || length > file_bytes - offset)
+        throw std::invalid_argument("The range extends past the end of the file.");
+
+    // Find the next data at or after a position, or return the end of the range if there is none. Without SEEK_DATA
+    // support, the whole file is data.
+    const std::uint64_t end = offset + length;
+    auto seek = [&](std::uint64_t position, [[maybe_unused]] int whence) -> std::uint64_t {
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        off_t result = ::lseek(file.fd, static_cast<off_t>(position), whence);
+        if (result >= 0)
+            return std::min(static_cast<std::uint64_t>(result), end);
+        if (errno == ENXIO)
+            return end;
+        if (errno != EINVAL)
+            fail("Could not seek in");
+#endif
+        return whence == SEEK_HOLE ? end : position;
+    };
+
+    shard_digest<chunk_bytes> result(offset);
+    std::vector<std::byte> buffer(std::max<std::size_t>(chunk_bytes, 1 << 20) / chunk_bytes * chunk_bytes);
+    for (std::uint64_t position = offset; position < end;) {
+        // Skip whole chunks of hole. A chunk that is partly hole is read, and the hole reads as zeros.
+        std::uint64_t data = seek(position, SEEK_DATA);
+        std::uint64_t zeros = data == end ? end - position : (data - position) / chunk_bytes * chunk_bytes;
+        result.append_zeros(zeros);
+        position += zeros;
+
+        // Read and hash up to the chunk containing the start of the next hole.
+        std::uint64_t hole = seek(data, SEEK_HOLE);
+        std::uint64_t data_end = std::min((hole + chunk_bytes - 1) / chunk_bytes * chunk_bytes, end);
+        while (position < data_end) {
+            auto count = std::min<std::uint64_t>(buffer.size(), data_end - position);
+            ssize_t bytes_read = ::pread(file.fd, buffer.data(), count, static_cast<off_t>(position));
+            if (bytes_read != static_cast<ssize_t>(count))
+                fail("Could not read");
+            for (std::size_t i = 0; i < count; i += chunk_bytes)
+                result.append_chunk(std::span(buffer).subspan(i, std::min<std::uint64_t>(chunk_bytes, count - i)));
+            position += count;
+        }
+    }
+    return result;
+}
+
+/// Computes the tree hash of a whole file, skipping its holes. See hash_file_range.
+///
+/// @tparam chunk_bytes The number of bytes in a chunk.
+///
+/// @param path The path of the file.
+///
+/// @returns The root of the tree over the chunks of the file.
+///
+/// @throws std::system_error if the file cannot be read.
+template <std::size_t chunk_bytes = 4096>
+merkle_digest_t tree_hash_file(const std::filesystem::path& path) {
+    return hash_file_range<chunk_bytes>(path, 0, std::filesystem::file_size(path)).root();
+}
+
+} // End namespace ctsha.
@@ -0,0 +1,214 @@
+/// Tests for ctsha_tree_hash.hpp. The static_asserts check that every way of sharding some small objects gives the same
+/// digest, which matches digests computed independently. At runtime, an object is hashed by several worker processes,
+/// each of which sends its serialized shard back over a pipe, and the combined digest is checked against a
+/// single-process run.
+#include "ctsha_tree_hash.hpp"
+#include "ctsha_tests.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ctsha::literals;
+
+// Test the digests of small objects with 4-byte chunks against digests computed with Python's hashlib.
+static_assert(ctsha::tree_hash<4>(std::array<std::byte, 0>{}) ==
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"_hex_bytes);
+static_assert(ctsha::tree_hash<4>("abcdefghij"_bytes) ==
+              "2a5b33d54d89d05737a7dd798d9862d55951564aafb5460691ad8a7a9ab6c678"_hex_bytes);
+static_assert(ctsha::tree_hash<4>("abcdefghijklmnopqrstuvwxyz"_bytes) ==
+              "0d3e83e16b6f8556fa2f1fa0b4bc80ff178313bdf6e4fbedc0dde52c6d169260"_hex_bytes);
+
+// Test that splitting an object into two or three shards at every pair of chunk boundaries, and combining them in
+// either grouping, gives the same digest as hashing it in one piece.
+static_assert([]() {
+    constexpr std::size_t chunk = 4;
+    constexpr auto object = "abcdefghijklm"_bytes;
+    constexpr auto expected = ctsha::tree_hash<chunk>(object);
+    auto shard = [&](std::size_t begin, std::size_t end) {
+        return ctsha::shard_digest<chunk>::hash(begin, std::span(object).subspan(begin, end - begin));
+    };
+    for (std::size_t first = 0; first <= object.size(); first += chunk) {
+        for (std::size_t second = first; second <= object.size(); second += chunk) {
+            auto left = shard(0, first);
+            auto middle = shard(first, second);
+            auto right = shard(second, object.size());
+            if (ctsha::combine(ctsha::combine(left, middle), right).root() != expected ||
+                ctsha::combine(left, ctsha::combine(middle, right)).root() != expected)
+                return false;
+        }
+    }
+    return true;
+}());
+
+// Test the precomputed roots of all-zero subtrees, and appending runs of zeros starting at chunks with different
+// alignments, including a run that ends with a short chunk.
+static_assert(ctsha::detail::zero_subtree_roots<4>.at(0) == ctsha::merkle_leaf_hash(std::array<std::byte, 4>{}));
+static_assert(ctsha::detail::zero_subtree_roots<4>.at(3) == ctsha::tree_hash<4>(std::array<std::byte, 32>{}));
+static_assert([]() {
+    std::array<std::byte, 40> object{};
+    object.at(0) = object.at(3) = std::byte{1};
+    for (std::size_t data_bytes : {4, 8, 12}) {
+        auto shard = ctsha::shard_digest<4>::hash(0, std::span(object).first(data_bytes));
+        shard.append_zeros(object.size() - data_bytes - 3);
+        if (shard.root() != ctsha::tree_hash<4>(std::span(object).first(object.size() - 3)))
+            return false;
+    }
+    return true;
+}());
+
+namespace {
+
+/// Hashes an object by splitting it into shards of whole chunks, hashing each one in a separate process, and combining
+/// the results.
+///
+/// @param object      The object to hash.
+/// @param num_workers The number of worker processes.
+///
+/// @returns The digest of the object.
+///
+/// @throws std::runtime_error if a worker fails.
+ctsha::merkle_digest_t hash_in_processes(std::span<const std::byte> object, std::size_t num_workers) {
+    constexpr std::size_t chunk = 4096;
+    std::size_t num_chunks = (object.size() + chunk - 1) / chunk;
+
+    // Each worker inherits the object, hashes its part, and writes the serialized shard to a pipe.
+    std::vector<std::pair<pid_t, int>> workers;
+    for (std::size_t worker = 0; worker < num_workers; ++worker) {
+        std::size_t begin = std::min(num_chunks * worker / num_workers * chunk, object.size());
+        std::size_t end = std::min(num_chunks * (worker + 1) / num_workers * chunk, object.size());
+        int pipe_fds[2];
+        if (::pipe(pipe_fds) != 0)
+            throw std::runtime_error("Could not create a pipe.");
+        pid_t pid = ::fork();
+        if (pid < 0)
+            throw std::runtime_error("Could not fork.");
+        if (pid == 0) {
+            ::close(pipe_fds[0]);
+            auto bytes = ctsha::shard_digest<chunk>::hash(begin, object.subspan(begin, end - begin)).serialize();
+            bool written = ::write(pipe_fds[1], bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size());
+            ::_exit(written ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        ::close(pipe_fds[1]);
+        workers.emplace_back(pid, pipe_fds[0]);
+    }
+
+    // Collect the shards in order and combine them.
+    ctsha::shard_digest<chunk> combined;
+    for (auto [pid, fd] : workers) {
+        std::vector<std::byte> bytes;
+        std::array<std::byte, 4096> buffer;
+        for (ssize_t count; (count = ::read(fd, buffer.data(), buffer.size())) > 0;)
+            bytes.insert(bytes.end(), buffer.begin(), buffer.begin() + count);
+        ::close(fd);
+        int status = 0;
+        if (::waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+            throw std::runtime_error("A worker failed.");
+        combined = ctsha::combine(combined, ctsha::shard_digest<chunk>::deserialize(bytes));
+    }
+    return combined.root();
+}
+
+/// Checks hashing sparse files. A file with scattered data is checked against hashing its contents in memory, and a
+/// 1 TiB file that is almost all hole is checked against appending zeros, and timed.
+void check_sparse_files() {
+    char directory_name[] = "/tmp/ctsha_tree_hash_XXXXXX";
+    if (::mkdtemp(directory_name) == nullptr)
+        throw std::runtime_error("Could not create a temporary directory.");
+    std::filesystem::path path = std::filesystem::path(directory_name) / "sparse";
+
+    // Write some data, none of it aligned to chunks, into a file that is otherwise holes.
+    auto write_sparse = [&](std::uint64_t size, const std::vector<std::uint64_t>& offsets) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        bool written = fd >= 0 && ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+        for (auto offset : offsets)
+            written = written && ::pwrite(fd, "ctsha", 5, static_cast<off_t>(offset)) == 5;
+        ::close(fd);
+        if (!written)
+            throw std::runtime_error("Could not write " + path.string());
+    };
+
+    std::uint64_t size = (64 << 20) + 1000;
+    std::vector<std::uint64_t> offsets = {0, 5000, 4094, (3 << 20) + 17, (9 << 20) + 4096, size - 5};
+    write_sparse(size, offsets);
+    std::vector<std::byte> contents(size);
+    for (auto offset : offsets)
+        std::copy_n("ctsha"_bytes.begin(), 5, contents.begin() + offset);
+    check(ctsha::tree_hash_file(path) == ctsha::tree_hash(contents), "sparse file");
+    auto first = ctsha::hash_file_range(path, 0, 4 << 20);
+    auto second = ctsha::hash_file_range(path, 4 << 20, size - (4 << 20));
+    check(ctsha::combine(first, second).root() == ctsha::tree_hash(contents), "sparse file in two ranges");
+
+    // Only check the big file if the file system reports holes, or it would take far too long.
+    std::uint64_t big_size = std::uint64_t{1} << 40;
+    std::vector<std::uint64_t> big_offsets = {(1 << 20) + 3, big_size / 3 / 4096 * 4096 + 100};
+    write_sparse(big_size, big_offsets);
+    int fd = ::open(path.c_str(), O_RDONLY);
+    bool has_holes = ::lseek(fd, 0, SEEK_HOLE) < static_cast<off_t>(big_size);
+    ::close(fd);
+    if (has_holes) {
+        ctsha::shard_digest<> expected;
+        for (auto offset : big_offsets) {
+            std::array<std::byte, 4096> chunk{};
+            std::copy_n("ctsha"_bytes.begin(), 5, chunk.begin() + offset % chunk.size());
+            expected.append_zeros(offset / chunk.size() * chunk.size() - expected.end());
+            expected.append_chunk(chunk);
+        }
+        expected.append_zeros(big_size - expected.end());
+
+        auto start = std::chrono::steady_clock::now();
+        auto digest = ctsha::tree_hash_file(path);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        check(digest == expected.root(), "1 TiB sparse file");
+        std::cout << "Hashed a 1 TiB sparse file in " << elapsed.count() << " ms" << std::endl;
+    } else {
+        std::cout << "Skipping the 1 TiB sparse file test because " << directory_name << " does not report holes"
+                  << std::endl;
+    }
+    std::filesystem::remove_all(directory_name);
+}
+
+} // End anonymous namespace.
+
+int main() {
+    try {
+        std::vector<std::byte> object(1000003);
+        for (std::size_t i = 0; i < object.size(); ++i)
+            object.at(i) = static_cast<std::byte>(i % 251);
+
+        // This digest was computed independently with Python's hashlib.
+        auto expected = ctsha::tree_hash(object);
+        check(expected == "1ec3a67ccc6af5b940254395e688ebb8605e4e3292198f1628f46b38fbae47a0"_hex_bytes,
+              "single process digest");
+        for (std::size_t num_workers : {1, 2, 3, 4, 7, 16})
+            check(hash_in_processes(object, num_workers) == expected, std::to_string(num_workers) + " processes");
+
+        // Shards that are not adjacent, and serialized shards that are corrupt, are rejected.
+        auto first = ctsha::shard_digest<>::hash(0, std::span(object).first(8192));
+        auto third = ctsha::shard_digest<>::hash(16384, std::span(object).subspan(16384, 4096));
+        try {
+            ctsha::combine(first, third);
+            check(false, "combining shards that are not adjacent");
+        } catch (const std::invalid_argument&) {
+        }
+        auto bytes = third.serialize();
+        check(ctsha::shard_digest<>::deserialize(bytes).subtrees().front() == third.subtrees().front(), "round trip");
+        bytes.at(bytes.size() - 1) = std::byte{1};
+        try {
+            ctsha::shard_digest<>::deserialize(bytes);
+            check(false, "deserializing a corrupt shard");
+        } catch (const std::invalid_argument&) {
+        }
+
+        check_sparse_files();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ++failures;
+    }
+
+    std::cout << "Tree hash tests " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,457 @@
+/// Verified random-access reads of large read-only files, in the style of Linux dm-verity (see
+/// https://docs.kernel.org/admin-guide/device-mapper/verity.html). A builder hashes every 4 KiB block of a data file
+/// with SHA-256 and writes the digests, and the digests of the blocks of digests, and so on up to a single block, to a
+/// sidecar "hash tree" file. Given only the root hash, a reader can then map the data and verify each block lazily the
+/// first time it is read, along with the path of hash blocks from it to the root. Verified blocks are remembered in a
+/// bitmap, so opening a file is O(1) and every block is hashed at most once.
+///
+/// The tree has the same shape as a dm-verity tree without a salt: each hash block holds 128 digests, zero-padded, and
+/// levels are stored top first. The root also covers the size of the data, so truncating or extending a file with
+/// zeros is detected. The last data block is zero-padded if the file size is not a multiple of the block size.
+///
+/// Unlike the rest of the library, this is only usable at runtime, and it requires POSIX.
+
+#pragma once
+
+#include "ctsha.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ctsha {
+
+/// The type of the digests in a verity hash tree.
+using verity_digest_t = std::array<std::byte, 32>;
+
+/// Thrown when a block of a verified file does not match its hash tree.
+class verity_error : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+namespace detail {
+
+/// The number of bytes in a data block or a hash block.
+constexpr std::size_t verity_block_bytes = 4096;
+
+/// The number of digests in a hash block.
+constexpr std::size_t verity_fanout = verity_block_bytes / std::tuple_size_v<verity_digest_t>;
+
+/// The header at the start of a hash tree file, which occupies a whole block so that the hash blocks stay aligned.
+struct verity_header {
+    /// Identifies the file format.
+    std::array<char, 8> magic = {'c', 't', 's', 'h', 'a', 'v', 't', '1'};
+
+    /// The number of bytes in the data file.
+    std::uint64_t data_bytes = 0;
+};
+
+/// Describes the layout of a hash tree, which depends only on the size of the data.
+class verity_layout {
+public:
+    /// @param data_bytes The number of bytes in the data file.
+    explicit verity_layout(std::uint64_t data_bytes)
+        : data_bytes_(data_bytes), data_blocks_((data_bytes + verity_block_bytes - 1) / verity_block_bytes) {
+        // Level 0 holds the digests of the data blocks, and each level above holds the digests of the level below,
+        // until a level fits in one block. Even an empty file gets one (empty) hash block.
+        std::uint64_t count = data_blocks_;
+        do {
+            count = std::max<std::uint64_t>((count + verity_fanout - 1) / verity_fanout, 1);
+            level_blocks_.push_back(count);
+        } while (count > 1);
+
+        // Levels are stored top first, after the header block.
+        level_offsets_.resize(level_blocks_.size());
+        std::uint64_t block = 1;
+        for (std::size_t level = level_blocks_.size(); level-- > 0;) {
+            level_offsets_.at(level) = block;
+            block += level_blocks_.at(level);
+        }
+        total_blocks_ = block;
+    }
+
+    /// @returns The number of bytes in the data file.
+    std::uint64_t data_bytes() const {
+        return data_bytes_;
+    }
+
+    /// @returns The number of data blocks, counting a partial last block.
+    std::uint64_t data_blocks() const {
+        return data_blocks_;
+    }
+
+    /// @returns The number of levels of hash blocks.
+    std::size_t levels() const {
+        return level_blocks_.size();
+    }
+
+    /// @param level A level, where 0 holds the digests of the data blocks.
+    ///
+    /// @returns The number of hash blocks in the level.
+    std::uint64_t level_blocks(std::size_t level) const {
+        return level_blocks_.at(level);
+    }
+
+    /// @param level A level, where 0 holds the digests of the data blocks.
+    /// @param index The index of a hash block within the level.
+    ///
+    /// @returns The index of the hash block within the tree file, counting the header as block 0.
+    std::uint64_t block_number(std::size_t level, std::uint64_t index) const {
+        return level_offsets_.at(level) + index;
+    }
+
+    /// @returns The number of blocks in the tree file, including the header.
+    std::uint64_t total_blocks() const {
+        return total_blocks_;
+    }
+
+private:
+    /// The number of bytes in the data file.
+    std::uint64_t data_bytes_;
+
+    /// The number of data blocks.
+    std::uint64_t data_blocks_;
+
+    /// The number of hash blocks in each level.
+    std::vector<std::uint64_t> level_blocks_;
+
+    /// The block number of the first hash block of each level.
+    std::vector<std::uint64_t> level_offsets_;
+
+    /// The number of blocks in the tree file.
+    std::uint64_t total_blocks_ = 0;
+};
+
+/// A memory mapping of a whole file, which is unmapped and closed on destruction.
+class mapped_file {
+public:
+    /// Maps a file.
+    ///
+    /// @param path     The path of the file.
+    /// @param writable Whether the mapping may be written to. If so, the file is created or truncated.
+    /// @param bytes    If writable, the file is resized to this many bytes first.
+    ///
+    /// @throws std::system_error if the file cannot be opened or mapped.
+    mapped_file(const std::filesystem::path& path, bool writable, std::uint64_t bytes = 0) {
+        fd_ = ::open(path.c_str(), (writable ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY) | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            fail("Could not open " + path.string());
+
+        if (writable) {
+            if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0)
+                fail("Could not resize " + path.string());
+        } else {
+            struct stat status{};
+            if (::fstat(fd_, &status) != 0)
+                fail("Could not stat " + path.string());
+            bytes = static_cast<std::uint64_t>(status.st_size);
+        }
+
+        // An empty file cannot be mapped, but there is nothing to map anyway.
+        size_ = bytes;
+        if (size_ > 0) {
+            void* data = ::mmap(nullptr, size_, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+            if (data == MAP_FAILED)
+                fail("Could not map " + path.string());
+            data_ = static_cast<std::byte*>(data);
+        }
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1)),
+          data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        std::swap(fd_, other.fd_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~mapped_file() {
+        if (data_ != nullptr)
+            ::munmap(data_, size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    /// @returns The contents of the file.
+    std::span<std::byte> bytes() const {
+        return {data_, size_};
+    }
+
+private:
+    /// Closes the file and throws a std::system_error for the current errno. This is only used by the constructor, so
+    /// the destructor will not run.
+    ///
+    /// @param what A description of what failed.
+    [[noreturn]] void fail(const std::string& what) {
+        int error = errno;
+        if (fd_ >= 0)
+            ::close(fd_);
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    /// The file descriptor of the file.
+    int fd_ = -1;
+
+    /// The mapping of the file.
+    std::byte* data_ = nullptr;
+
+    /// The number of bytes in the file.
+    std::size_t size_ = 0;
+};
+
+/// @param data   The contents of a data file.
+/// @param layout The layout of the tree for the data file.
+/// @param index  The index of a block.
+///
+/// @returns The block, which is short if it is the last block and the file size is not a multiple of the block size.
+inline std::span<const std::byte> verity_data_block(std::span<const std::byte> data,
+                                                    const verity_layout& layout,
+                                                    std::uint64_t index) {
+    auto offset = index * verity_block_bytes;
+    return data.subspan(offset, std::min<std::uint64_t>(verity_block_bytes, layout.data_bytes() - offset));
+}
+
+/// Computes the digest of a data block or hash block, zero-padding it to a whole block.
+///
+/// @param block The block, which may be short only if it is the last block of the data file.
+///
+/// @returns The SHA-256 digest of the padded block.
+inline verity_digest_t verity_block_hash(std::span<const std::byte> block) {
+    static constexpr std::array<std::byte, verity_block_bytes> zeros{};
+    return context<algorithms::sha256>()
+        .update(block)
+        .update(std::span(zeros).first(verity_block_bytes - block.size()))
+        .digest();
+}
+
+/// Computes the root hash of a tree from its top hash block. This covers the size of the data as well.
+///
+/// @param layout    The layout of the tree.
+/// @param top_block The top hash block.
+///
+/// @returns The root hash.
+inline verity_digest_t verity_root(const verity_layout& layout, std::span<const std::byte> top_block) {
+    return context<algorithms::sha256>()
+        .update(to_bytes<std::endian::big>(std::array{layout.data_bytes()}))
+        .update(top_block)
+        .digest();
+}
+
+/// @param tree  The contents of a tree file.
+/// @param block The number of a block within the tree file.
+///
+/// @returns The block.
+inline std::span<std::byte> verity_tree_block(std::span<std::byte> tree, std::uint64_t block) {
+    return tree.subspan(block * verity_block_bytes, verity_block_bytes);
+}
+
+} // End namespace detail.
+
+/// Hashes a data file and writes its hash tree to a sidecar file.
+///
+/// @param data_path The path of the data file.
+/// @param tree_path The path of the tree file to write, which is overwritten if it exists.
+///
+/// @returns The root hash, which must be stored somewhere trusted and passed to verified_file.
+///
+/// @throws std::system_error if a file cannot be opened, created, or mapped.
+inline verity_digest_t build_verity_tree(const std::filesystem::path& data_path,
+                                         const std::filesystem::path& tree_path) {
+    using namespace detail;
+
+    mapped_file data(data_path, false);
+    verity_layout layout(data.bytes().size());
+    mapped_file tree_file(tree_path, true, layout.total_blocks() * verity_block_bytes);
+    auto tree = tree_file.bytes();
+
+    verity_header header;
+    header.data_bytes = layout.data_bytes();
+    std::memcpy(tree.data(), &header, sizeof(header));
+
+    // Hash the data blocks into level 0, then each level into the one above it. The file was created empty, so unused
+    // slots in the last hash block of each level are already zero.
+    auto store = [&](std::size_t level, std::uint64_t child, const verity_digest_t& digest) {
+        auto block = verity_tree_block(tree, layout.block_number(level, child / verity_fanout));
+        std::copy(digest.begin(), digest.end(), block.begin() + (child % verity_fanout) * digest.size());
+    };
+    for (std::uint64_t block = 0; block < layout.data_blocks(); ++block)
+        store(0, block, verity_block_hash(verity_data_block(data.bytes(), layout, block)));
+    for (std::size_t level = 1; level < layout.levels(); ++level) {
+        for (std::uint64_t block = 0; block < layout.level_blocks(level - 1); ++block)
+            store(level, block, verity_block_hash(verity_tree_block(tree, layout.block_number(level - 1, block))));
+    }
+
+    return verity_root(layout, verity_tree_block(tree, layout.block_number(layout.levels() - 1, 0)));
+}
+
+/// A read-only data file whose blocks are verified against a hash tree, as described at the top of this file. Blocks
+/// are verified the first time they are read, and reads may happen concurrently from multiple threads. This protects
+/// against files modified at rest; a block modified after it has been verified is not checked again.
+class verified_file {
+public:
+    /// Maps a data file and its hash tree, and checks the top of the tree against the root hash. No data is read yet.
+    ///
+    /// @param data_path The path of the data file.
+    /// @param tree_path The path of the tree file written by build_verity_tree.
+    /// @param root      The root hash returned by build_verity_tree.
+    ///
+    /// @throws std::system_error if a file cannot be opened or mapped.
+    /// @throws verity_error if the tree file does not match the data file or the root hash.
+    verified_file(const std::filesystem::path& data_path,
+                  const std::filesystem::path& tree_path,
+                  const verity_digest_t& root)
+        : data_(data_path, false),
+          tree_(tree_path, false),
+          layout_(data_.bytes().size()),
+          data_verified_(bitmap(layout_.data_blocks())),
+          tree_verified_(bitmap(layout_.total_blocks())) {
+        if (tree_.bytes().size() != layout_.total_blocks() * detail::verity_block_bytes)
+            throw verity_error("Hash tree " + tree_path.string() + " has the wrong size for " + data_path.string());
+        detail::verity_header header;
+        std::memcpy(&header, tree_.bytes().data(), sizeof(header));
+        if (header.magic != detail::verity_header().magic || header.data_bytes != layout_.data_bytes())
+            throw verity_error("Hash tree " + tree_path.string() + " does not belong to " + data_path.string());
+
+        auto top = layout_.block_number(layout_.levels() - 1, 0);
+        if (detail::verity_root(layout_, detail::verity_tree_block(tree_.bytes(), top)) != root)
+            throw verity_error("Hash tree " + tree_path.string() + " does not match the root hash");
+        mark(tree_verified_, top);
+    }
+
+    /// @returns The number of bytes in the data file.
+    std::uint64_t size() const {
+        return layout_.data_bytes();
+    }
+
+    /// @returns The number of blocks in the data file, counting a partial last block.
+    std::uint64_t blocks() const {
+        return layout_.data_blocks();
+    }
+
+    /// Gets a verified block of the data file.
+    ///
+    /// @param index The index of the block.
+    ///
+    /// @returns The block, which is shorter than a whole block only if it is the last one. The data stays mapped for as
+    ///          long as this object exists.
+    ///
+    /// @throws std::out_of_range if the block does not exist.
+    /// @throws verity_error if the block or its path to the root has been modified.
+    std::span<const std::byte> block(std::uint64_t index) const {
+        if (index >= layout_.data_blocks())
+            throw std::out_of_range("Block is past the end of the file.");
+
+        auto data = detail::verity_data_block(data_.bytes(), layout_, index);
+        if (!is_marked(data_verified_, index)) {
+            check(0, index, detail::verity_block_hash(data));
+            mark(data_verified_, index);
+        }
+        return data;
+    }
+
+    /// Copies verified data out of the file.
+    ///
+    /// @param offset      The offset in the file to start reading at.
+    /// @param destination Where to copy the data. Its size is the number of bytes read.
+    ///
+    /// @throws std::out_of_range if the range to read extends past the end of the file.
+    /// @throws verity_error if any block being read or its path to the root has been modified.
+    void read(std::uint64_t offset, std::span<std::byte> destination) const {
+        if (offset > size() || destination.size() > size() - offset)
+            throw std::out_of_range("Read is past the end of the file.");
+
+        while (!destination.empty()) {
+            auto data = block(offset / detail::verity_block_bytes).subspan(offset % detail::verity_block_bytes);
+            auto count = std::min(data.size(), destination.size());
+            std::copy(data.begin(), data.begin() + count, destination.begin());
+            destination = destination.subspan(count);
+            offset += count;
+        }
+    }
+
+private:
+    /// The type of the bitmaps of verified blocks.
+    using bitmap_t = std::unique_ptr<std::atomic<std::uint64_t>[]>;
+
+    /// Checks a digest against the digest stored for it in the tree, verifying the hash block holding it first if
+    /// needed.
+    ///
+    /// @param level  The level of the hash block holding the stored digest.
+    /// @param child  The index of the digest within the level.
+    /// @param digest The digest to check.
+    ///
+    /// @throws verity_error if the digests do not match.
+    void check(std::size_t level, std::uint64_t child, const verity_digest_t& digest) const {
+        auto number = layout_.block_number(level, child / detail::verity_fanout);
+        auto block = detail::verity_tree_block(tree_.bytes(), number);
+        if (!is_marked(tree_verified_, number)) {
+            check(level + 1, child / detail::verity_fanout, detail::verity_block_hash(block));
+            mark(tree_verified_, number);
+        }
+
+        auto stored = block.subspan((child % detail::verity_fanout) * digest.size(), digest.size());
+        if (!std::equal(stored.begin(), stored.end(), digest.begin()))
+            throw verity_error(level == 0 ? "Data block " + std::to_string(child) + " has been modified."
+                                          : "Hash tree has been modified.");
+    }
+
+    /// @param bits The number of bits needed.
+    ///
+    /// @returns A bitmap with all bits clear.
+    static bitmap_t bitmap(std::uint64_t bits) {
+        auto words = (bits + 63) / 64;
+        bitmap_t result(new std::atomic<std::uint64_t>[words]);
+        for (std::uint64_t i = 0; i < words; ++i)
+            result[i].store(0, std::memory_order_relaxed);
+        return result;
+    }
+
+    /// @param bitmap A bitmap.
+    /// @param bit    The bit to test.
+    ///
+    /// @returns True if the bit is set.
+    static bool is_marked(const bitmap_t& bitmap, std::uint64_t bit) {
+        return (bitmap[bit / 64].load(std::memory_order_acquire) >> (bit % 64)) & 1;
+    }
+
+    /// Sets a bit in a bitmap.
+    ///
+    /// @param bitmap A bitmap.
+    /// @param bit    The bit to set.
+    static void mark(const bitmap_t& bitmap, std::uint64_t bit) {
+        bitmap[bit / 64].fetch_or(std::uint64_t{1} << (bit % 64), std::memory_order_release);
+    }
+
+    /// The mapped data file.
+    detail::mapped_file data_;
+
+    /// The mapped tree file.
+    detail::mapped_file tree_;
+
+    /// The layout of the tree.
+    detail::verity_layout layout_;
+
+    /// Which data blocks have been verified.
+    bitmap_t data_verified_;
+
+    /// Which blocks of the tree file have been verified, indexed by block number.
+    bitmap_t tree_verified_;
+};
+
+} // End namespace ctsha.
@@ -0,0 +1,158 @@
+/// Runtime tests for ctsha_verity.hpp. Hash trees are built for files of various sizes, their roots are checked against
+/// roots computed independently, and then blocks of the data and the tree are modified to make sure every modification
+/// is detected when, and only when, the modified part is read.
+#include "ctsha_verity.hpp"
+#include "ctsha_tests.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+using namespace ctsha::literals;
+
+namespace {
+
+/// Checks that a function throws a particular exception.
+///
+/// @tparam exception_t The type of exception expected.
+/// @tparam function_t  The type of the function. This parameter is usually deduced.
+///
+/// @param function    The function to call.
+/// @param description A description of the check.
+template <typename exception_t, typename function_t>
+void check_throws(function_t function, const std::string& description) {
+    try {
+        function();
+        check(false, description);
+    } catch (const exception_t&) {
+    }
+}
+
+/// Writes a file.
+///
+/// @param path The path of the file.
+/// @param data The contents of the file.
+void write_file(const std::filesystem::path& path, std::span<const std::byte> data) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc)
+        .write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+/// Modifies one byte of a file.
+///
+/// @param path   The path of the file.
+/// @param offset The offset of the byte to modify.
+void corrupt(const std::filesystem::path& path, std::uint64_t offset) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekg(static_cast<std::streamoff>(offset));
+    char byte = static_cast<char>(file.get() ^ 1);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.put(byte);
+}
+
+/// Builds a hash tree for a file, checks the root, and checks that all of the data reads back correctly.
+///
+/// @param directory The directory to put the files in.
+/// @param data      The contents of the data file.
+///
+/// @returns The root hash.
+ctsha::verity_digest_t check_round_trip(const std::filesystem::path& directory, const std::vector<std::byte>& data) {
+    auto description = "file of " + std::to_string(data.size()) + " bytes";
+    write_file(directory / "data", data);
+    auto root = ctsha::build_verity_tree(directory / "data", directory / "tree");
+
+    ctsha::verified_file file(directory / "data", directory / "tree", root);
+    check(file.size() == data.size(), description + " (size)");
+    std::vector<std::byte> contents(data.size());
+    file.read(0, contents);
+    check(contents == data, description + " (contents)");
+    if (data.size() > 10) {
+        std::array<std::byte, 7> middle{};
+        file.read(data.size() / 2, middle);
+        check(std::equal(middle.begin(), middle.end(), data.begin() + data.size() / 2), description + " (middle)");
+    }
+    check_throws<std::out_of_range>([&]() { file.read(data.size(), std::span(contents).first(1)); },
+                                    description + " (read past end)");
+    return root;
+}
+
+} // End anonymous namespace.
+
+int main() {
+    char directory_name[] = "/tmp/ctsha_verity_XXXXXX";
+    if (::mkdtemp(directory_name) == nullptr) {
+        std::cerr << "Could not create a temporary directory." << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::filesystem::path directory(directory_name);
+
+    try {
+        // These roots were computed independently with Python's hashlib.
+        check(check_round_trip(directory, test_data(0)) ==
+              "4f2cfec1c5dc3827cdeb42906713b37cae91e009aa0e2d211c376ccb9969b3ea"_hex_bytes, "empty root");
+        check(check_round_trip(directory, test_data(5000)) ==
+              "8a1c0acfa32f932e1e0f4bd03166ee87305d74f1ec3d1c99833a374f2e713801"_hex_bytes, "one level root");
+        check(check_round_trip(directory, test_data(128 * 4096 + 5)) ==
+              "6062469557d7192da0cff580e66a79c70269488c564371362ac58fbf6408fe47"_hex_bytes, "two level root");
+        for (std::size_t size : {1, 4095, 4096, 4097, 128 * 4096})
+            check_round_trip(directory, test_data(size));
+
+        // Use three levels of hash blocks for the tamper tests, so that a modified hash block has both a parent and
+        // children.
+        auto data = test_data(128 * 128 * 4096 + 100);
+        auto root = check_round_trip(directory, data);
+        auto pristine = directory / "pristine";
+        std::filesystem::copy_file(directory / "tree", pristine);
+
+        // A modified data block is only detected when that block is read.
+        corrupt(directory / "data", 5 * 4096 + 17);
+        {
+            ctsha::verified_file file(directory / "data", directory / "tree", root);
+            check(file.block(4).size() == 4096 && file.block(6).size() == 4096, "blocks next to a modified block");
+            check_throws<ctsha::verity_error>([&]() { file.block(5); }, "modified data block");
+            check_throws<ctsha::verity_error>([&]() { file.block(5); }, "modified data block read twice");
+        }
+        corrupt(directory / "data", 5 * 4096 + 17);
+
+        // The tree file holds the header, then the top block, then 2 level 1 blocks, then 129 level 0 blocks. A
+        // modified level 0 hash block breaks every data block under it, but no others.
+        corrupt(directory / "tree", 5 * 4096 + 40);
+        {
+            ctsha::verified_file file(directory / "data", directory / "tree", root);
+            check(file.block(127).size() == 4096 && file.block(256).size() == 4096, "blocks next to a modified hash");
+            check_throws<ctsha::verity_error>([&]() { file.block(128); }, "modified level 0 hash block");
+            check_throws<ctsha::verity_error>([&]() { file.block(255); }, "modified level 0 hash block");
+        }
+        std::filesystem::copy_file(pristine, directory / "tree", std::filesystem::copy_options::overwrite_existing);
+
+        // A modified level 1 hash block breaks everything under it.
+        corrupt(directory / "tree", 3 * 4096);
+        {
+            ctsha::verified_file file(directory / "data", directory / "tree", root);
+            check(file.block(0).size() == 4096, "block next to a modified level 1 hash block");
+            check_throws<ctsha::verity_error>([&]() { file.block(128 * 128); }, "modified level 1 hash block");
+        }
+        std::filesystem::copy_file(pristine, directory / "tree", std::filesystem::copy_options::overwrite_existing);
+
+        // A modified top block, a wrong root, or data of the wrong size are detected when the file is opened.
+        corrupt(directory / "tree", 4096 + 1);
+        check_throws<ctsha::verity_error>([&]() { ctsha::verified_file(directory / "data", directory / "tree", root); },
+                                          "modified top block");
+        std::filesystem::copy_file(pristine, directory / "tree", std::filesystem::copy_options::overwrite_existing);
+        auto wrong_root = root;
+        wrong_root.at(0) ^= std::byte{1};
+        check_throws<ctsha::verity_error>(
+            [&]() { ctsha::verified_file(directory / "data", directory / "tree", wrong_root); }, "wrong root");
+        std::filesystem::resize_file(directory / "data", data.size() - 1);
+        check_throws<ctsha::verity_error>([&]() { ctsha::verified_file(directory / "data", directory / "tree", root); },
+                                          "truncated data");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        ++failures;
+    }
+    std::filesystem::remove_all(directory);
+
+    std::cout << "Verity tests " << (failures == 0 ? "passed" : "FAILED") << std::endl;
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,4 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(monte_carlo_checkpoint([](const auto& m) { return ctsha::sha1(m); }, "3230624caa6e9f700c3ef772fb9487a7fff844eb"_hex_bytes) == "2ce268af77609aee5769935728d6bb35982917c6"_hex_bytes);
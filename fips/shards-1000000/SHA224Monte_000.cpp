@@ -0,0 +1,4 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(monte_carlo_checkpoint([](const auto& m) { return ctsha::sha224(m); }, "6d528b94d6646cfe2c048747e0d8faccbd6e8dce537cee8f2ed45b78"_hex_bytes) == "a8a34fd61e831355f1eedb10e9465ba3784d763187e63860dac79801"_hex_bytes);
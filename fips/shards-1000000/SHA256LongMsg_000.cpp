@@ -0,0 +1,6 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha256("35b8f931086761b3cf3f6c795d30eb7f7701b10ebf14582bf161951281ee0a745547d3b05ff9e5a92b37c41ab3306ee6d7dd601eca4976b61dbaa89c6d10ace0629803f71bdb1cbd90d890de8d17c76b126a363212a06f9fd0f21fad3a2303bcb41340dd5a398cd24e0064d6da9ca8df50863f481816e42085945bf47b57009d83381e5c0ab62003b74b0d50dac2ef04d2282e055ea7c596547e00e70762734e132b926a209c33a2fa201107dd055a4e3e91c149569ccc504392a5c9f78c91ed9e0a02b48b50ccd0d0f3f8197e7ae0791e3eefd5deb7891cb4dbaac2cb06fe1846ae9f0ec828d3c42362aa2629191796a42187283d045f88151eaa53680b80d0d4cfd56a54fe5b2c6473096b74e150f377ea2959b8abec6025ed341417bc3b9744a9be7e54392eaf652b4ebb563b7bf0e853f43823f135b4d4d4a7b211b9a9e41150534435539ab37876b00ea94e242abcb2f2eeb32de9d61fc4659613a771ca08c9fcdf99e36cc4892d4b037cf9a0a12a9c495800671e88f13085aa988eb97462e92189c1474930ac3d984a1a4d07d050782f6688e943f25ad9be980bc12b8b46f6039a5bbb5225880341aeb84e3867e58d696be566262ed0d0dcea58fe8537679a31bf9fb12e026da3316ce6ccc4667fdfda41b48db83f17c2bffb5ea329e87d9dd5cccc426f620851b14498a4290c191f84626078abc06f29933e6e3785bf41882d64a208b3d02c6c1409e59c7909c6e959e11104429bf4f711e77e642406dc49021d8aa52271014431b2668ef659ec49a252c96a9882eae0455e5950ffd0a65647870bce8b58b437801659d90c210a04ecdcbb4a5a1c04bc2a1c3e4a4f0b82706224b0d0b0fcc4618961d27ac26f33a556ce7aa2be106a53a49be933075fbc67518e523861c0dd9e692190ffec741984a6c84faca8e75632e9404e00c456433769381cfb72cbb2962e72bc0c30868e949e5ddcfaa4c08fce6ad5b324e49b9dcab30e914239a5797caf4717b25580cc1e7399acaf1501d3910332469037158b1af4ff1a696218b28fbe73a4a5fc11444160781b2d111a61b7d350636abf7c750dd7a3c542af4430e793cdcd336aa3b3c9c7ee9c23f61cf83aa75d58a2d14b585db9ce2c6e4ff9bf8b599cf711c444ea9caf3eb0da7b3702ec3da6fe6b330b98d369a1d963555918fcde3a5805142ae9dcb2611cb6f32fbb5cc37b298410d14a88de70a7dd6f346eb8ff52a0c33976ccdbedca92406ca60c2428a2d81cf83b07ec7cf094c2b3846a1f3f343e17295a94d01f2a3a624ae7045e646e6d5301b90c771748553a79d14a6ab11a24bf919c186ef10e29172cff6d3a3a0910d0e33a1708008333809c52be1b33aeac4dd32e8e2ce0323c1a1924134866d49b70912924879de6fd8bdcd8"_hex_bytes) == "8050ef1046815eb99dd738292f3f28f9728fc7a553268f4ead229b327febd8c7"_hex_bytes);
+static_assert(ctsha::sha256("7e0fbb36574d4de8550306d4c1a7f3910806002b437ef866352b8c3362429a45ac4a4135caf4731ae870f36f996abc940ef757c98f488ae2c0570ee498dbd0d6dcc758c1626126eea577c62791343fc60b6bcfe8c9802879ca3292e69381dfec7ab1a577b10a803df6a4991b1388c8cf5b29ab8700a2987437c4e6bca989f56eb41aced1a3f30e3da9e7eb3684466e00e30224400d180223eafac6b5d60864550f452869667904f3a37a41d0c6fe65cd84907154b80edb8bba30b1b15ad128257377136e8c47a26011f563367b0a8a0628f413cc38dccfc9b3f7bfa2ef834b523cd8452366cbd591e019a45c65abc08beb4ccb7c4dae687dc101f493456eaeae84180d257bcf5e12657d7aafdea51b02e0ada95273ff03c81691de07924a44ce00dbf848673ca1fcdf23a1b56a276fd63ed144c5d7dceaf57bdb7e210da4b2748bd5a055b0786240fb5057487213c3bfadf5bdb774f0d2ed79334a654d7340acd2e8e4ef346001e9ceff67e72657ed9919c1905857e09c9b09f5f296b8f7a12f29f659eada62a88f4586c4ac042be2e2b1f891c7993a00180b480f865114fbdfd2a2cb6e4d0cd7aecd76786c43f961ac135d295a02dd9f14df6963fb0c9d7530a804fdd76b74ef52514a52e8b6317a94d9dce502cf4ade81c6ba9bdbf636a932554f9b5c2ce6fed033f4c5c0b99e99e5f2ee9a86f37da86fdb9b3a17a8c5f136253feeab91c520bc67fb2128e7baa99a3dc41c6fedf33c93b77d39f54fdf1b160c12308d356a3285082b9455ec445f6761cae82e2341f5b0851085615a52ed50ddd54c780095111e58cde3496fef6535403783970db6a19110a70902c5eb59c26e03654bf91bbbc7d258f451595aed3b6c0a840eba2ca0d6b2f2dc822990f2faea76ef9a9743c51f3065ff7c0fd79a5944a61179b8be3e80acd71c387553c9076fb77d2b656efa41d30cbed83644fddca438e9dc8201efbb0690a34ecbacff2fa9c01a06e9fc4c7f35af3b654273bf8c4f1cd19f958fd5280a8c35961e6b8a1639f064077405edea66f548b017b04e3e728e792a1ae850334b0452e3450a1bcd2f9cca9698be277a1e0287268cbbe48255631364dc80c17690b83274833bf4d6cabfb7ee88d678bd5c56574a2abb6369da2836a763f4c1c35980c0bd7250dc3b39d8c2c522c84f5a21e5206256c28b4848aeab874d3eb070571f835c46695806e51694ab67ac5cfbd56918de74b7800ab335771cfb921bf7cbc0c2ba178f94e5600367925bf08c97b898e590214ba29ca9410471985f2d36e753d759699e6eacedef22b389502ea863a187c9ad69c56addb9b03cac0fc18197eb975f4cfea917a5ec79d110e0527171ca334e74b10addeee347f05b0dc490f5051bc9952acd5d46127c53095bd7a84b860fa02c009b6e44a6bf70755f96a79e1731bf9317f923f3f07c5ba686a950fc24f9ad5b36cc157119e7551b7f15b81fb54173769ad819a6403b737b23b04b7187fa920042ace3d4aa374e69bd51e5ecbad632e1df8a1403b4c03263b25e153408f30973e9558ac43131193ca17b6febef4cab1bdd387034a140c5f6148e277032975b21101b65b022dfe975200e9f11862875e7b2929989f78f2ab1a3c920065b112744c8e5ad7034744916aa74c93bdea41d833a634f13ce80d751418809b6b925e75dc7848ea5ef6b2eb4f0be90439905d53323e5e7668b8de06584f12e455d7aae8b4321454fd60e454202ae6da4ebacf42b7f7ced259e77c41f9bc636d20094088f1f8f69c0c6dd7cbb752d0d30a0676850e6b499dfb9d804da1d38c0f0ed0a2f18a24aa75af114ae6a3e4475b95e24eec7b1a59b95e8406280a1a3a08929781d2b1bd0c7941492f8daa6f3f3fd35fb7825bf8345cd8222cade808ffb8c66b8a1b6265af8a20ca8a49dc22e65a3eef9c73e0a656e64a4201c6898565b900f4d811b7e01922f239c71eb45e0c7343e210c09992782eb39ae89f7a23e241574f8f36cc5f1bc0ebd80618a5d6697048f773ec1dd4c7ab967e79c4be3c8ee02d53a2fdeb10dcb4375249a2d0bc5b1c0fa2e46ab23ac448f5d507601428edc7e02b0b945a6742d56e1c1f26ed9d590d1d23bba7e3d1ff78bf5da6071596d5af1f45626ca9a39d8e80c82b975cd0643f31fa8d8b1b45f27ba291c124094526b6743c7cbaade24c8b64a4b3d76a1e9c3b270435b5a89967874f34f54b34a8aee924e1a8a96967430aa4c2a90918dfda9abd6e403129915c4d946963bd7f7ce3ffa3522d5e69c79890e8b4495eb4993e353da99896854793cc908fa4dc69c7dbc4b52d4e7be40f5968ad5e5dbae48bd0d9238a579c107739840af5fc5f75a3ce562f33c232cbaf4a0e7dbbe5d6ec0fd24feac04a4d42db4be403a8e68cf449ba246226bbcf230181dc15880ff56c1463de0401b27ec476e572e5d9e81e1edff1bff95a64ff58276e5b115c99d91c9adfb74e56d84b3764e775ff9419143b85897d70cd9aea6e1918f9299201d36f726adfd54b64be74120864414443e58810044191e566b7e88c14aab79deea1bf89c6b3254a53f30cfa0b922405824bf0d5b8723a5d24558f03ff07b5fcac0683e44ae02653099426ec2e414cecbc2ec4e6f87a68918a1ce1ffc377869490c5d01dc8b8e00341bc15e810cd0fd58958854feb67c8373af6eea1888b1fe646bdb5ca5f60be7df8467ae5ae29d5dd86e611e296455b8d0726900e1b913954e3b732c51d5e032ab089d1fd7a0804ec65cbea54540f5f2c8ce5b8cebc6ad48bd25480b37778990670705ca1ae022e64a9f375057263a374d03fe32b148080ea7fe5f50fe3e8450acb4743100f454851c388da193aeb88d5294c1ca64b121e10bee9e27ce8c8669ede576e503da978f1e126cdb8b7be3b3a8d09500895f8d03244952f1359a8ccba63d2e3b4eb924337ea1126d72b24720403b794765f484cab631af006962875b2ef43e0b4bce95881e3877960da30df550625ad749e9e342b33b16194cb9c429aaa3ba2b188a44f98985294daf4475e1da2f7f82f1c07d0a7fd0d4ad17340b0182c738b864d122f045621e30bbba30f595af09e30b5e001f1f887f5619d7159ea6610ac7c93618d8bc0a64bbe10441c2fbc731a40a67339c10e04c03ec2d51c2f09679af57c99a4078ae22f2963ac3df747f72ef71aac0ebf9642941bd0759691b347310e0aa97670e6abeaefeb0351b31d0d60c64c22eeede3b69238230591844713562926992db8558cca001bcca3c107e5f598f9841bd4be8e9b3f175835ba0fc0ae8ce4ddeac5500d22969021d3240377e5fd3821b861d5ebca350f5ac4e1c26bb94f196e76f214469f78c91143b5ebb994e6f0786cbdfb0e5c540c666e61d9187841464c2ed77768143ac1605fb3d4d48118f9a03046ece38b6da416c2832e4e027096f37120358f9f787f29cda9808cebafb8373a3b359082ec3b98aeec776a179de51305738e05a410aa8620498206d1e5ca0830aa8f5acb925b98c5aa41679239837fbf9b564d76772587ae8691663b97c6449600c8a2808b50006258e5b33d96294c89f16d0d55aee8e420f8122ef6fdfcc8632615da82c0b5f27763c91bc3a28a00c6164b507c49089f04a13ccf1f003643a8ee84a5cf3733c40a9679edcd3d756e67e0cc50e6b5543e56c95e45e668f5957250bc7870c5f978fd627b61ebdd93ae5b1ecb2d32315a8509070414e00e20d6ada50fe303381c36de827d6c2d992f2edc23eb016f878bd6b3ac0c434ccd0615c1b21da16becf542949474e4dc4e9f0ecbd851bf2c2c4c13424f79515e7378e590ef5116afb0ffcacfa96ecbb57a0aacd9a140590f9956cca18aed0454a45ba281bd8e9e7df2b0702736939a7bfb59725bf4e1a22ef87b36a5b7f4ceee002a3c3d62de1d0d718634fcb12d11f41d3f68fd913e71dcd2824daa04e30949286770240d7922cb0a047311820efcf64f5470b5a0aadc4a5cab7c08553edc59f97bb7714c0832e4c7ebb8df9be3dbe130368b0c00641f018993282c4b281b0f6b0d27f69637908cd2a5b6b02804aea80244d728c542f98d67f8377622f08734e1b7162377cfa2e90e5eee0e547af9e413546409573dac25ad258f61c29ded23391126f1a1259c8a77afa7bbaeda86f59453adfa51d36f355c788b0ca01d1fdf4b57f60fa9d3c55f1802933c2a20a2bae136729d26534a0ebf632dfae2e6dc65ab7501aea265974618700"_hex_bytes) == "31d5fce8f7e30f7957cf79387660680a1c701045d9cd8194c5f2e499e897c2aa"_hex_bytes);
+static_assert(ctsha::sha256("e072abb2f4c01c745c892a97d2c9770362503e0be89f26961b70052838237638ebbb80562f8b2b0120cd1befe5f9171a4c0d35c8512b8cc2e116fc0d417c914809c8fc0f79eb58b71233f1b144beb7b56e2355ace44d8501fa3f8be7622a016cb155bffee5da45a0ffc86c3117b5d42f88a102b20b3251761341d54dd9ba9b5b861da2cbbf141e01a6d8385df20bad34b4ac4c551e559efdee4cf810b0b0abac1434cfd0ffed6b6637171cf6807829c5ad3376c996b1d80717833da941ad1c32bea5f28f815af59e5d016a564d8ef830fd8f4f5c0d1d11ff5cbe706c0e8d74f915342ea4e6f37bdb6c0a4360528a0bbfe99197bf4afea7e0b2005f1436de4cd5a6915451f8d81b5f43b739c8d791ad59ca88f3d07470c97c4323b3d6fc619c77b72e601141da52fdec35e75a70a1613c93ff780495a398615df2b170e75bf5d3dd23db1640fe3c9b9bb8dcd594ccfffd4886b1cb179a4a9a9d5611c228865ddecd1be459e8fb199cf73d2ac42be0be71d7a52bc1b1291b71dc26135f6bd335c66f69dde9a97ab614ef1092ec62a28d9f0aafb4a6fe72a56891a8c0f45278fad3a6fda41e4de9d51d46b0dd87710edc5d5c78ff6d4456fc4b0911f54a60dc7ce84d84c17f424b31fa89f7fc4de32146ab0f2edcc301be9da8175a7348e70679e2bb241bba0476b63fe5c69cf2ef4fb66a1e57cac2"_hex_bytes) == "959a5a0b31eea6583a7ad21e199fdc0bf0c165cf531676cf46ac0c45b6bdbfad"_hex_bytes);
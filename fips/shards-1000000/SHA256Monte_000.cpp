@@ -0,0 +1,4 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(monte_carlo_checkpoint([](const auto& m) { return ctsha::sha256(m); }, "69fc97e563423d595ebe9c5e74798d1287465c106176b67a88889c8ff0b96741"_hex_bytes) == "878b2793a1cbc9d08c26af6e96e92cdd2e6309ff6b2de1e29ee0d53b4bb208bf"_hex_bytes);
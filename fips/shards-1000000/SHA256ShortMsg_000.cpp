@@ -0,0 +1,8 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha256(std::array<std::byte, 0>{}) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"_hex_bytes);
+static_assert(ctsha::sha256("a4"_hex_bytes) == "88aa3e3b1f22c616b1817981215e7d1e75fa32b22233ebb8477f64600a5ace1f"_hex_bytes);
+static_assert(ctsha::sha256("11b8"_hex_bytes) == "ad2bc421cae77fc26c1feaaa8bccfa618f6f376b452899051d92584c9f7c430b"_hex_bytes);
+static_assert(ctsha::sha256("997318"_hex_bytes) == "4d7cbf81df48a4d108958b5fe2df54d374c902df07e3136fa33b5f0f50bfb255"_hex_bytes);
+static_assert(ctsha::sha256("1864876a"_hex_bytes) == "62e0100e6308c42056d4829ed3d8843697f3eb8d1567296b7dfdbd46feca720a"_hex_bytes);
@@ -0,0 +1,4 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(monte_carlo_checkpoint([](const auto& m) { return ctsha::sha384(m); }, "f616539dd515afff012a27e3a3a09fbdc88bd1f14a99ccc877aab72c80822143790aef657e7582090812e99b51451aaf"_hex_bytes) == "c7dac9735496dae6059e3bf6cf6d9b838b974921f7515b8a674778f42f675ec1cb2910b0eef6416a2a24199c03a8dcc2"_hex_bytes);
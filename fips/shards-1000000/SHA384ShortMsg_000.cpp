@@ -0,0 +1,8 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha384(std::array<std::byte, 0>{}) == "38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b"_hex_bytes);
+static_assert(ctsha::sha384("cb"_hex_bytes) == "f07de3c1bcf1fbef0bc7133852152c78fa87c16256ec319558e290423cd6f3f8f6e8c3e5d6de4b3a11731dc8ce4dca47"_hex_bytes);
+static_assert(ctsha::sha384("38b6"_hex_bytes) == "2bffe2a508b9c8ba20a758c0ebc77a119af3560d27ff0536915dfeaa148d6545dc52671065d5fdceedc4d16ee8b9812d"_hex_bytes);
+static_assert(ctsha::sha384("c44401"_hex_bytes) == "b8748adaa36903132b4ad35cb1cf265a16d58322dde80aac2bb7d2862b5d2d2cce41591c82a531612f3e42ec0a5da566"_hex_bytes);
+static_assert(ctsha::sha384("ee3dd881"_hex_bytes) == "2ab3ec2166dc701a634caecf94a8b0eae27ad319d11eaab37aa52a7b9912bb413e701a78ad3bbc8b00d5f18b5cfcce78"_hex_bytes);
@@ -0,0 +1,6 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha512("88f4a7b12fe2c082aaf99cf492e879a9a76eb3f460511bb39d77896796e6861c42dc308ffc789d6ab58c8321193cd5a6460e3120abf5779be963fb024117b661237279ec25220917f8402b98e50d7e9e02eaeff300046a6c9bd61fa9ac60ab0201390b58f23e85e6955af7abb4cc8a49919b50f3ba9fd5316a263e8e9fbae26912a8a82d2ebd3b3bc71dec331b2a752b9719e132f6331d608973f71eb2ddb7a1748329eb279a0e30a261738843d957ee18b8ab5de95584ebf8757e805fa1ef1e035cb28b2296107c30b681afe19e95b9f92444bfb0592e5eb7605e07dfa5f4c279aee9fe0166fa3c5ba2e54a33c5d854810a28390c7c0a76caad9f9a36045442549beaf9711cd7959e63078541fd93ab33b266acf655f8b3b02b77a28097add824535f2e75d291a9ec731867a693b7a13e06e2faeeb7cd4fa3d57f12b930526ec8a95c4958894a2077ca19cf8b34e19ffa9d797218103efa6de403b1ab052007ffe6acdeea679766dc51cfa5424fee294a0e3707f09a7aa2802e027afdab6c0a73504ec3d9d4be8c366b3a05c6d88791113fa5407b908d14a913a8035d3a5456bf009ee8d784eeb4045ea364c7e5e6a18bb9656afc9f5fd573ce320c357d7e4ddda3ffbb4d2c0727620474497b8d3c3e3a80adbc6c67a46a9ef56d82bd5ba33c6823f7a01eb1eb5e88ab8b42182670be8dc2c6e7e7436c2e3be4ffcb4d65143685b33f9d282a45f8fedc59196278aefc7708b10e59984e808de8becad12350eb68900d7743bdcedc47abd589cc73a860f5dbb91871726bd7c44dc6228eca21a80dafc4971c7c0c94b7d4d8af50e97c80e307fbf332cdebc8251f5bc41d38d6a953ab7047efbcee008b723bb929957311b25cd0d87fffebac4ae516b07d0843024134abb197ca50956c8a3982faf347aaaa9f2c64eb21ce30f222e34c3015d6765cf053eb3787c73c34d023b264dee180e31aefa916d163b0a37798c8d75b0051121d604b9f89131a8e2b1dae6625fb1aa9893be1a25e7169277267354dfc6d7dbf28f9344b48a8df322ff5edc731ddff2a7db73cdaee4456407fccf5cec8c8b75be70f4201e66ebedef1601845531012dc502278367e7b9b7a26b7e6945116bfa3c3b8600129d8ef61aee216497b0142154467ec0a4ec5048325378c26a9d620caeb5502b4d5ae3264db83106a4a02d0d7b176e1826c25d6a759454acfc9150cbbffd6508ed29f444f431eb2af2921f6054d8fb1b60d36cf0433989b93592f06793e1142fc6bfcc52e04713e2d09b29e35aaa952c022bffed4a2e256e0684a3daddc20d064c791305fe87e44479f4fc229267780753c74d402f882bf074b15ea1fc4944abddd374be3d13522b6309b491d4641e81a5e1890db9dde2a0cf091d0847505470b42d389"_hex_bytes) == "ed825059eb9c59eb1b721aeca1264f7f2b37805bbe17c43e7627aab99f6ad0049e549052a37d97b6ba2146bd8ea2312cff94d26d2305274c967932b79d808432"_hex_bytes);
+static_assert(ctsha::sha512("3af6b684421982cd1fbb73c9e90af74b68890f4211629ae281891bd7c0e298a7d647701effcb7d2ae1938bc60c4beb71eae5af6470ca4935f4887f6895cb95e6e3dada6d4bc6cde928a724a7dfb649cea1565268b89770b06d77d6348d2441ef57b22c36e84ac47e145506ff4703450332a261919207288b6f3b28f612ba9e71fb4ce51e831a2d9ced52c0c20446af3f815a505820dd26f2a042a91398694f5bbed45e6200e7c4c086e145f93e24df9325dd9003b3836f5f45907ddf4b3f5bc768bb0d23df63ff0e16b01b6b49217b39a25cc44faedbe69a4f8643d4b27eddbd1958a1abad22bf28526a258fe4100fcb5d12fb9cb8d8c00659905cf8d2eff831653b9f55c3ccdb7ca36d215767b9316d5142c2826dddcddbd972bde037d9ff5b15322d03feb42634df762d1c14351348bbdb1a691c80e9becfc97b3c13a55902ef57233fd6c5b6e04fa87095e1d3d2be5e8f47ab7c2d3a37765aa9d9e433f04088efc78cdedb39fe14dc77bb65d94de075d0bceae8802057546cf6fcf16acc5f44800fe4dd48a70359cccafd853d690423c73f80cacf6d9d58896041f71f94573a871be3f01d3bb84eeb2582c99200bd48df16a63ff85e92caed36a01abc33228214e29f4b0b0eb12c4d637323508fa1a3b98a8a7a25709d0a5f3e30b743d2f82bf6028a282dd6ec45b299a9817a3372e7325c03f8108b50bb17cfdd639a60ce7ee619966ef8dd5ddfeea3392aada353b1893a189255c62eb4a9dc5592cc16ec98574249ccae30d7590b77488ea5f69c4779245832c52327f66dfdfe0685381961a7b71ff4b241869ab2011458c404eaa99963b11c70982d4267122b426b4ed26fc710e86dfc5c99bd9ca947ab6cea21dce4152caf5440397997a365b712e9d728f7c71351fc5ca6215d517eeef855f922bf8b178dac848a82bc21df3a6839650a31777f88f387a041377587954b2681754d0500c9947842ee7f37174ba6d3ca37d526046edc7895788b25e427495cf0b3df9b3ca213a449836eeede46ad23009e3d79f1db30a37604f38c825d793efd0b2e37f54c64df36d2a415bbaf3d087a561381adbfc9d197014ed210cf501a3a2f4e3cab7f784b5d51f3577e8e9cf6af55e68804b23c19a745e256a274a160d6bba33e3a2662dc15da2c4c79d9424bea4b4e7240c97b6111e0a607102c1aef6f9f120445ba44f94f360746c4a6731d0114c1e694307af19eeef30cd0957aec3662665f5f1211d0e195cf94a3430a75f66542aa548ac5cfa324fe6de9b2fdc75f4ca12a0ee2c01c95c24cbc476a99e1e444cca80eafa575b18faf964f5321ef5f7ecc500b74e42f7829e4183b35feeba4991f031f69ed106ab59548f7c05c32fcc0af5b3d8739803982f52360c71b1be0b78f279a9c69a6ba8bc7ada9f3b3ecc05e61788e94ed4a80a92f4a4a658accf662e07fee89f4a28533e7a1a1b90d21a9e0a1f201a7d966c768bb1eb188ae510583cba20640c8149b45c7c7e24da6d980cf2089d69a0026e55a315ba15c50801bbf9c8f2ddc882e43a3e4447137d8da1b91f245149ac50dffe91bc3a450e5a4d8ea9640015cfd99561f2217c771e8c9952836a7bec611106a594d4e190e906d573d1e6f5fa4b4e0451c09763e91f50b7d43b4f31d483b09af12b24f0e114d4c322e4251c0b5aa4b0fd6f4cd3d5c582f22699434e331f2f3265f4187e079cf74fc0f0ca37d8624c632a56b322f297b3cec5ec543327efebff8e7adbc9f3dafcb5050c3bdc792d9669a03866d97c801d33ec38e4593c80b519d1ba595b86c26e227042a5f9983c1cd4c2234dd1ba27f202395af5cb08341d66e44798e37fc5c624cd8703c65466bb1772c9f734279798b2d8653941274778638902d4dc75128ee8f5727175f82476cb124dff398d880d2f29f954f60bd8cfecec805c4fe67e3a208ee00d607bdd69eaec3c9f3674a95c4d4135f1e063c7acdc0f88c58478bd5a98b9da6927f2435a6dec20292429222812cbc49dc2ccb4fd041ff7fd20e2155fd620fd474d76dea913a08c6ba0b512efb5140f823c6f81c16aee8e4a14f891072b14859b401d7751e37a8db1ba1537c19895d33693b49efa23e71e6f2d12105af5a4777c1485c3e86a76511cc824d1431db5aa32e0225278212c45923c1a317be5219031b4562b089023cde964037a268003193fd73de5cf9aa9fd73070006fbc8971623ac3629f61ad9b40c3d23b615b039f485c97e3230c805e7e24fca73b19ab64cd0862e8420a7ffabca3dcc7b2d359fe491e7b4ca56a02d8ceaeb00c381e6370bf711e97509217bc82c4ba1d68778295856c4e84651e078cfc795ca6be9654d791f091d3ba5e91edbce2039ecd9621bae57ef99cafca4bc308e1482eadb7adb789818f8bf5cbc7b45c145f42b72717f689864540b86836f42d7a41b28c8115d1b705a65f7f5bee2c0aae011acd8897caea92bafad6898857eac8b88a05a57f60aff0b07f4b5db58d1392f17ef25ccc42e5a53e385e09ea6fbc15fd90cd8f4ac27e0a55878be99edd4b006d856300521e0c98fd5e6a5620964e5f91b5d6acb0671e8fd67741e0c75b074d2d6ff30d0df6bcd1b6db199a33ccab552639894578372922e4076600a693d73ebb45bb6a8b1a0d335db33306419f2fdc0b2381fa75adb17a18848d2ed1bd723cc2ce8e82be100128a36366539e67a1cf99cf769e55d5fd53ffd5d0a9b8279686257f44e34bd3acd4a95a716392d83cbfadf7d4a00ba034b705ec9086b7b4102e04a7b8c0ef696dae146c56e9ca638ebcbda3d36c000748c61e33c09e1900ddfd1fcd9331d0282e2a6f9c3c20148d918c91ca619c225baf0cc05ff582325538a748cb52343550b1364aa1c7924ff0b62a9da0853c6e9fa4c509cb5c4d704463ec6f4daa01c731d1669790da6a8b958eb64e8d119b9ed78da66751291328fec21c684c35576495be854976fc279bd24cf69bf35755e3afd7c198b2b2e361bfe326e37b33cc9484538c8142b4507804e79a1fbb66be1f4f7b1e757be9eb26bb9b5f5cea82bcf47ef52b74326828dbe15e231642885aaa915381fec17ff1ad3a732779b09c1c6eec0023f836c40767cfaab5ec7c94a5cd5a78ff5c74d35f565fd7ce87d0a4d3708e44d15a192b52d948325a1ae2f24c6516023740718213f04143312918b335541124edd911d0636d9c1c8c3425fe4447f2a044cd5c4538e15e1b6a6b114a0c743758557a00ef0d11ef1bc397534899bcef3a1254aad4b9d400c0bae63b5a8eb8da2a345334aa1e016aec1939e4e28bbc36f109c71628f3b26ca438c10dba8e85d15e84f012f3b9fe3e55ab6d5b936c2d170cbed504a0c7bc79e97d23cfb5105f54e7b7ebe8a9d32f3dce0a95f63a8924146553d37258ef85480bc029d2fca767f9b712e87d3adba941f0cd7358bf0b5d3644569b675def2cb5ad56d772f57eb578d3a4159cec3a3fc944c698f02e823ee333fb540e7e3ef80d1786d72b3f87c25258d8e127c001882deb72a8852afa10bd76055b0d191c811682c6b9a8fb2ad09ff9b779d577abd02e89335410e43288da7fd8a608c3858699bd36fd84fe493cd3f29f063ad880a1e8510d9db4ec21854bc14d0092330da037bead05bc204803f7cb705aa3040982f7c4750cca25414adb1305b656ac8c54cdc3ae101297fdc8b125b9a5cc6d69a86864f09cfcf3b9b1fc4a7c67eba910d2bc0475a534d3c73a661ea92e5779bebc24301d0390c6c0885d30dea68476a0a8a487c403af11d4e02e60b69b5778aa863ecfffc9e7b887ed8339c779e29df9f351d7f845c00c7e970729b5c956ea4fa76b459bd0f7a866492b042fd194db467ea9caf83fe462d22fe44aebdddc3b33a2a61115c1401005b119a666145347d9c5fff898939d5be41491b6f414fbd7a06f3e68fde952d23638292277f8b6685a51297c218d12df84c5f3c620fadfbf989bfed5f813b00ea2eaf1d599baf52e5696da7b5be53abbb8e7bde91282e14f8d207a106d41d435d6552dc8d206475ee42759c00bf013879303072a842ce60cb22bbccdf81691f25aa92ea1009546539396f407082c1d2ea8ef4576512c494d812fb1782b317cbf926caa943281116fc03415ea7088d85f04a15d0dcb25a83c1291bb30323b6f7d110c250243762689418c37bd9b04aadea4fab7698142ffe49d04869ed0d7c74f769575461c9d62cbb3e3462690fdda8a7731ff6323ef68006ec5"_hex_bytes) == "2ae05fbb1af2aaa446982fc87155c7b9e329009887f94fce0e867b88676a720dea9780ef7e1e73842e03e018509fdeab0b89c046f5ad857a91a68547907d8787"_hex_bytes);
+static_assert(ctsha::sha512("784711966192af4cb317b145e9e33b23da5ba2bfe0397e4f70622a2ffea074c5c7becd0e7bc51c57c76e30bb06b71d4ef3220b38cc07a5901f6017149ddd4489004b845fa4e8a5b70bdb76f107f89896991fa64faba192bf0755e4b7906ed4ee048941abf4194dcdbbc9f6727e02fd95f7365162ea17a71dc85e3070eef8750bbd9f661c08d209f258c573bcbec07ce24b50bd40af69c8bc79e325d2bdff57bd3e826292bc25402f9288b294f2a142efdadc03e7d8048c862ecf8e5492e38f2d00083289f6c955f3619fa8d04924acb053beb211f008e1a2a17dc73e87e26b37761908ba05b316977a11bfea7f243827e54826944b666a6ee1a3fbbc25a4ee34671f28e3212cd8d8abd71f2e649b6094792c1c84f5a83e1a07070a06b0fbbf78cfdbe64eb5e0c96709dc2ed09d5bb7202708037c2796b156aa1b4870a9ad0217a8dfa7ab2f41f727ea55142d2b674c747f9797ad4f4d80a10a1ce34b19cc0f8cf53c304faf8d843318af2f3bb1d845bc00e8dd49871ff156208f4a6c4c004ae8c35dccba5630fc130acd963c5c8a2d0325a4cd1b8f824ec02df299ff496d64a569b3d63bebf26a7446bce674ff17b51c8fae9cfcb94e4e90f2ab5bbd6310b64739f06a023a9baf468610e9a33b621f6f828586622eabf5c82ec751ac6ebb2dac5ccbe801a97d86cd2654c6b42e0bfe74210cd701"_hex_bytes) == "876d8af47934cf358cd159fddf5a7f8a7427fbe31038e7b2540a1ada27efdcf9909166d13a1ec657a8dca2eff37d452dee7445fd748231ea0e9d1a7b87effdea"_hex_bytes);
@@ -0,0 +1,4 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(monte_carlo_checkpoint([](const auto& m) { return ctsha::sha512(m); }, "2a90e17e5fe28c7d972825c1ebcf4f9e97e05fa1c857a069b7bf10cbf9781d71401c8f397594dbe4320cea50bc2cdd1b3943ae1f3588db8b96f2e9e10d0890c5"_hex_bytes) == "743e5b81b23a8ec569ff9d2a906c791de0ba0b90a33ba983a5d8ff67ea18511206fc06b7e8d8b7bdbad8e1be1aa3e1dabd245b856259b9ad1a45804cf8f1430d"_hex_bytes);
@@ -0,0 +1,8 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha512(std::array<std::byte, 0>{}) == "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e"_hex_bytes);
+static_assert(ctsha::sha512("61"_hex_bytes) == "1f40fc92da241694750979ee6cf582f2d5d7d28e18335de05abc54d0560e0f5302860c652bf08d560252aa5e74210546f369fbbbce8c12cfc7957b2652fe9a75"_hex_bytes);
+static_assert(ctsha::sha512("85f2"_hex_bytes) == "652504371527b31aa5141175edc74880a50c97bbd28fe244f9e850f76314bbbd0c19b3e63b5a9df863fc0b5da35e251d791cca1fbee66548c6f9a1e33fccefbc"_hex_bytes);
+static_assert(ctsha::sha512("ac133d"_hex_bytes) == "0a4482a9550eae5a7dc654c497dabd0f8b2a232f0574246e81cab23370cd2384772dbd2be585f1985f7434e0e63de7654274cc76cfc9d7c172b814546add473c"_hex_bytes);
+static_assert(ctsha::sha512("3c7b6c8b"_hex_bytes) == "9f872c2eb3c52d444deee8ff6b523f4f92658329efae7ff484b8f02fd022e5d07b49cd8c741fc44c90b6a894371da984d1af067a106055fe57bb8e07e7aa3a7f"_hex_bytes);
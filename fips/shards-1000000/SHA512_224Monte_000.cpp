@@ -0,0 +1,4 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(monte_carlo_checkpoint([](const auto& m) { return ctsha::sha512_t<224>(m); }, "ad001c33e9228f136a9f655151c83af2cb308ff1fa5097cd705106b9"_hex_bytes) == "42e10d48d93e1596813c0a144b95ef2e9abc7d6660b02e7a35bacbd4"_hex_bytes);
@@ -0,0 +1,8 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha512_t<224>(std::array<std::byte, 0>{}) == "6ed0dd02806fa89e25de060c19d3ac86cabb87d6a0ddd05c333b84f4"_hex_bytes);
+static_assert(ctsha::sha512_t<224>("2b"_hex_bytes) == "f006f700e82626387fd09c4e96e89033c9142568329930675e174047"_hex_bytes);
+static_assert(ctsha::sha512_t<224>("dadb"_hex_bytes) == "a42c230cc0383be1b4078f95d6f8656bb2aa1ec81a217a8210f8881a"_hex_bytes);
+static_assert(ctsha::sha512_t<224>("fdc2ad"_hex_bytes) == "e155f33f403f7a866dbdd7d3b5fdd69275914051af7067714dd0866a"_hex_bytes);
+static_assert(ctsha::sha512_t<224>("c0cf7e89"_hex_bytes) == "32ea59988b3082eb9bdfa302231c6e4901774d707efd29791396c7d6"_hex_bytes);
@@ -0,0 +1,4 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(monte_carlo_checkpoint([](const auto& m) { return ctsha::sha512_t<256>(m); }, "d71d6f46d4562d22bfa86f242e02d51d5d9076dafcf0e383264a3d4ba8b35b29"_hex_bytes) == "20c3a1d15792a8f9c399b9a39509e9723cc2608b4b992bd85ad1cedb72b5c360"_hex_bytes);
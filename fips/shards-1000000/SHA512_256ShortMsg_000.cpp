@@ -0,0 +1,8 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha512_t<256>(std::array<std::byte, 0>{}) == "c672b8d1ef56ed28ab87c3622c5114069bdd3ad7b8f9737498d0c01ecef0967a"_hex_bytes);
+static_assert(ctsha::sha512_t<256>("a7"_hex_bytes) == "1ea55aa0bb079318ac0807516cca0c083ee6a8cecc65e522e7d422643a3de2b5"_hex_bytes);
+static_assert(ctsha::sha512_t<256>("d5d4"_hex_bytes) == "c4f1e4d9d42c230052267baf86e7f290edaea444663a26edcb68b5c0982436db"_hex_bytes);
+static_assert(ctsha::sha512_t<256>("4b1611"_hex_bytes) == "149e592a62300771690a002fb1f69ccfbcc04cd13220644fffaedc4c6662d479"_hex_bytes);
+static_assert(ctsha::sha512_t<256>("0326e3eb"_hex_bytes) == "fcfbbbf63359e8fb12b0c10a2e428105e63acbf704feb993e13582e4097be9ef"_hex_bytes);
@@ -0,0 +1,6 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha1("f90ec7dd01e4887534a20f0b0d04c36ed80e71e0fd77b07670eb940bd5335f973daad8619b91ffc911f57cced458bbbf2ce03753c9bdfa0ff0169dc9575674066676cfb0b4eb8902c44269da1cf6ba66d3f8b6d4b100a9ea0e755a5c2e8210242a08e7078f7f89385eb09423555182568b96e8a4fef23a0c9fc5afd7608437816bdd0a7309cb4a1252e4da70e6720fcaa4da1e98406c189c24279e9851d5814204136feb5713c166b13269dd63fc35c797ff08a6cd90095066a745addb6d8831c2b0f87821142b4456556d89aa82bcadae3a9578fa4535a414d025c24b40ae3ac127722988ba973aea8d37179706072ed33a14607ad7523be6557b5134dec19681f4a1336aa2140d0597a3e6c8a0cc2020a2e939806ef0b6845d6a9d657eb8298f2de52ead74c79d15a75fa29b7dab332f7d700a7ccd258924260b0594b7fcf04e33a727585b4c48a39c369640694810a1695b99dd50187e8120e4dc80e0e805caad5784f80cd5091fb5464046848dcbcd582d77f8035aa2e0737aa0fdf573d3ac8c701824bc51689f9899be54ed2b3fc15a4f80da6f1afdc9b2c454142e8233882a4729e37bc3ddcb54a6e040f96c3ddcd13c978e7fc10261e00a0f7c856958914b668b9f80e456b6fbd73e6ac46891370c3c06974526bf9fdfb6a5003fe2e6b39cccadfc39c1c368018e65ecd19c57e665b801c7dacfac22fc7e940ad04fcb8a5b2505b287d29b4dec84f856ef178a32d823b522e20a54522fcd8d9b6a6a79aa892326bcef1956988ab676c8cc58f784a871847d0fcea2dd7f89612554e34b86eb534646e1b89ecd7b3b699c223674cba4fc335f171c0b6e11fde2af8c3c583071cc77fde6c156767891ecc76ce784a9fe386d28170702f5a3c49364cc514d0f07c64a1dc2824228ec9b07121f42158c3cdd2e610eff428e62e5c7a889857c7d1e59b3db1fb4d366d9238825805a314d1e68db161b2ef0bd32a0144010e241cae40c8a2e80a62b9a11c41d85a04285c23b9b30d97d69a9adc8f63542e50f955066bdc7a631d1b040211699a0d598a3b48ba6043e4ca2a6a723e78ff5e8bac2281c4418fb807dadb9bdce9dedae550e4b807144395ed21932883668852228256f58dd0bbcf9917066fc78d9e7bb60f62583d06704c2f927ced914b4ea036199023d9aa190d2d19de79a43e347538104d912bcd7cd90092e2e02c489ed8bbef6acc6e93bf7b54ad44b095885bc4193d38493d78cddabf86efbcdd92e2042694c750d34814ff532cc5f012dda1a6fd8b11834d63c878e5bf5186d2cc73fe596fec93bf5364cc5675583d593fc6dacf83404b1881ce19933758c8a7ed24b428363d01d4cd38a8ff59c88fb6dffbcf07bad5a5ce64c1da6456da1fcf5a83c414783732d19583b73669d"_hex_bytes) == "000c916d8365553e7c8e80d83cb11b8cc8b1650a"_hex_bytes);
+static_assert(ctsha::sha1("d8a7020a9c702b728fae89c20b3ea8b1473a804915b1272f3499a27f8919b90f2847ccbe7b30a88c04a439b4408acf2ef3d6c99a709a441b38597b6ede8c0a808a86f240ce35bf23b90f9de4434f26486ef7abba95514fc3e1cf3c4a8a97040443c233eb0fddd88dbdd1cfec1b32f11300153847b68ab6f27d7a36b7513b14a0d8b1811cded4c0b796aee179491cae3a58f9ae3e0bf56bc459cb74337faba87decf1bdfc63dde1cc3df988404c06c0d4370d265deac1934f4e368209edcb74c8027fd8515baf7a265259c00b6fda781461277ecbee3c18c62d30f5177a060a9fee8ed45544a2e5d555cac766fd8eb84d848f592ab8ac49848281b2c48eef064c428173642465db7a47ebc8642a274e1d0fcfc3d54642257bc3479267cbb65b739849b2fb952d996aed0b9434bee3821d1aa151433439de7d6acb3e6cc44482013d67c1f67689135577d28cd7cc8bfc32425f08e816fa6dc9ac7c302715d8e2605861c5b86477b821ae1aea165a4b92f01621ca2fcc9ac989b4f019f408da9ba24c8e21b8d4c80c3a120733aaacbc11bd25f82ae4ab0152a6b86d4a4b37cea2d7b8ae85bc13207e87cb912a265788d32a409086786b328df5189a6826a1ad974412e2ba130ea1d55314d95e65773a423e88ea641cb8e9abb5700407fa1054811404752b5811666be2937cfbbea6c825635c6098daf2ba0bf90a35ddafad25d763fdf4e6f154899aca84829e0717eaeab676e36bf3ab4ac4df1b38b604821b9cc107a6ad9e196a29a83d214196d1ae770d5dbb9a96c1d7ec2565d076157b727ccac26b4d99b8009de3fe574a0fbddfaffaa239958ddb059f2cfb3a7087dfbe761b3453429518226f011fd80a211c0411adaa09046cf066889780775d6bc81e7ae712a9a7d03d085e2f5e6f735a9b321ea04a20e24c761692b01d2de266745e3d1d671b3b2c709281d87f108063a6b3b6e8c3c52dda7dfaaf5b3a7a25df8d9babbdd1e9bab4a1caf108bd419a569a404c55ea4d4552288178b6a1578df29e27db4eb4e6374fa1235ff5111762b6bbb5bfaf3d5ec0108a6b1f7e9ba7ce7db81976940364314572bc88485374269fdde0f35db664dd258d697548446a0a53f8b95e19b82a796c2ce164af54096fa1f5121abbffb245f922a39fa22df6add4248620a5095ca773a086819cf9d406965394183bdcdc6f8eb6fd908358a549b430cbb662cae64cf67c137e282413f1f7a757fecb06c5e654bf1abcb4e0799b2de2b6635244e217baac58fbf404771ee3536accee3fa1864656a8435c9d77daefea9f569e69904f03ae3cd9c25be1e6e2ba691b2b3631c646e3cb5df3e51263e6fac794b2588b5c0e1f2175e4a3e2ab34c61bef8ed1eea93154cddaf44ca34ab34663736ee84f3434d91ae84dbfa48fcb07c6f9e49a9bc6a0945933fa5ce44eea363fa3a1fdaea3eca5f8c96f557b667d1aa41fa8d60fb0b8b9d16b9372a0cbc45904c7b3717721a3c4689631de02b32fd04e395bae49c0dfa68d6a635154524b3de242dc44aaa2460ab7597378fefa112d44f0496bb8468fb221c4f30fec647b69029b158860243638cca935e4f78f49dcbeb2c4d2dfbc6964214a797a0a7bc9e9e1301b580316dc8ed44378bfd4af18e842ba1eb23c7d3fdf4c09bb424d930cf10df722dc2ff03141c9d17bc2f4a2e03b226bbd3531b53664382c01dd782e9df91fdb98c8140e8df4e07089a4f4e21c8958e0e9975da4cbd3cbf4709c08204bfc3bb8849e9b463646e913e4f0a6be4007678921ec9106880bcd3932a4e52effaf1660561c3b153c9c66524c746f2db4de8844927f23871d0bdd90f3d8df225e6d11dbd4b5b54b5b73751ebb22e4a46f70834fc336f400f19f86956a43c211c3ea0c4376fc3297df66aa327f7cfb3b5bfeb7ddccd70ccc48d9411f95c6dc30678af5d88736a64e840c31bde8873091472bd0c20ef542c8fb770ec01fd22b7f14e82a9614b1152225179db59d2ef0b7a757b57fa7777f6f9f9ca59a02f681754b7b522b84cc67465425a1c56c5113e46ecd399f7094e4ac2a2324763dedea0555eadd3862077c9d6d969d87b28893180e05e1156927a1e79b3a7e38620f63450de10e74f358047246200846a42b8563cb048fb484c5ceee8e2d5cf5c9446a0d1aa24a70a3cb14d1f3211143d2c78b166f639bc2990b886153752d6bf5541ace90074d3214dcf3596fef37cf722041adf3fcbcdd7fe285ceb6c575c1365cb0260dd6fc1feb3877e8b32eab128dab4255dc9fe27cfac40e823d92840c2ba65c70962957e9becce7f134fa2a111e098e12899f5af4ac08e8af7973b11d0be165c94e5b7629ca1459a302e85313d87183e06014c1d2ccda8be2ac0c28f1d652dc525888d3f692b1e9cbc0927ab773870a2586c7528781fb0851f738704d39c41d582230efef0c1d8a1af16ab6e038ada3c3c7942a75e1b2dadcdf885f4d1ba9b4c022a25a4a3a68f477b75268995746ccd9fab311260cbc7f4f6dcae38bdaadf6ae291c47f05a2e04210c5d8e63ebcd8a87c435caed7b24a0440dc11c94b008e0a205a1c81ae431d8cf3f0805d1b259cf144992d255f0968311c8d24aa557e8c94028c985c8fa11945189c68c3f82043d36ef4dee7b791573283731133a1681d44bb13a19c77251fa57b4cb57a62419079832e62c00188f9c82eac43c729c400cbbe430dc4f8c3abf816ca848720375f7b741d1afdae139801b97a3656a757bc0b18300fb47daf72e8d337037dacf483ae16e526e8bbba7b1804c0f7183f608af085966847525dabcbd613602c8ada8d2af83ce8db426df72f1b1900e361b5773e096d8cc0222cb4e6af2c9fc32d154fc6e9e12989647809bf344dfaaa46b8e149f96fe9987519486ab4c84c6e2fd56c4142f69a21a9c14d437a54205b07bb5de7b2a10ab09e30d568f6bdb94541613fec739c293df1975aad6f9682daccf5b78f824d6ca6f82009010852b5c81e5de9c33981bf459826a4015cc059801c3ae318352662559c10b70cf0902d4591bcad46151712ee7ab806282c67e95834b88b98d70600b356f8d56a470531070c686836c85c015104efedf9abbcfb665928f87f74eb648c71f248526fc6ae89d1489ac02fddcdcd8bbf863ddc894312952acbbdbc33fc01ade663975f4c458447031b1a5e155c1f75e13657f433d8c0602be926d1b9f4b412250d68942256252d56ec9fa5820ff7c68254d7d604b8421be28b68e5bf0dd71403cdedbbc72e3c8aa5d1a18bced52eebfb44fea66f4906a417090362d74d96d99fc1fc0681b9e996bdb06e9a6d67c35561ac35308fdf8bcda0edfc779041666a11245e05be74a4980c32f3f24c4f7bb6b13d170f665567964ad98f4786d903f0512a12d5be929d1471647a3b7e761cced2bc9bb05916cb6bf0330e4cf9d589970a8aa6c141a095deca612888b217f0642d3b18aff13c5389cd67f75df8705024df34cb3277e4f43cd47a96342463b41118e8bb4034a0420e9ddcb9e44c8dab8e5b395f35f89049f751bff1e0328ed017d43c8c6718d5d6f522ea9b12c3e7668a8e52adcb6545c34b55efc28e9dc6f202280a8c8bca7dc2461d2b1feb13de5a804739bd247628e17539e1d3888395ce77eefdc1b48fcb895c02ddf4277dbf920b95e1f686109b1797ad2d4547800701d4f2e0c488875b8aa463082d3b6151fea13a19f99c79dc5f7963d0536d9256a3f047df0246cae6d9792eeee6becc02a0f259ae66897d45ecac0ed717efc079589f2fcb4383d6de4c66ed71f5ac5d9bf482251176cee9e9af3440ae7deb0dfba6f8a68ecf28ad4918de32138a6e59374a37f4f50827fd20fdbcb7345242b54efc27095c88904914c3ddc909ad61f4c3154f9dd381db7a29d129ce710b0916c868c5692ad2d124143c4a5adf155950d87090bd7ed0cc7363f08c42dff6db510d1f1a3600441f1f180dd33d5e7972f1ad84eb3652ae9b938a93368a25152a9296a9621fbece3c5baf3594800599d5a4c6a447cea462bf8c7c9d9dff08ff44065c1128c47e16f4fc7e21fb1734f92faa94e21c92525000f262c43801f6adcac8eb56651d129b53bd8e6aa34051c4bd06c672252e90ca7969e4ee71a1693510ca10c4b81367783fdff622743920f7850597ceb370164bb578a30299976c098459a47983d99336ae1cc320fcaf40396f0f0bc5c6bf4667346dd65bafb74187d3ab922156cdda9d0e6e2ebe5be"_hex_bytes) == "406b4973a5e9e2acb951fa5e838ea21b59ef641d"_hex_bytes);
+static_assert(ctsha::sha1("1468844237d466a734027265c4639b9ebf770e7f8e9c5c3a07b24fc7fbe93973b31f2a7b5765da47c1cdb42a13e9b593bea8bf053ac69a8b1df58d1afba2dbe9705715cd8362a1673955d7d781422f847a8f5ee8d9084a9c4648d212effd16c63696d3ed37dad20d861f9584a60e471c6fa131539ad34928fd20dabb4cebcfa790ff2745092d69baf54b5943d91726b69f80b8bd9ed0ccf3e0bca6d34d43f48081daf11896fcb0fd43e44af24d77aa23ba57d7d19b8a7105f5b72986f8c9eb17da81f94ca44b69c33e38a449f0e54ffc4f1f60ccab84f99412df296d0da3cf957e99ddb3e2a68e3dbe11936837840884ab38cceb968fbe49fc1d35c1e3a003ee7845a04c68f85790b0706a1fe88dedecf0badad82273b01ca635c4ffa948672389fef9efa3ee29fc8f3a43d52f4ac331d86f4b01393329a93fbfd5ca26d3e699dfe1cb44eaf4c636aa8e48871630551202a7ad1552d7e008dccd3eca1d0e457af8c7a041934747484a79650f6cfaeabaf0db00d77ac2880da5377ddb8342efbc803e2eb3cfe2bad7e0ffc00e18f9a576340ab3275bf33e764aeb26558ef2ba5f771695e3e8907d059bf04c65645c9c248356c89a5ce8cb2fb6b6760154e84090c54cacaf80014960836d031d12eb917138274c675b0fdf5057e1a41ae4b792411a7c3ae7fb75a2399c4d88d6873a0902bd5e1da7"_hex_bytes) == "86627ffc37807b026fa1f3c09c4569d0f0d6f0d4"_hex_bytes);
@@ -0,0 +1,8 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha1(std::array<std::byte, 0>{}) == "da39a3ee5e6b4b0d3255bfef95601890afd80709"_hex_bytes);
+static_assert(ctsha::sha1("44"_hex_bytes) == "50c9e8d5fc98727b4bbc93cf5d64a68db647f04f"_hex_bytes);
+static_assert(ctsha::sha1("2082"_hex_bytes) == "38db783a88c88d8e7007e03f1323eae3f7accfb6"_hex_bytes);
+static_assert(ctsha::sha1("3cfde6"_hex_bytes) == "2c4d1e15c85d3d649982c99308c6c5872f865aca"_hex_bytes);
+static_assert(ctsha::sha1("f1c26b30"_hex_bytes) == "3c85c37e1c9c568de3982e27adda452ab435ad9a"_hex_bytes);
@@ -0,0 +1,6 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha224("ac2d6659b32dbd49b863ecc1e5b1287e7730782d9fbd293eb87f919e3f55d06ced456428de25c34e7c9a83f5c53c37b8e8f6ca6caa4c89a66417ce88a4374368bff0a6161cea44e8ff6d8e834f913ca272aea0643ed46cd7442dc60ec547c9b1cb4a2f7666f9f2c1a28104850cc3c94a578432d03af4ce1bf9292871acc5afb6807bd14671cd177e604bad5f376ad71aaab9b2df74b3c22473ef41b6bc2fedd6c18625eaef4c8607b9d879b3eea9e1054a7b32738bba725ee3b7bc135dc7b4b1d19a85ea2a1b35899e6cda667d8e2fd5c89395f82fd37266f63eb72a1029a57de22e6210e1432bf1211949fd40fddff59605803c2ebb11774d0bc31543aac425e69da769daf720c28102359a70c106c8262e7c20d6e49f1049fcf8bc4c3b698907fee7494ba1cce28beabdcb2a0b6e727eb1dd312a0e77a97a66532b521f9980aab2d8be6900ff435bc3015d0887bb6fd0607cd667d4c21657006a331d954bc9b85e56534bff2de55d9388b3e27c16756f897adc8f78b8fad267eaa11777714fd83f25d5dac3ea30671ec86a6cddf1bf35c096bca05ad77e6126742b82d772fc8311c9b0cdedd5681b92764d49ac97e7d99abfa08474e8c9a8136b30457eb449e4cc8006d5a149a32369c56bcc2eef6c3946c239c57deff7295202b41ceb45ffc467601fae64f58f5bfed5184f62059dd6245e0cc0944b92465798779de56c631a69c0a7b6c416ca2d50fc4eb49e5c14f6ecb6b0b16f447bd4207a8399edabe208fbf9430dd9c65f92c161cc0d7cf7aeb9e39e281da150451bb9f17b151107f4eaefdb7ccf5a357c919b750c3669db92fd8f9c38ee478fa09fad12986482ed7201a0e93821dab48115479cbfafcc5b1aefa75375f553dacb389f2eeb53defb47200ff5437a169ad3ed83b2aabb115cda71febe817c2184951196f4f6532f6519ad922173564adda066ee5e0067190827c6b9df605202da107d1fc939bdbf44c230a2fa01ef78ce28ddc009b09676cbfecebd191fd0db504aa96148fbd3a003bbbeb929c4431248199e87aa142841467aa26b50e365d1be439f5deb0c5b3e1048d4956c1d24d989f0e1ee29af36997516793b695bc9cf417669f94e3bc4e3b70af6f91e7f9158f022a22c859a421ea1284b42580c001f23b8f41827ebe8098db6e529b120595a02ca63724ff93eb2fb345a9e31992d3ba4e193e193e0ec4c9b8a279211ca42faa5863e94df717cc725cd4081158178ad2984c335437bf8a5ecd029ef12de65c9854144c11c091be101b1e4a75f6be16d66c7a9e28e8c52992c24f57c30ff3de65539a6c17231e675392cf3809a0aaac47cdc4ee522f383d1223ec43c88c1102fb026c8f0f550cc1585cbc8c5e7077c4225ffce6b36ec64cecfde0d8f0b16f9d6425a"_hex_bytes) == "7b234c61c8ec43236d5100d642bbf34ef2d1b655bbc5ad2d1fe66213"_hex_bytes);
+static_assert(ctsha::sha224("60c0912815d34aef519814999510a79610f92c53c4fc87e50bd7119719b166af5c7d462e14304f9da1fcf20ac5c2784835d5c57204a1d1c66f43df5a38399859b4f1fe52887a8724a67d708652431decb6427f9b15d9e4fc1b58c1ffa09d8e51b7bc2fdb7cba30b47c21bb9f16b506c53101015bec376ebf2246cd5ee0308bf55dbf4d3d4427ca525d729336196f036e06e262c0984cadbec13763ad04d8e462540b86ef772a216e477f7ab80965e6103259d241f8757a1cbe5653dc7d89b16797793415a89c5b40d3a2910b7e0ea2f41968cc32e1cffc67e536625983860322c50961aa8c69f44be715c2cacd1c1e94b57764ebf0f013613ca499db7f508d88bf36b8d9d9e7f572325ae7ef1d342bcdcc8861fbb7c0390679fac586882b53c9321a6cb05c59943b7707d693504a44a7613eabfc679f14615aa96162d838a7895b019bc3c5ce20a2ac458489e151ec62c4f02fe23e5f839ed2969866b6426e35dc6e86794322ac1ae4801d1d7d12b52f565c62601605d1fc1e7a7b37a6da5a10c59cb50febaec5e0fff2b553df1fa884180fc44ef364c7ef5b731e54d2e8006517cb25cd024873ccad6a34c7a2102767b3b415da9cde965256440600df6e71e03103df5193ec5fc86294a23a3c3cf71ac4b61c36ed881da7e0409fea1840933a3e29dbdc2bd8b656fcffd496ecef7b6a62431f8d07e2e5596a949a4a2b5e2e5557d0566dd781ad4e76d4a8057657951d39730fda02115909e1d84bbacd73fd8f3e930c961f921c2fbdb63ae68c111c8badb27d8ffa872275d1c2f053d3eade71e929cac26066441349e9b3b430817ba39e0982dee887ae2a0689d94f76bec5027859713d6230627615d3af4906ee6e1f11331260b420c06fa3c89557959e8eb974703dc148b891b4b61a1d2edeadb67b9c92c5a5554c334d719aded886bb9ee2e51ce8d2003f985c25397ab9e5bb944c8e3442faa976b4131c3c5efee82fcf1f4c259b05ea7c766e42cf434c50b51cbe0ffee72f11e546c3881e13135e71903c9c5e1236f44c823b2ba8437674ace1b205218b5e07bd965705fb55b9bbdbfff1b0d132263275a669131eb471d5c01a1add8ebf2534a85bb2c6ef5159d6f1600d51655d290d2d61e7831fcc8ad779e73f236c6a6f0f59d2fae1a95b62d72fc3bab92ceb03648eb6b70e607dd9a6bce1ec38126baf27dc817c1d9f309f4bdcb82a9c24e2f4537a000f656ba72ec7d2c1afc1e090b661479830f9b3cb5e102bfc1ec94f465d23c962c8b5d459d08c77bf049593894a69ee138a3a2c1a22fe45f9ecc7731bd4561a94e8164f616a526d4009c008cfbcb8aa4da4a5ad1ea5e8532f070df93560c7d23886df16eb6e160196d720abb0cd1f8943680652e41bd2371056eb2105044873011078de37f9beaa536c7d2a6f549a2f286a4226e684b87e48587ad926be581e168e03f4d56239b4ab84549197f9a5db381821209fd7c5bea82d4be1d57381d4ac9f58153933e03ef3b28d3da0c33e54e52dffaf3fa432327cfd7cf8ac16551f07dba99c7db54a2460115ab7df866b526bcf5e597aed4990a552a3907b6355901048420ddf1ab3e54adb6e50b7592386beab189c4ff61aeed52c090416080e6ebd68e616197198665b6265be6e4533a052edff0bf42206e8a3b7b1d2493f37eca65523c50ae30045978f9b1ef3f31f4c00fed2127c3bc60e9d030b7bc58eba026ddb6de719428a1131ca3018fdfa4c39fa805d1e37ed245dacee50f9bf8398f7589a0e5a7c35c7273e9732817158b936e632a521e4de2c39eff183c3eef2c2c431c0aa052358fcdc0f2bc6a9140d00e659e79ad02768daa2fbdbc80f3457cf4f826efd46af3450fc099f133189fc50d280b496a5815f6d3750813d671646e83a7e5ad5d75414a806a4574bbc7e15d650a76d7cf6908af67252217fe847c0560a301d111cffed0cfc86918dc3f53c2c9fc1de64784e23946933b3894671b7b3513535649b782115aac16dba27ebefa995aa092c41540a0d7e68dd9e5e36c00464226f51a068a27586b1c8a219e96638ec4fc7c16aa0ad79fdefcc02eeb4f6ac1ce2c8f3f9931eec762f9a53e66c88539ac80360f50795878427c7171364f26ecaa599f9838652caceff7378d0e426c61c0061b4643613f1611b5ba115826961d0215b82174a071e6e59a74758ce0001aa0d6e28f6ed25578a09d395665ca332959b6639068f6a6e7865ffa2ccf635be26ee81f31e0aaaf4057e4019ca31761b99bd34318d8f4e784ff41cd2e10f06a9de98f91ae1a2d90d568fb97b224aa3ca9ea5bbf9486bd56e352957070a2ae8255fb7585dd526ec3701f6bace49ba4779c7a760339ee169e84d831b5364fb6415ccb0f4d4716329074ffd6efe89c93f2332b15665da9ed1837dc1d0111462becfa4d18de7c85941dcb2bbbfde11bc3fab1b6cb75b92ff59d8bcbe0f555db7f0e4623ea408db71e09ed78d2865e7391302727a10ffa96861380e998f3044bde6d8a81f9b2aed71516b95f0928f3281525a55db9acbcb7655d257a97c6f4c9326267a3b9c0543cfca1c3f1a43eeca957a51f0777380d5eb90434210424e04815911b1f65f76a65e6c58fc7e406a17ab7ecfea875d3b162c1292ff193d9fbdb17a6c836153ad8ea5b912276d58c9ea6b06edcbc1b2bdfc0481271dcfd0bfcd5e9b642d9b0fd913ea02ce67f3830c6b7247a97a86a912c59408ef0dd90837587f09cfe34e276d61d5b7bc20706430418db1a7d987d3b57426e8708d05a360b79bbf64b3a589d02dc161e5646ea6f5e002189940c7249641a5a4c5f34a83707ec1bc199aedb0024cf3ff0910c8df3768d9bedce6c4d920ff5d6d5f33d9b8705cc5b5bd485177837e242867dffb13a47026db2ba35df478b5659155e7390e34819c349167ec730ed425aeeee7e772dd8dc22ccccb3335bab4b3caf4f9696e48693b075ef9af809f2d6b48817a3199d5a4b64feb74a06aa84146ca90120f11d0bb15ece997cccea981f9280a4ca121b81b1fc4a46e47db7791ae02736c87cf99f0cff9ee8708eee5e8da6fbbdf5759eab50b6e38bf14e521a6312ebb752eaa427cb378887dc81207858fff3bf9d28f311fb0f9bc8766dbc356bc23e390f0bc67a8c4bc57e3b980417151aa013f47664319c34742adf1ed3108c74ac22c442b85974daa33e22b0662b8e03a60080c359c0ad558855a170b6060583db8189e38556e00197757d7774802effb104bff82edb6adedd578bfeef5fd0360aa6233abee175f857ce5dd415814a0f798828ec07d72af9d8da3c2857c2afd54be5129e2f4baa2266e714ab5af575462686910d460ebd2a90ea15b4076d6f9583c3f3208ee5b2a2d4706d08e61b0e0faedfcef8534acae20e9c68fc9a9229a46840a4b5c5fc33f7ece5795b141cb3ac2b97406346cc3280ebbb5c53b46546f6bee705cec83f773c809063f581977a3a136d5f147148bb66baffd4690940bbafd0e767619965cf89623623f5e02a4434b1a6456724d727c7f92d8774cc14059c5c44f3b416255f776f021a51efe40e449cbc8390f54637f88c28e1512f6e429dd43de6c0900890b794d68f18851628dbec708c024de9700993c64f23fb7715404c5c017514e81f5c94532b8e47d8f5f55e5e363ca2362db5fe01a26184e49dd61c832a4dfc49161d71610a780c1fe962ca6481b2a1d5dfbadd815e33ef98267c155dc72bbc632f0cda7751c27871d6ddd6d6412219d22010d4ae65019177a72640fe77cd9754abb1db6de11b70470f5ce6ef08f56bc953603cdc93842538eb8179163c426eb184e194f47e8584c5847a0783fb98138185a3d1b7a1899480359ea10dc063e5c281417acf4e68af6337f729fd3f50b97f6e067c94b5a5921a26fff0232af0fa27f4266b26bab51d4e256c9b9bf9b8763b53bb5544b8d59867d72ee69808afba157bc9e0206c3d191b54a413b2b2d355c72b81c70bdd2d481e0c706b0ebc524b736b3e4903bd893f6ddeb4960bf60cc47a3105636276b07f8a0f0d758a97c10962b0c1102e470a3a1a43143938727cda2f0a4599f1590d8086c4631e886ab3235b6d7e3ddc512ad033a61c67896f4deb8cae1e9df2b97f695f8214f2f34cb5bbe5d23db0874de5d2eea196ebca838487705f754fb90678584e81799a726f6e3f718baeef9b909b0644e24279fd0d2a0878a3fc5732af2465bb47a902f52e1bce26eca18948401aa"_hex_bytes) == "60f6cbcfe2611db53b18d4b3cd6ef27597de8f679cde5820587bab94"_hex_bytes);
+static_assert(ctsha::sha224("5e91c2946898b6fb9183e36e6c6899c3130139bfc6b173221175bfd3a3a9981d8e83e8c0c7118e1378821ec26fade88ec398316054e38508d910ab53a31b60d5f275f42ab2dd56b337a9236c193e443c68a847eec19f05e94abef3eff4e3ce2913b542a7f9d301b23e1fb37f681ac395ce1545176b73c5a4b1e6bc13143e2a234d1b0d3205d1a27c7865ede7e0cc061b9968937d8ba381b1258666d451dc4a71c705a6c222de3cfe79f521599f86a0b074c439907483cdee8e62695a63789e262186766bbb654d4ec7e9204e6b63f3eb48ae1c146a4c6a43ea16a1e976662cc78c2e0bb552a79df2f08435ec98b86ed42f9474d18f386e698ddbb30401f4a33ebe7826313711d39d1a1ab55daae4a604e9121cce37d832b2c4dc344a99c472c2e7c2f3d3543f1a703e1ff4bc5674f81cd5efbe8e596bfe71edaf6c3f5b591b30df3661ce71cf27dfbee0e4d735e205dd121ece1ce7d8ae1de3ff86dbf9562e41a429cb7a197fae9a6cbde2616a3f388bd8d69b7f408f8978073c17ab4530e9a484207398d19a555f947f584872eff4bd05aeca18bd7aa0f30cfdb92721491be12ebe867b4f82b9cbfb5bffa9d4658dcce12c036db82a105dfafdc775d8fdb9e2790b5958ee5f753f18ce146ca3436648c7264be285f7bf7f145cb48640a423fd4a7c786eb475a83fa5448a49e0b28acd16eb86de"_hex_bytes) == "c19aea488a909f19a6347dfacad45a872943e00bbe5c26c9afdd1f81"_hex_bytes);
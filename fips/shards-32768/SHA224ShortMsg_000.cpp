@@ -0,0 +1,8 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha224(std::array<std::byte, 0>{}) == "d14a028c2a3a2bc9476102bb288234c415a2b01f828ea62ac5b3e42f"_hex_bytes);
+static_assert(ctsha::sha224("51"_hex_bytes) == "7518962a0ac1909fa5f33e1da0c759da3dcea0158db1c72783f0dd5f"_hex_bytes);
+static_assert(ctsha::sha224("1511"_hex_bytes) == "04788e5d4a41051c0a03e7860173e6c74cfb3886873b9773bbcde636"_hex_bytes);
+static_assert(ctsha::sha224("0f857e"_hex_bytes) == "9b89d9c50ec6d0ffba9004cc3b5536923bc56fc78251ade159be627b"_hex_bytes);
+static_assert(ctsha::sha224("0f95f6ff"_hex_bytes) == "81c29f3b1fa080458f710793c7eaafa07f36620d35a470b2dea30c6f"_hex_bytes);
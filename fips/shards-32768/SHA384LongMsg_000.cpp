@@ -0,0 +1,6 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha384("10c2d6921bd9bf890e855c196db90a2bd99677017fe739a4a95f1e9f7d995f8db26d630fbb08a5d56fc48629bcc674db226e775f61060a1120bef3dc6ff8a8595664b0ac2a47fa0d2f69b7659f79054f6c9cd39d5a16ae6c76f1541fedcfc8168a2c34acca99d7feeea0c20c7318f8f9b1927863385fd1094d6ef8d65e9e74e15eca4fd013f2286f40c27d6f5ceb84e484ad7c67df2ec8141b4e7bce6a8b9597e3659a5d27c5d39be841dec8e69aed98753fd15c8120eadaf196dbf83ae3d89a50ad8ddbf889e36052c60dfe81c60197cf39940c5091131f9fa3c06ea806d3a9b7a07ec3a6432814b3faa17c5327b04b4135fa3148fe1a69769b3a4327397e075a30db339f96902df351eeb740bc49c8d0d1e54ab9f34757876dc64c905b3a0b7c595f7cedf45b367f67baa5c7ceaff64591c721d9558874c2e05bea7a76f552c3ae9b2df71c834d82a3cd6f00cc31ecf93596b437cab393f75c4c7be149dd7e2146ddbe1c455ac96ad6c7c95e6bc1d9ab4a70fea3d454053564c6d004681f63fd3ad73266a3b4b69beaf7be4b4ee204bfae60158b3bc741a00dee4b475bba505cb658e2f9b53112dc99c966877c2defff1beb89da2b01dbdfcf1615718c3af3a38e704aef22fb09e2d3d0f1eaf3d81701ca270d18573900eb665d8de404f68eb73fd208d6d3c538b286e134e8926bd58532d0f8225bba95d2f59fc69127ea1cd56dc3826604b8e1d298a4b15799f85708db76af33bbaa78b2350680ebcbff06ac888a3f91a3acac846adbf02d6c59cfa343637543220c3ae8f15b0ae887ff3c02824771ed7c229f501dc14941b7d893dd2d20f11fd9b74ace3f92b0185c6c0fdd8ec4d3d3dbcad2b93bdcb00d4569448c59b204d8cdac8b27256aca88bc60422017248bc2ca663e0500c52c9366ba5449a7a7a2535b99850b7428f7b0ecabbb1d33cad145389314cdb587ca81df020629f39c95a99d72fabea846222a261d5cdad6fdc75a35cd73be24c50b996e8334dba1516e410082e68432831955d5018738736e97fd5dba629bdc2369aa7a89d4508b7898afc42ecb44b0963a74cbaa51503f2d3e518eab83f35bc703ce09ee33379b8176596f4f9dfa623e57f6f0d65edb311e84a6dd86622fceb859a209b94035126420833b220dd2a34aa5bfe6b9d6deb567e6e87c1ec84456f438a940077d9ae6ed306280ef81188978173806f3de5eba3281db7c72aa76a17f365d63bde5880ff60009b35cb03c9c6786d005210a2e9a6c5e43bf72f9ea5c34169fc778042115085c9af788133d32e85c27a21d4c35c57de69d2a627e6bce01b85a4af08cd0a589f9acdb512e634f030c1fdad37bcedaf133c183fcf06aa74ec47efdfe23a3414022fe48808ffdb718f7e2ae6109bc3ca4bd47221612"_hex_bytes) == "ac0c5a0eab5fd89601ac6f8c4d00f28dda22e9e874af079d64dd5970b5af8a4491efe5a9f00a83bdb0045a9bcce0dee7"_hex_bytes);
+static_assert(ctsha::sha384("3a8fac1fe8a54da4dccd7b19b55b7bdedc0564fa8105675ae1badb70ef7e174de84eaf795abd8c373b5a0a4b80e28f45cbd97b5f5da8a16406912cb64e4f2c18491035efcb1a29497de0f0db3a6ecb3120ad9b80ccac11153d7d1a0932e22d16dd51da21e575313f61857788ac074c64ecc6cab1813cf5518c82e31a5040bd57a1d1f904ceb4ac6003e241bbaa2d9c029dfc345a27eb757c9e0d77c3171be0e09e4c9ffa802a4c7a2cb77e4835010b1d52391f35bd20387ffc201d7d08fe957c47aac9367ff53a6b246d33568248676bff78dc2546399c2a32522b3f0fbefcdbcda2b4a8e20f2f719381c75d5232ae84062f883a6ddcf8fefc114aa08c1ec82125b308a56e53b2d07d97dbcb0c84f7343685b948c78e2995fcb274df856be5b9f5789d612bee1ad72a24fa8fb2d7c5ecb013e6d3b48636567b868dcc3c46cd8c612ad62bf8c91b3469e1e0a3a968e48eca21637d2c2dfad4548a31043c87c7ebe764b6130cc2e290d3b776a241756fed29f0a475008bdb7de772549ac860f62305f0f7eedc31b9bd81988fe9368931fc02a1f982fcea633acc2f84af482f6eba948aeb610c64b109da5887e66b235b633f2e861a06ee3343262c796511c09d57feceabf8d2952e59f9b4885ad13ceef370b894d335292eb497fa6f65c995c8815569e817d2b5697ab2a9a9cdc87b5d12e907b41a2208e2e011cec0e44755fd5eca5a27aa655550c1e35d64fde99447d97ef5c543c2e859972e9f8ef1667c4183014f17cbcb93349b21a55d4f231e8469c029d9de9c1d2a74fbad0bb760395f7be8a093841a86975b250c08203f0fceb2ad9d873b3a7ebcdd58930e3e036d4137e46071804c151c7d66c8cff4b77e2c16f330ce68d4a32dfddceb072283dc4c0da763c7584ed7eefd056ab9adf30c2565752e457778b2b537424bf2f67aee50504242187912ba57267a1e4972f2d97422224fc2fa2f37b41a5e49baf575cfdb2746e463287579e1ef9b033d61024499a5a24d0c3b86b69540cdeea44852a5636654d68dae75a90da4b4f2a1b20c01f179e3e0cf74b760ba49b16d8fb5adb7f01ea4d7cfee7177d82d6a98a7d6aa8a0df62cb7fc5d55e38ba7532b93d834bacaab53b00518b49f9c388dd2f32fda738ff5367b04235f53750842ba2c7a45ba2d09a5b4b983f399276ef7139f437fd52c7f9fdddb9ddf3f77db14636ef7fef9cf3891c8f092bba831f1d72a17fdea377b64c3ee713dbc0087166939e35cf0e6e7763cc61cb84e3c083a2a15f99de1d68d6fabbd3632e9ff347c14f577ab2cba1088f8799c3373239ff37adffadb5b0ec32148f0b40ae1f3fe5247ff47e660dfc8236564a47093f39299dcdb93a1f1ebd9c2ea67615e6cb06ae5d206d39f732cebe4905d6db2f0d5898ef1d482431b44c3b1727a8f70c772082cfbeeb0c9daf57cbaab1cffbe5a6fa4eeeb1667dc87aaa7525fbcd2e700c2dfdbe5cc1b46ce84a3b604a57309071d48cf951043f630fa7d44e7686d6191a0b9311a9accd813c6f72a18894e07dba8235f4ab667800940ddbf2d078d67353238c1e02815bbc035508acfc4c992639a061f22889262a2f7970d4b33d54d6777eda6110cdfe1662f0e1dce85314223ffff3212711f51524af5b75162337a310671b4f42d5cad8b556e6e23e175515e284eab6d85e8dd31a01e1a44fb991bd33b4bc7cc84046c43fef68712ba75fa2c86260e45ba23f3f28e7d6e6ba06a0f1577937cfe047cdd7269e224240b30932f842c7484a687af2d89d6da00d5f922f4134f67bc63cf833ca9a4be57c38368a5bd61305d1cd128806cfa8e25a96b51a87f647ce0c6b9151444a0f318bed8d7053541084ac0d29e162c5a795c81d6ee9f2faf9f3c3bb2c2e156fa22ca810f381a22fd57c1bad39f348483e4baa7ceb05b5014c07979682575895fc1311af938e6c35074255fb7dbc9bb8b38dbf9658cd38bd05671026a95f939623913927a4c0da4f99f12af6067e301618dc5082cf74a3118c832f32e10588cf0d81a2953565500e1416f04a9e2079d3c0ee433ed248de3b3959ed2ee49c0ad072a8a6d1f3b4ae6f24209c0cca00ca406dfa854d02d6cc49e396136cb5f8a8d8030f374645213e9711feb80d8a60da11551c715ae9aa525ced6365777271ba0419a3b534e12709393fccd7b75c164b8b5e5c86c11e1701bed02779e57d2a842af79e39f9d94878118e4897eee08e3ec39a3dc6f39d9279f4183f07b1e15a91fa01ee624df4604b6a735fa9c7031b9c97b48d2824e5223d79629201f47314b528381cab1146d628efc5646dc2bf28e14b3b8a9801bd6c941cd044b909124d8ff9f7c59e287775f515c995e93d6d3888156bbd6ba6083174a7126d26f23ff73c9a891b4095c6f330389f5d0fb9efec55db33582117371efd3d7c085f89d8b29037349778177b4062e1c176c712d99f185d40bf46fd5c406e08fa03f314d078b8b252e2f511bba6d0bc33780a3b2c855f10364b14d9ef1c2d0e92fc1a296cb33d33d329a4ffcf08216e59f36b52715eb7ee8896bd435e984eb65809a5dc544ff6b2e11e5d00de3609058bdc0eaf9b81c877a17a363e172d43adcd42025281cf9bc54bd9f798e703e5ecd9233e4922fd1479a5873c4382542d4a2ffd50b017f65a122a1b138e28463fad97bf30c0049bd053431540a9569fb78843ea11ad337f1757d7c803eb5b4e93ab6a8b28ad5b568c7da2323f4d25f12a19b3c7d0fa454d57ca9984f2b46d4ec3ee06c541e35151af65d423ecfc41ccb119b2dc102a5194327ed7ca1b042001d52a090175b0cf5fdda0fd4306667a7da66502a4d4118ce2cf2620de9088ea3a90b71e870e5256d4a9f1bbc65d45c33ae1129b29a174682e1861e88ced7a30277fa591197827b633715d6e153b9fdb4a92b5b5ad288fd5add9379c38265c3bb5a9728f0cfad626e0d2d468d92553a816705c2ff0113b11f49d2f16bf875899c530c22cd635721f8c687dfbb4f3d897a57baff3577fe804bfad35cf5247cbd17bc5e60222b78c214fd0f50682a430bed093e232f8a42ef4af68ba6b23f4f18e1a32915dbe7cea9da01893775179ae622e4e96693a3f51eace1da1d68f3f94002300e8753a939292836091a159051dd783c5ddf03dfc2802e014bbeeff89776ce29c10d3ad2bb30193e4913979b330230c999d8bb8c8a071729e7f744dfc895ff403ebc39568a4b588924db210c83546e1fbf246e7189a60b6514201f926e58be7cca65e2071919d13ffa57ebfca9ec723ddf2e70a8ccca64263d9ee082c1286124b510c0b60fb0fa21d67b06d3867cba76e1230da4c7f7f77cd6666cb1e555a058a2c395b044382a152438e8c8b2c7612737e2ed0d2f12996cc8baf8aed8c016ae884194f7941a2c30c5b2a266665b1657233d029875d347ddf33ab8aee89964c451224d8901abc1b0e2a081c871a62fe4eb717c9625bbf45aaa62dada09cc68e7c051151c05a52fb5c064bcef9a2b8b28e95ada270ee631bdfdf01062256b71862e54a651130bc231b5da3269e269f49cafb9b18302a18f4ffa97722b9fbdaf66ccc57d5b1fc881e714ccc70d62fcbdff7d29f54bcd8857030f1292cb9143d98dc4d9b99cf99e76d79a95cd01bc6da1a5d9c11b9159ca190ad3149e9ad1e316b246730c1009640c8a3b9afa016bdfed6e36d9e27aef84958a950c5d8418a19357613c49ede6f6a7822dd39f9a22cb75f27fa969e892612fefa8b488ea530a42d9d4d027cb5047af65f72e9f947abe724753aef720a596afa5651bc73738b463a92b8c35886fcce5edc8538cdaf5c8a032f2e84c1a865d9c1bc397306c0c5b2ddc7962766dc050569699ca0743419ad03fd4e8384232ec73e999f22754bb8130c54dd3048f71ce44df2ade5396d5c21238b19fa52a761351f56381c0ea932fe9b6848c7b37387c8a5efe192d1f1b8345c6409ea1ad4b2ff5aad585f1a5edb1bb54689247ba221cd0c7d9febd957b213b5215289834e6e3bfd0b3d956a6d15906772b9306bc4f7cdce2dc4ed7d6ccf59332b4702b7a787e75f4042ad0cf3723c69713af943b67dbd2ab367511c62076cd8d8308dfc39552b9fcc161075dd747a68fdda17c73aee8ea74e6d873e15b2f0b9c8ce58f87f34ac200abd975234f8395267656d74ef181ce55c82d15ab4e7e11501121a97821f1cb4111f9741ecdfc8e3880b0c4ae1a314f548fee272d17eb6427fa879e"_hex_bytes) == "d60719261f32b03cc942dc4625a158678f4f87ad9ca614a2eacad2d73333469316ab4f7c75439189aa4fc6c21ae656ff"_hex_bytes);
+static_assert(ctsha::sha384("cf51875b46841185d640b087199e07eae688a72fd828d1556ba1446ae0fa23ed0a774ba6409fbc61c4b99488e45406ffd05fd5a5e928aea7f1d8ec668bbf8a89497d90982b1a892d8392f6b48ffea823438130bf7faec93531fbeefb812e4bd665d541e8d9713694dede1b1be818bdfff2ce963181a6a2af05f2e644ba52154451e7cba75e8a0694b763a5b46f769b305887db58b8a5666d32ff719d8f6208d287d89b746b24eab0a1bb4e9904b85746711c643cbe2f47003b0bd60bab49eb7f950a8ab65966b8bed2982ed676d822ad77194a7d25eef6dd7390557fc8212e6dca8335a9e5365a0e216f8ba6bdc9190ca73e1850bf8287f9985f1ae833f3936d4130a4ac44f0a57c70cb56f280ce5a65c30f65a2aa28abc9276caa826d996005ff99da51711133f3749c4b4824f43da416cf5ba4922f636869f2661e5ee73e38aea88b66ce1e32130c6c203a1bbb266505eb0671226b32b73e1e449512da6753512639a177d879ec0c65029f5ddb798951e40662c69a6521901074aa3ef7a523f3b4a81201c187eb8032798bcac75ed94d4b0e7a108b6afb35fffed9673652860e16462007d0ab6e19831b1a7d68b9aa3d194a9c53e4032d50040019dbecae9cf7a800aaa0b68992ca7cac38b19afafbb156b6aade81c432a5026b9a22dd4c2f733dfe7d1d88f31117dbe0ccf7cf36dbf89270c5"_hex_bytes) == "fcb9ba7547a5c1b0b886c95ee91f2f1fca4b212267834ca050a95161c58fd320d0eb3a350c88cdf32d502efefa3899d9"_hex_bytes);
@@ -0,0 +1,6 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha512_t<224>("0b9f2ba3a78e5e1a360b8cbd74a038f071be40fdae40fc9edcf1c315efcdf539f8dc168aebe801f1d4c9dc145a994f380347959fdff71119544a2eef7559583d7eb3f5bca8c8af0ec7dfdede77db795f37aa05ca09a4cf80db07b00008e897c15b6e1695295f4d58aca8a4c85e06531aacc43871558612ec3b7d7e5c0e0c9abd97147a2110859bdedb166c75d26e99435f4c280b4ddef9e84831a405ca37437068c9811dc1bf75feccd6dda96ce6c2804016fa00c8b727516e0101c2e857224ea9ce15e828633fe0ba8e242f681cee7937449199570a45e5dbc2311fc3de2e2a18df7e930d7fb6f27dc894155e213fdf25ad23638061b79fde9e62ce45f7bff1f5e8d2a9a697363e955d08ad9893ec06890db59f2f3c3c0b93484c1509872272c62beca1831914326159de3c39f727fb5d300dd9a05a515a8096201b414dc0b533ea3363b2f5ec1dc3f1dfbf965bea4dd7f8ab842d9526f6285bcd25fca7b619daedc5b4cac75eb59ec5f25cfae8619f97ebf741e06fcda89a5810e8a49cb26fed8f0bb36df5e34f4932a735b2ae3880a545b952b54d6eac1f98b80eb6b3ba7d62f38e410379666564c82303712ada1cf76d22c89eb1256e114cb9d834e83c475207d6c3f44de933af7538118630d9f84c1992f36de00d801b400493d256471c642c565c4ea8f9b5ecec72a0fec6854ae38cbe80b3dd49169ae515e526435c41ca7fc67896765a4dd011cf0262f78a3ab7508e535492fb979b6abdfb8780525fee5c6453486a1046f8e429cf1503e8ec36e9d9e4a4a110302b85bf1197877ebb76cc6c543218e25b08460df00517e07f7b84a1d6760ba4eb96df7d9663c551600539209adb5cdadf6f57dbd99bb72568c6e56b21a96eb410edaf2b19f199a71738b3dab97a99d06a7693cd44a496ae538d94dc5e232f360d1aeea98e447f29f84281133f2eab80f2dc3515a940e9a1bfed00a7bf86fd61875298f111983a6be8f51523608ed389711efa663c25e5d09f2d2fe4b506b476a2afce357291b13c0b53f646b1e852abf5f0efd5e09b5ad55edea0b249ad460830d8a509f9ef8b60680f60a6f1791d8987c00b42b6fad343d3026a92b3e68c0f5bad4d55ad7e88a290c39b830deab4768e56dea4aecb5cc18c8f81b19245f7acbc3e25806ce860c7e5c3eac9057f00ddf5d8ed93f1a2aeec60ed10000d7e1054713d654895b4beb579f5b76e5a6d947a4513bc9a3e4229d073812b08066b21e3219ddc6575905123bd2731e793fcb0baef4895f4d65f36f5dd3d8869b79e8ff65b9c00e18fc75deffc4a894e2cdef7439b97bbc6260e83af16cc8cdc51c904a0d82baaeeaafb7ae6675dd23e3f82f1226afacef54186b0ced30286d9825f74c05d8d24c5b7955966cd19ddd22a9e52db38"_hex_bytes) == "6719ff2b94a156bb382c5da20adaaeaf6202fb6a4dace5faf0dd3aaa"_hex_bytes);
+static_assert(ctsha::sha512_t<224>("07bf241e6c0f8123ac0b40610e6478d0eae6a9c93b9ff40b37bf80dad8a3dffa38fdc6e5c5ff3968a7d3e572ee94dc59332f0a1e82e740e1c8a07c292fa01bee9e1031346cd0de61d0a2271419eee1368219a73702916a704d64c34c6bde9f93bae8064326c3c375c19741051edc29a0acd0bac86b6fd5512353b9091d0f07b013c3d0cfd0e9521a410fafd86247f565da786754c50b184749ed1aa45753d7eff70b8569f4dc7aa3709c318b5e0cd5084ad643ca57e480a927d8bb6274e00fe1b3cda26952473e071b2cb6ca7edd8b99468f3c979d6b79978981c32d588693a584c278531cafece945e35e36ae1a62142b446b321a3a9e86bbeafeae83bb3d20a4f70303632a5f9dbf5df6b7757b89422fe60eb06aff7511212b929d5b9219cb86dc886fc54d3220678b6c048984c5e7208705583e0b47288d65089eb0bf0e9db47ace820da82f01ffd648dfb8842980abd0a4e324871f437c09771802e66087d81d893773642d766fecc3566af98857f936b501c4b46e4575811e9aafde2b8cfc59450b8ced18c4ef6dd78b48101e7a3af95bdcd10900169f09ed7901ff08081d49d818cd6e519e5cae49fd607852ebb3ea0089790785a352bced75757a66ba629677d705203e276d22ddee6faa7fa4bac7ff1c2553d044d8283c0156508a4df6250a1941d900339b7cbfed3478ecb5aeeef82186a85201f8c50f173631cd7cc0de6ff092477ebadec47740d81461800fc75fa8eef30639956fd22668429036d3e029273170850f8b43f68921f5af7eee008f161a01287b43e065776b37f15d73c592a9642da98dd80e883785d2dece8b6abcf9a09f68a71c0fd94969c9fab3ca0f22a0aebfca0951fa68bc546ce0da0ccd0c49bd603b8cd57e84123609aad7552ac044552451e379aab3a2c36c571da9f4d07371901f32d73725ee75a214eff42c3393fd1adc3f52c6b203fd8a9b9fc73c7b34ec6b810072b53076f16bbd0160895425306f78c9eef854aad094588e8b8054485ff15525330384b6560a334e68a7ebb1d4204c8127bc922d7d0638a205d360174cd4c26ecf403d44061a30380cb4702201fe358864ab182956a5307284bbb2d65e170989804cbf2ad36ba2fe9edb928025d86417717d0afc0865c649ee289b01b90cdeb3e18508cfb5c7897289c84e4f20d9e47f4b0d009b5e140f72873bbebb5608dd0c49015280a6d49c5da465f96bde9f9976b31e1bbb895317717d0c7ad60633c436a47d134e6fef7c4c92f94b1c85e19314da8b609faeb27d9b45426f14239724bf33267d4f44622b87b6d3d4aa641e09e60b0cb317e8f353abc2b37253c7a393d918378c3af61a3c9c7e5a70d33189165339a34e07c064d2701d2c391c1f04e835bd6bac532695184a2ad35988d1097f834edafafa13ea56d187b07e433d9b0784df6c2c15e3d529c58516a8f976cd2b6168d1117ac8f65080299f6d2b5f97aff1d422a44600ec9099b2bc1e3e07bf9ab8ac56923a43a4465002e81dc70cbd39e44cef9adb023e49a6f791a0c9f16773654d52ee0ad79c8f70a6eddd867cfd72d6c482a7c62f09902ba96822f835df58a9d3fdb7acb9c75fb05e5c1d0d0464ad7b8389dab6d9ef3e48769d5917743d58b277633fc6a8ec89e93e8c4baf2e18b6e51403edd5a0c7b563cf1899a8ee199ea18969bd983297fc632d4693ece4b95955be4b1925988c8af3a39ae0dc25f1ab86f68f24a4e4ac597fe0bd2ee6fb0d29c64acdcedbcbb80956e54fb14bd9430f1bc364ead8c3941c61928ad76c5d01f4174cccb71463dd98765a03773c080862b29190ca62122c7d0d0439ad8da212607b0f64f307a367021b7b8fd13cb9444cbef727bd02eb98fa3b38980b5eb40c905e3969e28e6d94cbc9e80c85c7aa92be36cef0b808214dc9a37449c1036004af03c76e6229129ec050eabbce5bd97fe9d626245043c0c9254d74480d2cfab1ac1f9f26296a6a59f7efee0b5c7d841d40105880ff7a4d00b6f9ad8821580ce6cadc8f3b44618a0bdb91583014764de28cc15f23b84ebab8ee23e34a39b62b27371332cf7feb3212d76b113baf8d4f7fead69803b6a779a9f72424dac80305abc3122a50711dc870e5e5e925a13f740228a34e193b8d63ea71aea5888940cb86ac7d8af44af055cc216c04b8b3b07215a2866743f621a1adf32d8f75e516918796daa1b37f70b6444cc03952669a330af0f48354f2d597ee3a8d92b6618e58b751262c614e85432371582981bc42e24941c43b223b796282a11c7c20eacb5da019c64bcd9ad316438f1f75633c7463a229d1b38007bc409e7220bbdf7c417b4c482a8da06f8aa2cc686b421b53f81edbbf4255cb3a4bed990f129ab38156bffc1d3471feb977a2dc369e91f654477815188deb4f9abca48f2838c4ff84ec705e608dffd79a66dddeb27f1dc2abf29e738b141bc0932c5927a9a62db54c88a5874c0011dd0f4f888f2ca84cb4b1ce83368730fb27f0c6aba9b8eb9717e7105e5b482837e33ea4a475b2b279d1c1b4f834ca4d8825d411fe2cef0f40374307911bb41365251a080705621ec15f5346281182749d0be825703557fb0c3af5af9986dfc8ad3145b1efdd3316f9913e4dd32ee61a39b218586ef9f0895ab82cd17a4d59843b6266d61f0130f9c2eb44c6fc1546cba39db56287cadd20bc62501a0d7ef63b8f64a36df111d6605f9567393284e0d24eda2d49021b598ac9a3d1dc548de0684076885c23890629e08a8add0be871a7f225d28be8d72cc1f0edc1030ce60181554c08bfc310312f4ff70971b3334e0ea955dbc1ff0af56fb59421adbfc2028a306e09c7c2512907517988b47152f7f1a80aa03720eb5c3791d5b3b34f993f2bca982ffbdf99650e5c0f93dfe6db7dae93457881222c3507ad182b13be49ea25bf9f31c9fa81706db91f18e7690ecfe978e79fa329501c49c9fb0bcad7f883e90ed1a13ec6a7f0b82199219beb8cd56ba599ae63c983e30422228a9333734d3ea7aaebeaddab05bf12fab21fa38d9348d38bc29bbe918153cf68fe16f958f3cb62af755d860d1e4146c03f4c11c44db10ded1edc8a9810073b8c34704cc09a633343066f7ecf674f19c6afc990d318708e112efd9d42e50ec9fb619760e11597520408e3265c44ad36e35ff4d1893f815faaea0d5e3353f3977bacfc2d7218e738868ac282c23e7419507a893afb69a9770aaea20bca1f1b3378cb4346ace62a12f23acbd6da8abb3ccca041bf8a67396e3f2d0f6ba9c6c74677e76a23cc0f6dad7ccb3debf7050277f36cc24be5b9bb8be25def263e326ebc5bd1e3977e930162026dda7ba58c9f2bb9f05e58d5bd2d9c0b508425f6ab5c523cfcf4d92dd46d9eb696e08a8ccde16c43a146c91c076977ba507dd4e23281f9c39e3f69e5600f76008cdabc9d3ecd039b8bec052436452b8a92de9128688b5a71f16a4faa35b432b941fc906879cd01cdb7416621f29e2a844bce781a79499959265f535f6052d912eb880b8281d5e0448c1d1905c9fec7d7ad86a562ed57690ac0e101faf3a0de3e47e1410083aa9d36e17936a5f8feecdab7998c932f9313f50c207809466c3abfd5901a7ca7bb02582e8e05dbedc67873d1d2ae0b5422f4f44e9fbc12cc7cc7d3f58a1176d7a28b9c4a4a0330617a740ef7571a19a42b12973d9fb8060d620f93a20fcb30b0256d3455dc81f4d65a7fd297777b65ce6fa5eef3cbc7a87b4b34649e04f38e41f79e7e3d1369a1460aef734983f312ab983bc087fff59add8abb017bcb4e49e8717f8a209f38efeec98e8e182799ed49fb86aa06009fe551784ef7d917f35358972edf0945bbf569a10378698e752f52506d8ce270a093c41aaec18de183852831168ae2da5f00274c345a3c85afffb7e3e09546c619438b4e1c4ee744bc72d38680be796588caa5bdb1091708052f79a967edb5362c05a7944f35546185fc777ce755066f787974eeda95ba9243d6c9fe591d4c5113f953410fa2d0befb712e60d8ca41cc1e43f7a6728059a865f4374dba6a786af27bcccf4b2beb50ddf369ab7b5a9158e6a29f5554c0cb6f0227fb45918e85bdbb4691b30d5a268e863238c5dd3ec6f9b1dd304c7ecba629aac14e22f9f0f934a7a6a862469652eb26eddab8a1f393bd392fd9acae0fe290593f70d5cfd6235371502786ee2c3232a31adeb5ea500b6ad5bccf9d7266f32ae9fa2b9ce6b9e920fde9c5e2"_hex_bytes) == "237faf86f020267d810a63385e23f54b5934a1cd7de12824c5308a05"_hex_bytes);
+static_assert(ctsha::sha512_t<224>("be03879d373e3cff418f52ec5209fb6373979cf6c8badfecd03932d83f4bf510ce582e54fca747eb6c9a5acc80a6a0993d3f12f5bc310de811f33c9897e18590039f047bd1bcd0afc3d663f42e583cdea46cc0bb5230b4f88c0d7289d8a627c253e4bc19b6a648c172276bfedf4e06d0ac25c4f812d09dfc0bdd3bbd62e6b6f7306263aa3f69fa04d8bcc9e28a2ad61f23c4da163dcb638accc2008d008d97421e902a7a763231876429d7ef5a86c477f870dba7fba5c115696f7f168235f9d6d8265028714379d93f27d2707c17dfc22564e9ba3689e0c9a99744fcfbc5fa7f93ef91aeb60087a84448ad20fe29dfb28e66465537a387cd222c79ac4e40965c91562d0ff4dc117a27a84fa2d962549c4baf08e6eb529d0be289c2d8b128c5580f8744d1f9e3a41b6cdda4aa6f229a6d97e3893a4173b312dffba397526cfcb7617d27c1f5d05e4a916f8c7ab38db95cc9b758c1faff88d40b988c2bd61b8bfe4143bdfc8fab921b30d20e7a410f0ecfc547319f18650ae3e8448d18c40562d3e3508ff65482800d440ff32f460ff9f3246278388e74f1b0f5e123cd40d3cef8304d95d85956a1532573a397c5d0767645a7c43225c2d5307754eee639eee0ec6d0f18bf22ecbdc8110dd75c6e1ae58cb76129959941512a482b5a9e69536aaf5e02120c8f4ecdd68d37ba6ae12497497d689eb8"_hex_bytes) == "bd0ffd9dcb875c0200e6c4aef8844b5741fab8ef7187e12c8810f201"_hex_bytes);
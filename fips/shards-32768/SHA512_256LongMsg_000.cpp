@@ -0,0 +1,6 @@
+#include "../../ctsha.hpp"
+#include "../../ctsha_tests.hpp"
+using namespace ctsha::literals;
+static_assert(ctsha::sha512_t<256>("3006905c7559596dc6a54338f87df32c59f074536d7fac5f886db68f99570c0b800d30df8daae87df9e127cbdd0106beb410927331dc8c482b29b734fcbffcc993444dc96a49da4883168596898185b9762a1e83d1de93588968a9c7dc8a5860cd5e103dd247224e1847ba216dfc162579aeb9743dfbf78af94f8df3f488272dd41a66bd5667e07254e269d28f7bd181495e09dbd647a9627dead2127752d52215d88cb4153906d8d535372aa152b28fc5f5365665b80ec67b78d66a2c1b6b9148a8230d027fb62260a42fa91efbf29e08b843ba325ad6e8f0d1526cf42dba5202e7d9d1456307b34cc1d354563665aa81096880a993f49446cd809f5e47708ed50833a1116693b08e630de74d0406cfccc8b48fb0369ae71da77248ad85e2bb5dc5a89891cb4fa2a1d466a6db9b569453f2387b505b8cb75190fe1e6ac33d9b37b58c0edffb0ef87d4bb7778c97b0e9c2efe1ed0fba1aa61381f86c324d49670f5840e1b2a87f15e9d6d8eeb7b13a2b4819e900d9c6ed4af7a39d837106456262858ff0aa78bddeb31798f0469d674013781017c8e6d67c93c3353b03896506682c3c3f3f1ded37ca0d14299e5e38fd5a9f8e80efc6c2fef77f0c53d3ad8b92d33699791660e7d3aecb6f412d6ea2c3e82a4b0aa54716d24981ea5d66e47409affff4e4024788d47f1fd99a357ebec65024718b6c18ef119a3e282a3d1a18a6da16653edabeef4d1da3ef9af9e045d0e60bc1104756fcb1e758ae9b78dbbd9dfa6a3a7907704254a8894c457119137950890af1eb1ff6afc5c36a9cbf4ef8cf42dffb4759967491e26c386602b46f5cdffe1af37dfad0a8048bac0ad384e4ebee515d1fd67f2d4c62e897bb57e8e9d85684504e6c730bc52fee91c9c2d861a6e75e6507caa77f541eec24552b9356a1f5a552a5fca01a6b46ff5867b7990b3ec7d8b7698e02b41d8a5e6c8db20fa4b6450c413bf37cd12406517898d471e3ba73abfe06ede26c4be442c7ab81738be0c71f8618b8c1c3ae3e9488fd73e8f2b4c87f280e086c5bed4afdd89350c1830431dddff3cccb3f85e703a981c56c87cbcce10786109b3217f3285f66a4b897798654ca913dff509b296a8888a84cd9d41aef3c12e4107f8f4330123af65a7d9d75b5aaac4104caf049c4623dfee27800d7b24b781088540143c91c3899c7ea749cabbedbfc7074d77424dd123f62701cd991a876666a72d5457f6c14db135139ac09147ff6340bcea36baa89e4ec8063db4fdefd5a44f014bd97eccc6aea6b11e2901c40b16254515364fbfcf8df9d2fb1f94d8ac367f55c22e25ba5057c8307368283b612a5bedcd254d153ce63d9c259855abfa7db97cba77e8ded29ff0c7c521887c8c040373a638436c719f089ea593187c2fb608f06"_hex_bytes) == "12b559ccfa674873598d8655457d55e6f931b398e16bbf1ea81e92caa2393558"_hex_bytes);
+static_assert(ctsha::sha512_t<256>("bb85c8b1f204b2375fa137a02ac040ceb727554b2151a4effc312fedf6d9f9a0d2d0658840d5de0f185d5bcf78002c374b37da8266d053e54542d33991a5b0861131f7ca920b4b506826e06222bbdc92a748ba084144fc47ec92eb7ec9a3a1172145875652a28f364554afce2cb5c284ee07e250f4807969a342e2c86de8a53ee89d51c08cc8e5e83592065bfacd4203711fdd9032d7f2aab318ce460ba14bd001364cacbd44879135bfbc7dfb9666c43614b55482ed4d1cedd01759078a1a8d4e19fbf9a64aaeece4f372f3503b4ed997ee52c39488750a365389e001783ff069bfad03b50039fc7825568f083b1562e23a3c6fec0c8384dcba604e358e53ff1c8a144ce82772b97719a5a67e5be48420573bbc2d77cbdd021ccdd801a5cc36e56cb8a81db43c9e1378ebe34bf66e2332351cf9ec070c542088025017c812405512e5136a4ce518461ac2df3b131874f5ff7c013336636e2b8cb2d2e357f75bac0ceb482e7b807adc0e0fea91b9abf29e88969cc5bcb2f340d35c471c70d6240fac1a36f69a5806027b8e90dc183701c059ee82ca26ce405a8bbaf699697930da57366fe9ffd72f05269e31ebce2db28e062a9b7fa07ff4c5fa467cf5e234d97d23b31585ec5a96a868fe43cd9cf2974bbfb3f34ce2753e0e5feec33d210a192898f16b110332b638b23f35e2ff4d679eaddfd750e988dc209c2e1f6e29aa85113d686cd775cb75e3a4e2079089fa0acc55627817d938de70259f4fea01428395b6c607f328232a40b0197e230bd098c318b1f166daeb2bd9526d273cec7942906ac145b4b2b57537c6590979c28d78d36e16b749fab6c7b52ee30e7f633865c1aa192d1cf24a7ca5be92ebfe6ee0147e07e69cd65f9a5d599079fe44b58712f9e2dcb621c4edc8601d9e75066a5370e853682e390926448cc302957090f12c25c8660db46e345f43957c49cd145af81a99eecde3256a57a39206ee53b343cce40e29d9c2d06e803a5823926a89622cfa18bc45503b42e80e5008c42ca8e1be29d9c8fb2d20196723cdfa3201a8faae0fb9d7324025fc18bb918e3f0620ebd83f3dbeb2a6f38d7c7189e8c68961b6dead80b2b79454ee1b9b984469c6ac18905c4e60d886bf2ab9493935760221f31e24a8bf329a1afe6ef80ec700eea1bd35d1d615e40dd087d8b29053b769052aa9d0faad0ccfdda5ef9cac2748313e7bd17c45917dc21f7e1991b8583a2e2cfa5f602face2fde488c698687529fa05c9317ddd87dba1b7ffbc030f496f1e6d16f55cc82c7394131bf4bcd11f7590c020ce0d3d65634925786cdf27887af4c7fa0420a4beb01cdc57bb62ac00155242fd155c6a960150eade3d42c4e34efd299d7183c4210a7fae150c52dd4f507af96353064b05fe2ded1ae8f9646545892ee0d40df6db2f56da00f4a24254ab0ce5b8e17ae30aed757d84404e98970f76dd450990ed247c2136c82f26b618542d9dacc5ff019783f33e35042806718889fcf33988fc6e5f49ad126bf32d4cd2ce0d39f3177d3626e33f1f6c3e507856dc1e71fad957fbea6f1ed1ce8619d0ee6bc83eddf1d31d50b3e989f0118a5d504989ac8c92a15f5417c8d4a39a9c3dd2224a127b7e11d6328d3d09712d3850e03aa3ad25a38f478377b31ff475469a090b4af67dfed3266cdf7e177888fca4ebff3cfb68b2d4d7db22eb8709764ff87bcce5d6df3bbd9afa22570e38045b44182f5494a54b6a8f1f1b1b657dbcb695f87d7988849b84634a450e519dfcf008c34aca4b690230c7e11d0ec4ffb2ebefabf485a787f61c4a2f9b0308a742e871159cf806155c2637a7cf3b6e4e429988663c6ae304441c3e7a6393318ccb6bc7db3688aecf5c7ffdce2b69ec57cdd5c77e9968df10beaa86c9e105eb5e0a37da77e88e3647e9f85fa1faa24444249208bbb349325efe3b8c9b6ec44317908dafa56d8b998afc47525c2964734ce8568103d16031ff30c8592529d1740de5bafce3bc22c313d315e09ab6fb91073161b7d58ccb68618b1887dce8710f32520b3e0fdefe5d543eb25af43264bead26d706d60c64bcf57a4382e7e5d922c5ac0152cc1ccd0a799afe80127f3ece81386d0c6470ba1a720882547733549dfe5a9320e74ab82bd42e39a4dbadab722cbc78b5de3668487bd3678546e2925a6445867e312b2f36b0ec0fb9b7075ac00031596149a4b22ea829ea70c21784a1237079c60db6d03e60ddd05c70e9c76ba5b8dc6d914f5bc9e892917a763385238bcad9ac58f9d90572dba323d09cd9dd0d19be17a42b6541e5ad26139167aa1742526bb9bdfafd5550e28a5539342e3cef8d2998342e80229fea4d8920e6f684e3348ab39d84d2002d2f11611812a545413e6b53ee2ec3fd93447b61a96fd1646153aed27a62e9e70603b276da21fd0bfd068dff384232cadaadcd4d4fb2483ae72f0eb7ff6bf2cf0e38efd2afaae22350089b3e5adcbaed19b59dc14f4414fc72c1bae8f7420ea5d5f30db9260257936fc589776d82e05147b00b30f94e3396c0c883d1a602d5e27f01a27ba47af149f71471715fe7720f7f17cc4bb68c8d58c4ed8eb4f66ded063ccee869eb341963faac656907e5b99c18e61bdc2772e0a557a735d4374c24be9b89f9a269a0d8734450e51a1427f59c80a32629dc168d27f616abf8efbdaa15c8ea3d6989c55bf4b29a6ca58246e2d13533190d46aa1584e90ee4b91d5f084af0fbc2eae9bd1237b245038ea0c237e2ea6b202617849cc2b80298489a8e3d32956477b5ae0096144218c52187ae13adce59cb2ec7c71960d5af410b576e408833443fae222973041cd74b692e2aaadbefcde8221f12e2a50a1c3a2d5885abf97ccf03dbc9c58ccc82eec1d1e7a5bcd70cd0b8b7b1e70ab0609df827b7c1b6bd956c4737df6053e34ac556d1efaf49c42693da03dc1bdc34598a64b1b668fc66052555ef4f0b6f40a81f19fa2c6b5aca09246b3a26d1924509321ea0b0b66749109e052bba10461dfa8656c0573c742df75be56ab31f43922223321dc123ec40888a1f0101f06f10264a405c14889f16f6eeda5b5724cf42c601fb16309faa2ba1052c81ae05733a3bdb4df694a41fe7e011ce1ba079b2b7bd9ebbbaa6eb1e254482cba119c7ad6814a5078b5a1b1cfbc520686003a1f02f0abaf3ddf3af4e118736e71f3d09d6310f60773fefaa417454f0377a15b87a17df7d41dc52bb5773b161caf2e7f75e75f35da3d17897a4a5d9ec28533952c4653677f61c3aa45e0e074c32602eb9f9b762ff69f5ac6f2f9cc9a57064934fed39336068848c764274b79db26069d211346de859d8d3b2fbf274946c1ca483eeb3054fde38cbaab46aae0757d3d6e795c1dd8e50631ffdbbb59aa0527e58d1cf9e72f08e00581093a01407e7239c04cb53154f882af65e207fca7337586a41bf20599a04dd278eff115760ff83ce7f5149e0c87b1356e663f5eba562f5288492bdad15c9acd81345cf91e442c7ce2a0c9e0004a79eaf7ed3a725731e9eaac427b731ce172af79f1914e7fa842d15fcc2f6c3bbfec230147b9e1744b59a8bb04eb3f3f1bb1af935a3be60339b8505842519284dda5d9934cc8991309468b4432084b377bf88314d8426414303e8dcc80e0f49b2fb22cc9a566670ff473277ec917de982540dc4ea70ff1926802d841ac9b0d8589363221f82838b2066287118d6de4f78c8f254108642d91109344de7d812291a2be2c8dcb98643bca2bdfe4e144e7c0579c6d9ccb663212782cca46196c7d38fc46ba36693c57233003bef9bdcddaeb04f05e0e38f3fb2e91f63d075451d8e242082e914b7ea8429d800884ea07445ea0599c77fc273db272c62b8f132577171d07de17623e88cfab6a8b4ec0307c75737fa6a05adc5f073402ec654edfa6c5bacb098f42f710bba8813396ac5ab5c991d7e69914fd2a2a2276c1fe6de35b838e344a6d75101654869eeb6cc97850e6ec8b3feb8d553d88fb675800012f9216b8e83a4429e4c19028677547b7dde7597dc6bc0615d45c032bfee593a8546e008edf3f1e572afdec2c4c2a7e5c6b3a3c059aa5740d0c5c344dcb03181de4d140c3f96e8b4db627bd3904acd77a9878c335c6c984e6329d48e971a5b875f3b6e13febe3ee360b669000fbacff6ccbf6a31ae406a3f54eb3cee1f57a8d2ae444f76eaacfa82849faee13fb0b550f2505b862757958e77c98c59d50b3a802b8ebd"_hex_bytes) == "077c6dae431ab66392b0ce6696087f2130b33d61fc19ba7f76de28e5a17cde65"_hex_bytes);
+static_assert(ctsha::sha512_t<256>("9e33027b822b60cd96bb2e88be4cb8a1d3e5a07bd2d49b6ebeb235c08593017abe63d6cceec7c7d9aedc0afd7fe5453180e80b0d735c9205d3580103452c14b8fa77e8914a13e88029d25738b2fe5d188c06e041e7b7423ce69204eb249e946e1f678d3c29bdb86eb1cadd76046d63818940b3362275a6ed8bf71eba5bcc2bf9bc4d5cd919c24fa86017d0cfa518a851ad30f7347b6a55722c0e3b372ac8eb1014e7e99b1f721dbc356c241f229bdca460683cd56582cc15218043ef685c1b6bf6d88c7fa7cab0c3bd4b6066a27e4a999a30c8ffeab562a53611dff0001af27117eb87fa35ba253d4cdf441cc1651ceca84b5217b86f3d015c3910065fdd424edd829add7c0f2386f20a7b74b38249ddb2dba9718130a4bc7aa5ad3b1df1d7489cbdb70cb62332f8e3381b5da5aadb0d5ec401811699863e4927dbca9a7d8446a4f6cdcf32ef66bb2ecece0e084cb8235617b0162248fa5c911e7fc808fd8754bd8915e843f4a889f31a68558e1098e4f644037c57e8f40920aece07fa4d23dbafeff58649887a98f8d4f844ac1de057a0e284b4ef7ab6e8cd58c99ef0b46231580dac3ceae889beae14f90f4cb5d0f7243b7a2912f21b819faee6d8dc40e61962bbca5dc44359a2f20607d3e35f190ce83bfdf275b9797fd55c86cf486d821ae77084607121a030dbc07f6946a64c99dc6cba4c"_hex_bytes) == "00d5fd9ba800e7e969c86c990fbade48514b77c82c1655853cc9dcaa85d2d733"_hex_bytes);